@@ -0,0 +1,41 @@
+// Test driver for the symbol lookup of batch values.
+// Builds a batch before the diagram whose operands its values are compared with, such that the values are not interned yet when the batch is built.
+
+#include <DecisionDiagram.h>
+#include <BatchClassifier.h>
+#include <SymbolTable.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace dlvhex::dd::util;
+
+int main(){
+	try{
+		BatchClassifier::Batch batch(2);
+		std::vector<std::string> colour;
+		colour.push_back("red");
+		colour.push_back("blue");
+		batch.addColumn("colour", colour);
+
+		DecisionDiagram dd;
+		dd.setRoot(dd.addNode("root"));
+		dd.addEdge(dd.getRoot(), dd.addLeafNode("leafyes", "yes"), DecisionDiagram::Condition("colour", "red", DecisionDiagram::Condition::eq));
+		dd.addElseEdge(dd.getRoot(), dd.addLeafNode("leafno", "no"));
+
+		std::vector<SymbolTable::Id> classifications;
+		BatchClassifier(dd).classify(batch, classifications);
+		for (std::vector<SymbolTable::Id>::iterator it = classifications.begin(); it != classifications.end(); it++){
+			std::cout << (it == classifications.begin() ? "" : " ") << SymbolTable::lookup(*it);
+		}
+		std::cout << std::endl;
+	}catch(DecisionDiagram::InvalidDecisionDiagram idde){
+		std::cout << "InvalidDecisionDiagram: " << idde.getMessage() << std::endl;
+		return 1;
+	}catch(BatchClassifier::InvalidBatch ib){
+		std::cout << "InvalidBatch: " << ib.getMessage() << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,90 @@
+// Differential test driver for the cpp output format of the graphconverter.
+// Includes a generated classifier (classifier.h) and loads the same diagram from a binary file (first argument). Generates random data rows, whose values are
+// rounded to float since the generated classifier reads float rows, classifies them with the generated code and with the interpreted evaluation (see BatchClassifier),
+// and writes the number of rows and the number of rows with different classifications to standard output.
+
+#include "classifier.h"
+
+#include <BatchClassifier.h>
+#include <DecisionDiagramFile.h>
+
+#include <boost/cstdint.hpp>
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace dlvhex::dd::util;
+
+namespace{
+	// deterministic pseudo random numbers (independent of the standard library)
+	boost::uint32_t state = 12345;
+	boost::uint32_t next(){
+		state = state * 1103515245u + 12345u;
+		return state >> 8;
+	}
+
+	// values near the thresholds (including the nearest floats on both sides), random values and NaN
+	float randomValue(){
+		int thresholdCount = sizeof(ddclassifier::thresholds) / sizeof(ddclassifier::thresholds[0]);
+		float t = (float)ddclassifier::thresholds[next() % thresholdCount];
+		switch (next() % 6){
+			case 0: return t;
+			case 1: return nextafterf(t, std::numeric_limits<float>::infinity());
+			case 2: return nextafterf(t, -std::numeric_limits<float>::infinity());
+			case 3: return std::numeric_limits<float>::quiet_NaN();
+			default: return (float)((double)(next() % 4000000) / 1000000.0 - 2.0);
+		}
+	}
+}
+
+int main(int argc, char** argv){
+	if (argc != 2){
+		std::cerr << "Usage: " << argv[0] << " [binary diagram file]" << std::endl;
+		return 1;
+	}
+
+	const int rowCount = 100000;
+	std::vector<std::vector<float> > rows(rowCount, std::vector<float>(ddclassifier::attributeCount));
+	for (int r = 0; r < rowCount; r++){
+		for (int a = 0; a < ddclassifier::attributeCount; a++){
+			rows[r][a] = randomValue();
+		}
+	}
+
+	try{
+		// interpreted evaluation of the same values (as double)
+		DecisionDiagramFile file(argv[1]);
+		DecisionDiagram dd;
+		file.toDecisionDiagram(0, dd);
+		BatchClassifier classifier(dd);
+		BatchClassifier::Batch batch(rowCount);
+		for (int a = 0; a < ddclassifier::attributeCount; a++){
+			std::vector<double> column(rowCount);
+			for (int r = 0; r < rowCount; r++){
+				column[r] = rows[r][a];
+			}
+			batch.addColumn(ddclassifier::attributeNames[a], column);
+		}
+		std::vector<SymbolTable::Id> classifications;
+		classifier.classify(batch, classifications);
+
+		// compare with the generated code
+		int mismatches = 0;
+		for (int r = 0; r < rowCount; r++){
+			ddclassifier::Class c = ddclassifier::classify(&rows[r][0]);
+			std::string generated = (c == ddclassifier::NO_CLASS ? "" : ddclassifier::classNames[c]);
+			if (generated != SymbolTable::lookup(classifications[r])) mismatches++;
+		}
+		std::cout << rowCount << " rows, " << mismatches << " mismatches" << std::endl;
+	}catch(DecisionDiagram::InvalidDecisionDiagram idde){
+		std::cout << "InvalidDecisionDiagram: " << idde.getMessage() << std::endl;
+		return 1;
+	}catch(BatchClassifier::InvalidBatch ib){
+		std::cout << "InvalidBatch: " << ib.getMessage() << std::endl;
+		return 1;
+	}
+	return 0;
+}
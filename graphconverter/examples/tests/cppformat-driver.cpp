@@ -0,0 +1,23 @@
+// Test driver for the cpp output format of the graphconverter.
+// Includes a generated classifier (classifier.h), reads data rows (whitespace-separated values in the order of ddclassifier::Attribute) from standard input
+// and writes the classification of each row to standard output.
+
+#include "classifier.h"
+
+#include <stdlib.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+int main(){
+	std::vector<float> row(ddclassifier::attributeCount + 1);
+	std::string value;
+	while (true){
+		for (int i = 0; i < ddclassifier::attributeCount; i++){
+			if (!(std::cin >> value)) return 0;
+			row[i] = (float)strtod(value.c_str(), NULL);
+		}
+		ddclassifier::Class c = ddclassifier::classify(&row[0]);
+		std::cout << (c == ddclassifier::NO_CLASS ? "" : ddclassifier::classNames[c]) << std::endl;
+	}
+}
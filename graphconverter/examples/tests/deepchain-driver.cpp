@@ -0,0 +1,107 @@
+// Regression test driver for deep diagrams.
+// Builds chains of binary nodes which are too deep for recursive algorithms (each node branches into a leaf and continues with the next node), and runs
+// the comparison, structural hashing, C++ generation and rmxml conversion on them. Writes the results to standard output.
+
+#include <DecisionDiagram.h>
+#include <CompactDecisionDiagram.h>
+#include <CppFormat.h>
+#include <RmxmlFormat.h>
+#include <StringHelper.h>
+
+#include <cstdio>
+#include <unistd.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace dlvhex::dd::util;
+using namespace dlvhex::dd::tools::graphconverter;
+
+namespace{
+	// classifications with class frequency distributions (required by rmxml)
+	const char* const even = "even {even:1,odd:0}";
+	const char* const odd = "odd {even:0,odd:1}";
+
+	// builds a chain of depth inner nodes, which continue with an else edge (or with the complementary condition, since rmxml does not support else edges); returns the deepest leaf
+	DecisionDiagram::LeafNode* buildChain(DecisionDiagram& dd, int depth, bool elseEdges){
+		DecisionDiagram::Node* n = dd.addNode("n0");
+		dd.setRoot(n);
+		for (int i = 0; i < depth; i++){
+			DecisionDiagram::LeafNode* leaf = dd.addLeafNode(std::string("l") + StringHelper::toString(i), (i % 2 == 0) ? even : odd);
+			dd.addEdge(n, leaf, DecisionDiagram::Condition("x", StringHelper::toString(i), DecisionDiagram::Condition::lt));
+			DecisionDiagram::Node* next = (i + 1 == depth) ? dd.addLeafNode("last", even) : dd.addNode(std::string("n") + StringHelper::toString(i + 1));
+			if (elseEdges){
+				dd.addElseEdge(n, next);
+			}else{
+				dd.addEdge(n, next, DecisionDiagram::Condition("x", StringHelper::toString(i), DecisionDiagram::Condition::ge));
+			}
+			if (i + 1 == depth) return next->asLeaf();
+			n = next;
+		}
+		return NULL;
+	}
+
+	// counts the lines of a text which contain a pattern
+	int countLines(const std::string& text, const std::string& pattern){
+		std::istringstream in(text);
+		std::string line;
+		int count = 0;
+		while (std::getline(in, line)){
+			if (line.find(pattern) != std::string::npos) count++;
+		}
+		return count;
+	}
+}
+
+int main(){
+	try{
+		const int depth = 100000;
+
+		// comparison and structural hashes (the change of the deepest leaf invalidates the hashes of all ancestors)
+		DecisionDiagram dd1;
+		buildChain(dd1, depth, true);
+		DecisionDiagram dd2;
+		DecisionDiagram::LeafNode* last = buildChain(dd2, depth, true);
+		std::cout << "hash " << (dd1.getRoot()->getStructuralHash() == dd2.getRoot()->getStructuralHash() ? "equal" : "different") << std::endl;
+		std::cout << "nodes " << (*dd1.getRoot() == *dd2.getRoot() ? "equal" : "different") << std::endl;
+		std::cout << "compact " << (CompactDecisionDiagram(dd1) == CompactDecisionDiagram(dd2) ? "equal" : "different") << std::endl;
+		last->setClassification(odd);
+		std::cout << "hash " << (dd1.getRoot()->getStructuralHash() == dd2.getRoot()->getStructuralHash() ? "equal" : "different") << std::endl;
+		std::cout << "nodes " << (*dd1.getRoot() == *dd2.getRoot() ? "equal" : "different") << std::endl;
+		std::cout << "compact " << (CompactDecisionDiagram(dd1) == CompactDecisionDiagram(dd2) ? "equal" : "different") << std::endl;
+
+		// C++ generation (the formats write to standard output)
+		std::vector<DecisionDiagram*> ddv(1, &dd1);
+		std::stringstream cpp;
+		std::streambuf* stdoutBuffer = std::cout.rdbuf(cpp.rdbuf());
+		CppFormat().write(ddv);
+		std::cout.rdbuf(stdoutBuffer);
+		std::cout << "cpp " << countLines(cpp.str(), "if (row[") << " branches" << std::endl;
+
+		// rmxml conversion (TinyXML processes nested elements recursively and the indentation of the output grows with the depth, thus the chain is shorter);
+		// the document is printed to the standard output stream of the C library, which is redirected into a temporary file and read back as standard input
+		DecisionDiagram dd3;
+		buildChain(dd3, 200, false);
+		ddv[0] = &dd3;
+		FILE* xmlFile = tmpfile();
+		std::cout.flush();
+		fflush(stdout);
+		int stdoutFd = dup(fileno(stdout));
+		dup2(fileno(xmlFile), fileno(stdout));
+		RmxmlFormat().write(ddv);
+		fflush(stdout);
+		dup2(stdoutFd, fileno(stdout));
+		close(stdoutFd);
+		lseek(fileno(xmlFile), 0, SEEK_SET);
+		dup2(fileno(xmlFile), fileno(stdin));
+		std::vector<DecisionDiagram*> read = RmxmlFormat().read();
+		fclose(xmlFile);
+		std::cout << "rmxml " << read[0]->nodeCount() << " nodes, " << read[0]->edgeCount() << " edges" << std::endl;
+		delete read[0];
+	}catch(DecisionDiagram::InvalidDecisionDiagram idde){
+		std::cout << "InvalidDecisionDiagram: " << idde.getMessage() << std::endl;
+		return 1;
+	}
+	return 0;
+}
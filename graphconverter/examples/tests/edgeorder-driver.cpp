@@ -0,0 +1,50 @@
+// Test driver for the order of out-edges in copies of decision diagrams.
+// Removes an edge and adds another one (which may reuse the memory of the removed edge), copies the diagram
+// in several ways and writes the children of the root of each copy in the order of its out-edges.
+
+#include <DecisionDiagram.h>
+
+#include <iostream>
+#include <memory>
+
+using namespace dlvhex::dd::util;
+
+void printChildren(const DecisionDiagram& dd){
+	DecisionDiagram::EdgeList outEdges = dd.getRoot()->getOutEdgeRange();
+	for (DecisionDiagram::EdgeList::iterator it = outEdges.begin(); it != outEdges.end(); it++){
+		std::cout << (it == outEdges.begin() ? "" : " ") << (*it)->getTo()->getLabel();
+	}
+	std::cout << std::endl;
+}
+
+int main(){
+	try{
+		DecisionDiagram dd;
+		dd.setRoot(dd.addNode("root"));
+		DecisionDiagram::Edge* a = dd.addEdge(dd.getRoot(), dd.addLeafNode("a", "ca"), DecisionDiagram::Condition("x", "1", DecisionDiagram::Condition::lt));
+		dd.addEdge(dd.getRoot(), dd.addLeafNode("b", "cb"), DecisionDiagram::Condition("x", "2", DecisionDiagram::Condition::lt));
+		dd.removeEdge(a);
+		dd.addEdge(dd.getRoot(), dd.addLeafNode("c", "cc"), DecisionDiagram::Condition("x", "3", DecisionDiagram::Condition::lt));
+		printChildren(dd);
+
+		// copy constructor and assignment
+		DecisionDiagram copy(dd);
+		printChildren(copy);
+		DecisionDiagram assigned;
+		assigned = dd;
+		printChildren(assigned);
+
+		// clone
+		std::auto_ptr<DecisionDiagram> clone(dd.clone());
+		printChildren(*clone);
+
+		// union with an empty diagram
+		DecisionDiagram united;
+		united.setRoot(united.addDecisionDiagram(&dd));
+		printChildren(united);
+	}catch(DecisionDiagram::InvalidDecisionDiagram idde){
+		std::cout << "InvalidDecisionDiagram: " << idde.getMessage() << std::endl;
+		return 1;
+	}
+	return 0;
+}
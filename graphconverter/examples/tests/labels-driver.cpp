@@ -0,0 +1,62 @@
+// Test driver for the label handling of decision diagrams.
+// Mixes fresh nodes (whose labels are generated on demand) with useUniqueLabels, addDecisionDiagram and label lookups,
+// and writes the resulting labels to standard output.
+
+#include <DecisionDiagram.h>
+
+#include <algorithm>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace dlvhex::dd::util;
+
+void printLabels(const DecisionDiagram& dd){
+	std::vector<std::string> labels;
+	std::set<DecisionDiagram::Node*> nodes = dd.getNodes();
+	for (std::set<DecisionDiagram::Node*>::iterator it = nodes.begin(); it != nodes.end(); it++){
+		labels.push_back((*it)->getLabel());
+	}
+	std::sort(labels.begin(), labels.end());
+	for (std::vector<std::string>::iterator it = labels.begin(); it != labels.end(); it++){
+		std::cout << (it == labels.begin() ? "" : " ") << *it;
+	}
+	std::cout << std::endl;
+}
+
+int main(){
+	try{
+		// the fresh nodes of the argument collide with the labels of this diagram
+		DecisionDiagram dd1;
+		dd1.setRoot(dd1.addNode("x"));
+		dd1.addElseEdge(dd1.getRoot(), dd1.addLeafNode("y", "c1"));
+		DecisionDiagram dd2;
+		dd2.setRoot(dd2.addFreshNode("x"));
+		dd2.addElseEdge(dd2.getRoot(), dd2.addFreshLeafNode("y", "c2"));
+		dd1.useUniqueLabels(&dd2);
+		dd1.addDecisionDiagram(&dd2);
+		printLabels(dd1);
+
+		// the fresh nodes of this diagram collide with the labels of the argument
+		DecisionDiagram dd3;
+		dd3.setRoot(dd3.addFreshNode("x"));
+		dd3.addElseEdge(dd3.getRoot(), dd3.addFreshLeafNode("y", "c1"));
+		DecisionDiagram dd4;
+		dd4.setRoot(dd4.addNode("x"));
+		dd4.addElseEdge(dd4.getRoot(), dd4.addLeafNode("y", "c2"));
+		dd3.useUniqueLabels(&dd4);
+		dd3.addDecisionDiagram(&dd4);
+		printLabels(dd3);
+
+		// fresh nodes can be looked up by their labels
+		DecisionDiagram dd5;
+		dd5.addNode("z");
+		DecisionDiagram::Node* fresh = dd5.addFreshNode("z");
+		std::cout << (dd5.getNodeByLabel("z_1") == fresh ? "found z_1" : "wrong node") << std::endl;
+	}catch(DecisionDiagram::InvalidDecisionDiagram idde){
+		std::cout << "InvalidDecisionDiagram: " << idde.getMessage() << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -30,6 +30,7 @@ ntests=0
 MKTEMP="mktemp -t tmp.XXXXXXXXXX"
 TMPFILE_DOT=$($MKTEMP)
 TMPFILE_HEX=$($MKTEMP)
+TMPDIR_CPP=$($MKTEMP -d)
 
 # Check prerequisites
 #   none
@@ -65,6 +66,62 @@ do
 		# compare with reference output
 		$CMPSCRIPT $TMPFILE_DOT $REFOUTPUT "dot" #&> /dev/null
 		succ=$?
+	elif [ "$ADDDCPARM" = "hex cpp" ]
+	then
+		# to C++ source
+
+		# run graphconverter, compile the generated classifier and apply it to the data rows (stored next to the reference output)
+		$GRAPHCONVERTER $PARAMETERS $ADDDCPARM < $INPUT > $TMPDIR_CPP/classifier.h &&
+		${CXX:-g++} -I$TMPDIR_CPP -o $TMPDIR_CPP/classifier $TESTDIR/cppformat-driver.cpp &&
+		$TMPDIR_CPP/classifier < ${REFOUTPUT%.classes}.rows > $TMPDIR_CPP/classes
+
+		# compare with reference output (the classification of each row)
+		succ=$?
+		if [ $succ = 0 ]
+		then
+			cmp -s $TMPDIR_CPP/classes $REFOUTPUT
+			succ=$?
+		fi
+	elif [ "$ADDDCPARM" = "hex cppdiff" ]
+	then
+		# to C++ source, compared with the interpreted evaluation
+
+		# run graphconverter, compile the generated classifier together with the decision diagram library and let the driver compare both on random rows
+		$GRAPHCONVERTER $PARAMETERS hex cpp < $INPUT > $TMPDIR_CPP/classifier.h &&
+		$GRAPHCONVERTER $PARAMETERS hex bin < $INPUT > $TMPDIR_CPP/diagram.ddb &&
+		${CXX:-g++} -I$TMPDIR_CPP $DRIVERCPPFLAGS -o $TMPDIR_CPP/diffclassifier $TESTDIR/cppformat-diffdriver.cpp $DRIVEROBJECTS $DRIVERLIBS &&
+		$TMPDIR_CPP/diffclassifier $TMPDIR_CPP/diagram.ddb > $TMPDIR_CPP/diff
+
+		# compare with reference output (the number of rows and mismatches)
+		succ=$?
+		if [ $succ = 0 ]
+		then
+			cmp -s $TMPDIR_CPP/diff $REFOUTPUT
+			succ=$?
+		fi
+	elif [ "$ADDDCPARM" = "driver" ]
+	then
+		# C++ test driver for the decision diagram library
+
+		# compile the driver, run it and compare its output with the reference output
+		${CXX:-g++} $DRIVERCPPFLAGS -o $TMPDIR_CPP/driver $INPUT $DRIVEROBJECTS $DRIVERLIBS &&
+		$TMPDIR_CPP/driver > $TMPDIR_CPP/driver.out
+		succ=$?
+		if [ $succ = 0 ]
+		then
+			cmp -s $TMPDIR_CPP/driver.out $REFOUTPUT
+			succ=$?
+		fi
+	elif [ "$ADDDCPARM" = "hex bin" ]
+	then
+		# to binary file and back
+
+		# run graphconverter with specified parameters and input, read the binary file again
+		$GRAPHCONVERTER $PARAMETERS $ADDDCPARM < $INPUT | $GRAPHCONVERTER $PARAMETERS bin hex > $TMPFILE_HEX
+
+		# compare with reference output
+		$CMPSCRIPT $TMPFILE_HEX $REFOUTPUT "hex" #&> /dev/null
+		succ=$?
 	else
 		# to answer-set file
 
@@ -89,6 +146,7 @@ done
 # cleanup
 rm -f $TMPFILE_DOT
 rm -f $TMPFILE_HEX
+rm -rf $TMPDIR_CPP
 
 echo ========== graphconverter tests completed ==========
 
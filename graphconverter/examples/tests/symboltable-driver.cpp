@@ -0,0 +1,42 @@
+// Test driver for the release of symbols.
+// Builds diagrams with generated labels within a SymbolTable::Scope and checks that exactly the symbols interned within the scope are released.
+
+#include <DecisionDiagram.h>
+#include <SymbolTable.h>
+
+#include <iostream>
+
+using namespace dlvhex::dd::util;
+
+int main(){
+	try{
+		SymbolTable::Id x = SymbolTable::intern("x");
+		std::size_t before = SymbolTable::size();
+		{
+			SymbolTable::Scope symbols;
+			DecisionDiagram dd;
+			dd.setRoot(dd.addNode("x"));
+			dd.addElseEdge(dd.getRoot(), dd.addFreshLeafNode("x", "scopedclass"));
+			dd.addElseEdge(dd.getRoot(), dd.addFreshLeafNode("x", "scopedclass"));
+			std::cout << "labels " << dd.getNodeByLabel("x_1")->getLabel() << " " << dd.getNodeByLabel("x_2")->getLabel() << std::endl;
+			{
+				SymbolTable::Scope inner;
+				SymbolTable::intern("inner");
+			}
+			SymbolTable::Id id;
+			std::cout << "inner " << (SymbolTable::find("inner", id) ? "kept" : "released") << std::endl;
+		}
+		SymbolTable::Id id;
+		std::cout << "size " << (SymbolTable::size() == before ? "restored" : "changed") << std::endl;
+		std::cout << "x_1 " << (SymbolTable::find("x_1", id) ? "kept" : "released") << std::endl;
+		std::cout << "scopedclass " << (SymbolTable::find("scopedclass", id) ? "kept" : "released") << std::endl;
+		std::cout << "x " << (SymbolTable::find("x", id) && id == x ? "kept" : "released") << std::endl;
+
+		// released ids are reused
+		std::cout << "reused " << (SymbolTable::intern("y_1") == before ? "yes" : "no") << std::endl;
+	}catch(DecisionDiagram::InvalidDecisionDiagram idde){
+		std::cout << "InvalidDecisionDiagram: " << idde.getMessage() << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,29 @@
+#ifndef _BINFORMAT_H_
+#define _BINFORMAT_H_
+
+#include <IFormat.h>
+#include <DecisionDiagram.h>
+
+using namespace dlvhex::dd::util;
+
+namespace dlvhex{
+	namespace dd{
+		namespace tools{
+			namespace graphconverter{
+
+				/**
+				 * \brief Reads and writes decision diagrams in binary format (see DecisionDiagramFile).
+				 */
+				class BinFormat : public IFormat{
+				public:
+					virtual std::string getName();
+					virtual std::string getNameAbbr();
+					virtual std::vector<DecisionDiagram*> read() throw (DecisionDiagram::InvalidDecisionDiagram);
+					virtual void write(std::vector<DecisionDiagram*> dd) throw (DecisionDiagram::InvalidDecisionDiagram);
+				};
+			}
+		}
+	}
+}
+
+#endif
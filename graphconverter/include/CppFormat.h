@@ -0,0 +1,49 @@
+#ifndef _CPPFORMAT_H_
+#define _CPPFORMAT_H_
+
+#include <IFormat.h>
+
+#include <map>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace dlvhex::dd::util;
+
+namespace dlvhex{
+	namespace dd{
+		namespace tools{
+			namespace graphconverter{
+
+				/**
+				 * \brief Translates a decision diagram into a self-contained C++ header with a classify function (write only).
+				 */
+				class CppFormat : public IFormat{
+				private:
+					class Writer;
+					friend class Writer;
+
+					std::map<std::string, std::string> classIdentifiers;
+					std::map<std::string, std::string> attributeIdentifiers;
+					std::set<std::string> usedIdentifiers;
+					std::vector<double> thresholds;
+					std::vector<const DecisionDiagram::Node*> sharedNodes;
+					std::vector<bool> sharedNodeQueued;
+
+					std::string makeIdentifier(std::string prefix, const std::string& name);
+					std::string quote(const std::string& str);
+					std::string formatNumber(double value);
+					void writeNode(std::ostream& out, const DecisionDiagram& dd, const DecisionDiagram::Node* node, int indent);
+				public:
+					virtual std::string getName();
+
+					virtual std::vector<DecisionDiagram*> read() throw (DecisionDiagram::InvalidDecisionDiagram);
+					virtual void write(std::vector<DecisionDiagram*> dd) throw (DecisionDiagram::InvalidDecisionDiagram);
+				};
+			}
+		}
+	}
+}
+
+#endif
@@ -14,6 +14,11 @@ namespace dlvhex{
 
 				class RmxmlFormat : public IFormat{
 				private:
+					class XmlWriting;
+					friend class XmlWriting;
+					class XmlReading;
+					friend class XmlReading;
+
 					// XML --> DD
 					DecisionDiagram getDDDiag(TiXmlDocument* doc);
 					DecisionDiagram::Node* getDDnode(DecisionDiagram* dd, TiXmlElement* ce);
@@ -0,0 +1,50 @@
+#include <BinFormat.h>
+#include <DecisionDiagramFile.h>
+
+#include <boost/cstdint.hpp>
+
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace dlvhex::dd::tools::graphconverter;
+
+std::string BinFormat::getName(){
+	return "binary";
+}
+
+std::string BinFormat::getNameAbbr(){
+	return "bin";
+}
+
+std::vector<DecisionDiagram*> BinFormat::read() throw (DecisionDiagram::InvalidDecisionDiagram){
+	// standard input cannot be mapped, thus it is read into a buffer (of 64-bit words, such that the tables are aligned)
+	std::string contents((std::istreambuf_iterator<char>(std::cin)), std::istreambuf_iterator<char>());
+	std::vector<boost::uint64_t> buffer(contents.size() / sizeof(boost::uint64_t) + 1);
+	contents.copy(reinterpret_cast<char*>(&buffer[0]), contents.size());
+	DecisionDiagramFile file(reinterpret_cast<const char*>(&buffer[0]), contents.size());
+
+	// the vector does not grow while the diagrams are allocated, thus no diagram is lost before it is stored
+	std::vector<DecisionDiagram*> v;
+	v.reserve(file.diagramCount());
+	try{
+		for (int i = 0; i < file.diagramCount(); i++){
+			v.push_back(new DecisionDiagram());
+			file.toDecisionDiagram(i, *v.back());
+		}
+	}catch(...){
+		// the caller only receives the diagrams if all of them were read
+		for (std::vector<DecisionDiagram*>::iterator it = v.begin(); it != v.end(); it++){
+			delete *it;
+		}
+		throw;
+	}
+	return v;
+}
+
+void BinFormat::write(std::vector<DecisionDiagram*> dd) throw (DecisionDiagram::InvalidDecisionDiagram){
+	std::vector<const DecisionDiagram*> diagrams(dd.begin(), dd.end());
+	DecisionDiagramFile::write(std::cout, diagrams);
+	std::cout.flush();
+}
@@ -0,0 +1,332 @@
+#include <CppFormat.h>
+#include <SymbolTable.h>
+
+#include <cctype>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+
+using namespace dlvhex::dd::tools::graphconverter;
+
+std::string CppFormat::getName(){
+	return "cpp";
+}
+
+std::vector<DecisionDiagram*> CppFormat::read() throw (DecisionDiagram::InvalidDecisionDiagram){
+	throw DecisionDiagram::InvalidDecisionDiagram("Error: C++ sources can only be written, not read.");
+}
+
+// Generates a C++ header of the following form:
+//
+//   namespace ddclassifier{
+//   	enum Class{ NO_CLASS = -1, CLASS_... };		one constant per classification
+//   	enum Attribute{ ATTR_... };			index of each attribute within a data row
+//   	thresholds[]					comparison values of the conditions
+//   	Class classify(const float* row)		nested branches; shared subdiagrams are written once and reached by goto
+//   }
+//
+// The conditional edges of a node are tested in the order of insertion, the else edge is the fallback. The float values of a row are compared with the thresholds in double precision,
+// such that the result is the same as the one of the interpreted evaluation of these values (see BatchClassifier), even if a threshold is not representable as float; NaN does not
+// satisfy any condition.
+void CppFormat::write(std::vector<DecisionDiagram*> ddv) throw (DecisionDiagram::InvalidDecisionDiagram){
+	if (ddv.size() != 1) throw DecisionDiagram::InvalidDecisionDiagram("Error: Cpp-writer can only write one diagram at one time.");
+
+	const DecisionDiagram& dd = *ddv[0];
+	if (dd.getRoot() == NULL) throw DecisionDiagram::InvalidDecisionDiagram("Error: Could not detect the root node of the decision diagram.");
+
+	// Collect the classes and attributes of the reachable part (throws if the diagram contains cycles)
+	const std::vector<DecisionDiagram::Node*>& order = dd.getTopologicalOrder();
+	std::set<std::string> classes;
+	std::set<std::string> attributes;
+	for (std::vector<DecisionDiagram::Node*>::const_iterator it = order.begin(); it != order.end(); it++){
+		if (!dd.isReachableFromRoot(*it)) continue;
+		if ((*it)->isLeaf()) classes.insert((*it)->asLeaf()->getClassification());
+		DecisionDiagram::EdgeList outEdges = (*it)->getOutEdgeRange();
+		for (DecisionDiagram::EdgeList::iterator e = outEdges.begin(); e != outEdges.end(); e++){
+			if (!(*e)->isElse() && (*e)->getCondition().hasAttribute()) attributes.insert((*e)->getCondition().getAttribute());
+		}
+	}
+
+	classIdentifiers.clear();
+	attributeIdentifiers.clear();
+	usedIdentifiers.clear();
+	thresholds.clear();
+	sharedNodes.clear();
+	sharedNodeQueued.assign(order.size(), false);
+	for (std::set<std::string>::iterator it = classes.begin(); it != classes.end(); it++){
+		classIdentifiers[*it] = makeIdentifier("CLASS_", *it);
+	}
+	for (std::set<std::string>::iterator it = attributes.begin(); it != attributes.end(); it++){
+		attributeIdentifiers[*it] = makeIdentifier("ATTR_", *it);
+	}
+
+	// Generate the function body first, since it determines the threshold table
+	std::stringstream body;
+	writeNode(body, dd, dd.getRoot(), 2);
+	for (unsigned int i = 0; i < sharedNodes.size(); i++){
+		body << "\tnode_" << dd.getNodeIndex(sharedNodes[i]) << ":" << std::endl;
+		writeNode(body, dd, sharedNodes[i], 2);
+	}
+
+	std::ostream& out = std::cout;
+	out << "// Generated by graphconverter. Do not edit." << std::endl;
+	out << "#ifndef DD_CLASSIFIER_H" << std::endl;
+	out << "#define DD_CLASSIFIER_H" << std::endl << std::endl;
+	out << "#include <limits>" << std::endl << std::endl;
+	out << "#ifndef DD_CLASSIFIER_CONSTEXPR" << std::endl;
+	out << "#if __cplusplus >= 201103L" << std::endl;
+	out << "#define DD_CLASSIFIER_CONSTEXPR constexpr" << std::endl;
+	out << "#else" << std::endl;
+	out << "#define DD_CLASSIFIER_CONSTEXPR const" << std::endl;
+	out << "#endif" << std::endl;
+	out << "#endif" << std::endl << std::endl;
+	out << "namespace ddclassifier{" << std::endl << std::endl;
+
+	// Classes
+	out << "\tenum Class{" << std::endl;
+	out << "\t\tNO_CLASS = -1";
+	int index = 0;
+	for (std::set<std::string>::iterator it = classes.begin(); it != classes.end(); it++){
+		out << "," << std::endl << "\t\t" << classIdentifiers[*it] << " = " << index++;
+	}
+	out << std::endl << "\t};" << std::endl << std::endl;
+	out << "\tstatic DD_CLASSIFIER_CONSTEXPR int classCount = " << classes.size() << ";" << std::endl;
+	if (!classes.empty()){
+		out << "\tstatic const char* const classNames[] = {";
+		for (std::set<std::string>::iterator it = classes.begin(); it != classes.end(); it++){
+			out << (it == classes.begin() ? " " : ", ") << quote(*it);
+		}
+		out << " };" << std::endl;
+	}
+	out << std::endl;
+
+	// Attributes
+	if (!attributes.empty()){
+		out << "\tenum Attribute{" << std::endl;
+		index = 0;
+		for (std::set<std::string>::iterator it = attributes.begin(); it != attributes.end(); it++){
+			out << (it == attributes.begin() ? "" : ",\n") << "\t\t" << attributeIdentifiers[*it] << " = " << index++;
+		}
+		out << std::endl << "\t};" << std::endl << std::endl;
+	}
+	out << "\tstatic DD_CLASSIFIER_CONSTEXPR int attributeCount = " << attributes.size() << ";" << std::endl;
+	if (!attributes.empty()){
+		out << "\tstatic const char* const attributeNames[] = {";
+		for (std::set<std::string>::iterator it = attributes.begin(); it != attributes.end(); it++){
+			out << (it == attributes.begin() ? " " : ", ") << quote(*it);
+		}
+		out << " };" << std::endl;
+	}
+	out << std::endl;
+
+	// Thresholds
+	if (!thresholds.empty()){
+		out << "\tstatic DD_CLASSIFIER_CONSTEXPR double thresholds[] = {" << std::endl;
+		for (unsigned int i = 0; i < thresholds.size(); i++){
+			out << "\t\t" << formatNumber(thresholds[i]) << (i + 1 < thresholds.size() ? "," : "") << std::endl;
+		}
+		out << "\t};" << std::endl << std::endl;
+	}
+
+	// Classification function
+	out << "\t// Classifies a data row (one value per attribute, see enum Attribute)" << std::endl;
+	out << "\tinline Class classify(const float* row){" << std::endl;
+	out << body.str();
+	out << "\t}" << std::endl;
+	out << "}" << std::endl << std::endl;
+	out << "#endif" << std::endl;
+}
+
+/**
+ * Translates a string into a unique C++ identifier
+ * \param prefix A prefix for the identifier
+ * \param name The string to translate (characters which are not allowed in identifiers are replaced by underscores)
+ * \return std::string An identifier which was not returned before
+ */
+std::string CppFormat::makeIdentifier(std::string prefix, const std::string& name){
+	std::string identifier = prefix;
+	for (std::string::const_iterator it = name.begin(); it != name.end(); it++){
+		identifier += (isalnum((unsigned char)*it) ? *it : '_');
+	}
+	std::string unique = identifier;
+	for (int i = 2; usedIdentifiers.count(unique) > 0; i++){
+		std::stringstream ss;
+		ss << identifier << "_" << i;
+		unique = ss.str();
+	}
+	usedIdentifiers.insert(unique);
+	return unique;
+}
+
+/**
+ * Formats a string as C++ literal
+ * \param str A string
+ * \return std::string The C++ literal (in quotes)
+ */
+std::string CppFormat::quote(const std::string& str){
+	std::string literal = "\"";
+	for (std::string::const_iterator it = str.begin(); it != str.end(); it++){
+		if (*it == '"' || *it == '\\') literal += '\\';
+		literal += *it;
+	}
+	return literal + "\"";
+}
+
+/**
+ * Formats a number as C++ literal, such that it is read back exactly
+ * \param value A number
+ * \return std::string The C++ literal
+ */
+std::string CppFormat::formatNumber(double value){
+	if (value != value) return "std::numeric_limits<double>::quiet_NaN()";
+	if (value == std::numeric_limits<double>::infinity()) return "std::numeric_limits<double>::infinity()";
+	if (value == -std::numeric_limits<double>::infinity()) return "-std::numeric_limits<double>::infinity()";
+	std::stringstream ss;
+	ss << std::setprecision(17) << value;
+	return ss.str();
+}
+
+namespace{
+	// a piece of the statements which are written by CppFormat::writeNode (the pieces are written in the order in which they are processed)
+	struct WriteTask{
+		enum Kind{
+			node,		// the statements which classify a row that reached a node
+			child,		// the statements which classify a row that moves to a child node (a goto for shared subdiagrams)
+			branch,		// the head of the if statement of a conditional edge
+			close,		// the end of an if statement
+			noClass		// the fallback of a node without else edge
+		};
+
+		WriteTask(Kind kind_, const DecisionDiagram::Node* n_, const DecisionDiagram::Edge* e_, int indent_) : kind(kind_), n(n_), e(e_), indent(indent_){
+		}
+
+		Kind kind;
+		const DecisionDiagram::Node* n;
+		const DecisionDiagram::Edge* e;
+		int indent;			// the number of tabs in front of each statement
+	};
+}
+
+// writes the statements top-down: enter writes the text of a piece and lists the pieces which follow below it, such that deep diagrams do not exhaust the call stack
+class CppFormat::Writer : public DecisionDiagram::Traversal<WriteTask, bool>{
+private:
+	CppFormat& format;
+	std::ostream& out;
+	const DecisionDiagram& dd;
+
+	void enterNode(const WriteTask& t, std::vector<WriteTask>& children){
+		if (t.n->isLeaf()){
+			out << std::string(t.indent, '\t') << "return " << format.classIdentifiers[t.n->asLeaf()->getClassification()] << ";" << std::endl;
+			return;
+		}
+
+		const DecisionDiagram::Node* elseChild = NULL;
+		DecisionDiagram::EdgeList outEdges = t.n->getOutEdgeRange();
+		for (DecisionDiagram::EdgeList::iterator it = outEdges.begin(); it != outEdges.end(); it++){
+			if ((*it)->isElse()){
+				// only the first else edge can ever be taken
+				if (elseChild == NULL) elseChild = (*it)->getTo();
+				continue;
+			}
+
+			DecisionDiagram::Condition c = (*it)->getCondition();
+			if (!c.hasAttribute()){
+				// both operands are numbers: the condition is constant
+				double v1 = SymbolTable::getNumericValue(c.getOperand1Symbol());
+				double v2 = SymbolTable::getNumericValue(c.getOperand2Symbol());
+				bool satisfied = false;
+				switch (c.getOperation()){
+					case DecisionDiagram::Condition::lt: satisfied = v1 < v2; break;
+					case DecisionDiagram::Condition::le: satisfied = v1 <= v2; break;
+					case DecisionDiagram::Condition::eq: satisfied = v1 == v2; break;
+					case DecisionDiagram::Condition::ge: satisfied = v1 >= v2; break;
+					case DecisionDiagram::Condition::gt: satisfied = v1 > v2; break;
+					default: break;
+				}
+				if (satisfied){
+					children.push_back(WriteTask(WriteTask::child, (*it)->getTo(), NULL, t.indent));
+					return;
+				}
+				continue;
+			}
+			if (!c.hasCmpValue()) throw DecisionDiagram::InvalidDecisionDiagram(std::string("Error: Condition \"") + c.toString() + std::string("\" does not compare an attribute with a number. Only numeric conditions can be translated into C++."));
+
+			children.push_back(WriteTask(WriteTask::branch, NULL, *it, t.indent));
+			children.push_back(WriteTask(WriteTask::child, (*it)->getTo(), NULL, t.indent + 1));
+			children.push_back(WriteTask(WriteTask::close, NULL, NULL, t.indent));
+		}
+
+		// fallback
+		if (elseChild != NULL){
+			children.push_back(WriteTask(WriteTask::child, elseChild, NULL, t.indent));
+		}else{
+			children.push_back(WriteTask(WriteTask::noClass, NULL, NULL, t.indent));
+		}
+	}
+
+public:
+	Writer(CppFormat& format_, std::ostream& out_, const DecisionDiagram& dd_) : format(format_), out(out_), dd(dd_){
+	}
+
+	virtual void enter(WriteTask& t, std::vector<WriteTask>& children){
+		std::string tabs(t.indent, '\t');
+		switch (t.kind){
+			case WriteTask::child:
+				if (!t.n->isLeaf() && t.n->getInEdgeRange().size() > 1){
+					// shared subdiagrams are written once (behind the main part), leaf nodes are cheap enough to be repeated
+					int index = dd.getNodeIndex(t.n);
+					if (!format.sharedNodeQueued[index]){
+						format.sharedNodeQueued[index] = true;
+						format.sharedNodes.push_back(t.n);
+					}
+					out << tabs << "goto node_" << index << ";" << std::endl;
+				}else{
+					enterNode(t, children);
+				}
+				break;
+			case WriteTask::node:
+				enterNode(t, children);
+				break;
+			case WriteTask::branch:
+				{
+					DecisionDiagram::Condition c = t.e->getCondition();
+					const char* op = "";
+					switch (c.getNormalizedOperation()){
+						case DecisionDiagram::Condition::lt: op = "<"; break;
+						case DecisionDiagram::Condition::le: op = "<="; break;
+						case DecisionDiagram::Condition::eq: op = "=="; break;
+						case DecisionDiagram::Condition::ge: op = ">="; break;
+						case DecisionDiagram::Condition::gt: op = ">"; break;
+						default: break;
+					}
+					out << tabs << "if (row[" << format.attributeIdentifiers[c.getAttribute()] << "] " << op << " thresholds[" << format.thresholds.size() << "]){" << std::endl;
+					format.thresholds.push_back(c.getCmpValue());
+				}
+				break;
+			case WriteTask::close:
+				out << tabs << "}" << std::endl;
+				break;
+			case WriteTask::noClass:
+				out << tabs << "return NO_CLASS;" << std::endl;
+				break;
+		}
+	}
+
+	virtual bool leave(const WriteTask& t, const std::vector<bool>& childResults){
+		return true;
+	}
+};
+
+/**
+ * Writes the statements which classify a row that reached a certain node
+ * \param out The stream to write to
+ * \param dd The decision diagram
+ * \param node A node of dd
+ * \param indent The number of tabs in front of each statement
+ */
+void CppFormat::writeNode(std::ostream& out, const DecisionDiagram& dd, const DecisionDiagram::Node* node, int indent){
+	Writer writer(*this, out, dd);
+	writer.run(WriteTask(WriteTask::node, node, NULL, indent));
+}
@@ -13,6 +13,8 @@
 #include <AsFormat.h>
 #include <HexFormat.h>
 #include <RmxmlFormat.h>
+#include <CppFormat.h>
+#include <BinFormat.h>
 
 using namespace dlvhex;
 using namespace dlvhex::dd::tools::graphconverter;
@@ -24,6 +26,8 @@ vector<IFormat*> loadFormats(){
 	formats.push_back(new HexFormat());
 	formats.push_back(new AsFormat());
 	formats.push_back(new RmxmlFormat());
+	formats.push_back(new CppFormat());
+	formats.push_back(new BinFormat());
 	return formats;
 }
 
@@ -84,6 +88,10 @@ void showHelp(){
 			<<	"                     (see http://www.graphviz.org)" << std::endl << std::endl
 			<<	" rmxml or            decision tree in xml format as used by" << std::endl << std::endl
 			<<	"     xml             RapidMiner (http://www.rapidminer.com)" << std::endl << std::endl
+			<<	" cpp                 C++ header with a function that classifies" << std::endl
+			<<	"                     data rows (output only; numeric conditions only)" << std::endl << std::endl
+			<<	" binary or           Versioned binary format which can be memory-" << std::endl
+			<<	"     bin             mapped (see DecisionDiagramFile)" << std::endl << std::endl
 			<<	"If the program is called with --todot, the source will be \"hex\"" << std::endl
 			<<	"and the destination \"dot\"." << std::endl
 			<<	"If the program is called with --toas, the source will be \"dot\"" << std::endl
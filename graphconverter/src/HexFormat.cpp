@@ -1,9 +1,9 @@
 #include <HexFormat.h>
 #include <StringHelper.h>
+#include <DecisionDiagramSinks.h>
 
 #include <dlvhex/HexParserDriver.h>
 #include <dlvhex/DLVresultParserDriver.h>
-#include <dlvhex/PrintVisitor.h>
 #include <dlvhex/Program.h>
 
 #include <iostream>
@@ -52,9 +52,7 @@ std::vector<DecisionDiagram*> HexFormat::read() throw (DecisionDiagram::InvalidD
 void HexFormat::write(std::vector<DecisionDiagram*> ddv) throw (DecisionDiagram::InvalidDecisionDiagram){
 	if (ddv.size() != 1) throw DecisionDiagram::InvalidDecisionDiagram("Error: Hex-writer can only write one diagram at one time.");
 
-	// create an answer-set
-	AtomSet as = ddv[0]->toAnswerSet();
-	// print it as dlv program
-	DLVPrintVisitor pv(std::cout);
-	pv.visit(&as);
+	// print the diagram as dlv program (without building an answer-set first)
+	DlvFactSink sink(std::cout);
+	ddv[0]->emit(sink);
 }
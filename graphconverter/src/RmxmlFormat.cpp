@@ -91,24 +91,83 @@ TiXmlDocument RmxmlFormat::getXmlDiag(DecisionDiagram* dd){
 	return doc;
 }
 
-// writes xml code for a decision diagram
-TiXmlElement RmxmlFormat::getXmlDiag(DecisionDiagram* dd, DecisionDiagram::Node* ddnode, int& id){
+namespace{
+	// a node which is written by getXmlDiag, together with the place where its element is inserted
+	struct XmlTask{
+		XmlTask(DecisionDiagram::Node* node_, DecisionDiagram::Edge* inEdge_, TiXmlNode* target_) : node(node_), inEdge(inEdge_), target(target_){
+		}
 
-	// add current element
-	TiXmlElement* newElement;
-	TiXmlElement root("root");
-	TiXmlElement child("child");
-	newElement = ddnode == dd->getRoot() ? &root : &child;
-	newElement->SetAttribute("id", ++id);
-
-	// inner node or leaf node?
-	if (dynamic_cast<DecisionDiagram::LeafNode*>(ddnode) != NULL){
-		// leaf node
-		return getXmlLeaf(dd, ddnode, id);
-	}else{
-		// inner node
-		return getXmlInner(dd, ddnode, id);
+		DecisionDiagram::Node* node;
+		DecisionDiagram::Edge* inEdge;	// the edge from the parent node (NULL for the node the output starts with)
+		TiXmlNode* target;		// the element which receives the edge (or the node itself if there is no in-edge)
+	};
+}
+
+// writes the nodes top-down (pre-order); the element of each node is inserted in place, such that no subtrees need to be copied
+class RmxmlFormat::XmlWriting : public DecisionDiagram::Traversal<XmlTask, bool>{
+private:
+	RmxmlFormat& format;
+	DecisionDiagram* dd;
+	int& id;
+public:
+	XmlWriting(RmxmlFormat& format_, DecisionDiagram* dd_, int& id_) : format(format_), dd(dd_), id(id_){
 	}
+
+	virtual void enter(XmlTask& t, std::vector<XmlTask>& children){
+		TiXmlNode* parent = t.target;
+		if (t.inEdge != NULL){
+			// make an edge to this child
+			TiXmlElement edge("com.rapidminer.operator.learner.tree.Edge");
+			edge.SetAttribute("id", ++id);
+
+			// add the condition
+			TiXmlElement condition("condition");
+			condition.SetAttribute("id", ++id);
+			DecisionDiagram::Condition ddcondition = t.inEdge->getCondition();
+			condition.SetAttribute("class", format.getXmlCmpOperation(ddcondition).c_str());
+			TiXmlElement attribute("attributeName");
+			attribute.InsertEndChild(TiXmlText(ddcondition.getAttribute().c_str()));
+			TiXmlElement value("value");
+			value.InsertEndChild(TiXmlText(StringHelper::toString(ddcondition.getCmpValue()).c_str()));
+			condition.InsertEndChild(value);
+			condition.InsertEndChild(attribute);
+
+			// the child itself is added below the condition
+			edge.InsertEndChild(condition);
+			parent = parent->InsertEndChild(edge);
+		}
+
+		// add current element (the id identifies the node when the document is read)
+		int nodeId = ++id;
+
+		// inner node or leaf node?
+		if (t.node->isLeaf()){
+			// leaf node
+			parent->InsertEndChild(format.getXmlLeaf(dd, t.node, id))->ToElement()->SetAttribute("id", nodeId);
+		}else{
+			// inner node: add all children (into the children element)
+			TiXmlElement* element = parent->InsertEndChild(format.getXmlInner(dd, t.node, id))->ToElement();
+			element->SetAttribute("id", nodeId);
+			TiXmlElement* childrenElement = element->FirstChildElement("children");
+			std::set<DecisionDiagram::Edge*> outEdges = t.node->getOutEdges();
+			for (std::set<DecisionDiagram::Edge*>::iterator eit = outEdges.begin(); eit != outEdges.end(); eit++){
+				children.push_back(XmlTask((*eit)->getTo(), *eit, childrenElement));
+			}
+		}
+	}
+
+	virtual bool leave(const XmlTask& t, const std::vector<bool>& childResults){
+		return true;
+	}
+};
+
+// writes xml code for a decision diagram
+TiXmlElement RmxmlFormat::getXmlDiag(DecisionDiagram* dd, DecisionDiagram::Node* ddnode, int& id){
+	// the elements are built within a temporary parent
+	TiXmlElement parent("parent");
+	XmlWriting writing(*this, dd, id);
+	writing.run(XmlTask(ddnode, NULL, &parent));
+	return *parent.FirstChildElement();
 }
 
 // writes xml code for a leaf node
@@ -135,7 +194,7 @@ TiXmlElement RmxmlFormat::getXmlLeaf(DecisionDiagram* dd, DecisionDiagram::Node*
 	//     |   |---<int>
 	//     ...
 
-	DecisionDiagram::LeafNode* leaf = dynamic_cast<DecisionDiagram::LeafNode*>(ddnode);
+	DecisionDiagram::LeafNode* leaf = ddnode->asLeaf();
 
 	// store classification at this leaf node
 	TiXmlElement label("label");
@@ -180,7 +239,7 @@ TiXmlElement RmxmlFormat::getXmlInner(DecisionDiagram* dd, DecisionDiagram::Node
 	//     |   |   |---<attributeName>
 	//     |   |   |---<value>
 	//     |   |
-	//     |   |---<child> (recursive call for this node!)
+	//     |   |---<child> (added by getXmlDiag)
 	//     |
 	//     |---<edge>
 	//     |   |
@@ -189,40 +248,14 @@ TiXmlElement RmxmlFormat::getXmlInner(DecisionDiagram* dd, DecisionDiagram::Node
 	//     |   |   |---<attributeName>
 	//     |   |   |---<value>
 	//     |   |
-	//     |   |---<child> (recursive call for this node!)
+	//     |   |---<child> (added by getXmlDiag)
 	//  	...
 
-	// make node for the children
+	// make node for the children (the edges are added by getXmlDiag)
 	TiXmlElement children("children");
 	children.SetAttribute("class", "linked-list");
 	children.SetAttribute("id", ++id);
 
-	// add all children
-	std::set<DecisionDiagram::Edge*> outEdges = ddnode->getOutEdges();
-	for (std::set<DecisionDiagram::Edge*>::iterator eit = outEdges.begin(); eit != outEdges.end(); eit++){
-
-		// make an edge to this child
-		TiXmlElement edge("com.rapidminer.operator.learner.tree.Edge");
-		edge.SetAttribute("id", ++id);
-
-		// add the condition
-		TiXmlElement condition("condition");
-		condition.SetAttribute("id", ++id);
-		DecisionDiagram::Condition ddcondition = (*eit)->getCondition();
-		condition.SetAttribute("class", getXmlCmpOperation(ddcondition).c_str());
-		TiXmlElement attribute("attributeName");
-		attribute.InsertEndChild(TiXmlText(ddcondition.getAttribute().c_str()));
-		TiXmlElement value("value");
-		value.InsertEndChild(TiXmlText(StringHelper::toString(ddcondition.getCmpValue()).c_str()));
-		condition.InsertEndChild(value);
-		condition.InsertEndChild(attribute);
-
-		// add the child itself (recursively)
-		edge.InsertEndChild(condition);
-		edge.InsertEndChild(getXmlDiag(dd, (*eit)->getTo(), id));
-
-		children.InsertEndChild(edge);
-	}
 	newElement.InsertEndChild(children);
 	return newElement;
 }
@@ -292,8 +325,9 @@ TiXmlElement RmxmlFormat::getXmlNormalAttributeList(DecisionDiagram* dd, Decisio
 	std::set<DecisionDiagram::Edge*> edges = dd->getEdges();
 	for (std::set<DecisionDiagram::Edge*>::iterator edgeIt = edges.begin(); edgeIt != edges.end(); edgeIt++){
 		// only conditional edges contain conditions
-		if (!dynamic_cast<DecisionDiagram::ElseEdge*>(*edgeIt)){
-			attributes.insert((*edgeIt)->getCondition().getAttribute());
+		if (!(*edgeIt)->isElse()){
+			DecisionDiagram::Condition c = (*edgeIt)->getCondition();
+			if (c.hasAttribute()) attributes.insert(c.getAttribute());
 		}
 	}
 
@@ -475,16 +509,15 @@ TiXmlElement RmxmlFormat::getXmlClassificationAttributeList(DecisionDiagram* dd,
 }
 
 std::string RmxmlFormat::getXmlCmpOperation(DecisionDiagram::Condition c){
-	// Check if the first or the second operand is the attribute
-	std::string attribute = c.getAttribute();
-	bool negate = false;
-	if (c.getOperand1() == attribute){
-		// just take the comparison operator as it is
-	}else{
-		// negate the comparision operator since the arguments will be swapped
-		negate = true;
+	// rmxml requires an attribute to be compared with a numeric value
+	if (c.getOperation() != DecisionDiagram::Condition::else_){
+		if (!c.hasAttribute()) throw DecisionDiagram::InvalidDecisionDiagram(std::string("None of the operands in condition \"") + c.toString() + "\" is an attribute (both are numbers)");
+		if (!c.hasCmpValue()) throw DecisionDiagram::InvalidDecisionDiagram(std::string("None of the operands in condition \"") + c.toString() + "\" is a float value");
 	}
 
+	// Check if the first or the second operand is the attribute: negate the comparision operator if the arguments will be swapped
+	bool negate = !c.isAttributeLeft();
+
 	// translate the comparison operator
 	switch (c.getOperation()){
 		case DecisionDiagram::Condition::lt: return negate ? "com.rapidminer.operator.learner.tree.GreaterSplitCondition" : "com.rapidminer.operator.learner.tree.LessSplitCondition";
@@ -514,93 +547,128 @@ DecisionDiagram RmxmlFormat::getDDDiag(TiXmlDocument* ce){
 	}
 }
 
-// translates a node-element into a DD-node
-DecisionDiagram::Node* RmxmlFormat::getDDnode(DecisionDiagram* dd, TiXmlElement* elem){
-
-	// enumerate children
-	if (!elem->FirstChild("label")){
-		// inner node
-
-		// <root>/<child>
-		// |
-		// |---<children>
-		//     |
-		//     |---<edge>
-		//     |   |
-		//     |   |---<condition>
-		//     |   |   |
-		//     |   |   |---<attributeName>
-		//     |   |   |---<value>
-		//     |   |
-		//     |   |---<child> (recursive call for this node!)
-		//     |
-		//     |---<edge>
-		//     |   |
-		//     |   |---<condition>
-		//     |   |   |
-		//     |   |   |---<attributeName>
-		//     |   |   |---<value>
-		//     |   |
-		//     |   |---<child> (recursive call for this node!)
-		//  	...
-
-		// create inner node
-		DecisionDiagram::Node* node = dd->addNode(std::string("node") + std::string(elem->Attribute("id")));
-
-		// subnodes
-		TiXmlElement* child = elem->FirstChild("children")->FirstChild() ? elem->FirstChild("children")->FirstChild()->ToElement() : NULL;
-		while (child){
-			// read condition
-			TiXmlElement* condition = child->FirstChild("condition")->ToElement();
-			// read and create subnode
-			DecisionDiagram::Node* subnode = getDDnode(dd, child->FirstChild("child")->ToElement());
-
-			// connect the nodes using the given condition
-			getDDedge(dd, node, subnode, condition);
-
-			// goto next child
-			child = child->NextSibling() ? child->NextSibling()->ToElement() : NULL;
+namespace{
+	// an element which is read by getDDnode, together with the node which is created for it
+	struct XmlReadTask{
+		XmlReadTask(TiXmlElement* elem_) : elem(elem_), node(NULL){
 		}
 
-		return node;
-	}else{
-		// leaf node
-
-		// <root>/<child>
-		// |
-		// |---<label>
-		// |---<children/>
-		// |---<counterMap>
-		// |---<counterMap>
-		//     |
-		//     |---<entry>
-		//     |   |
-		//     |   |---<string>
-		//     |   |---<int>
-		//     |
-		//     |---<entry>
-		//     |   |
-		//     |   |---<string>
-		//     |   |---<int>
-		//     ...
-
-		// extract label
-		std::string label = elem->FirstChild("label")->ToElement()->GetText();
-
-		// extract distribution map
-		TiXmlElement* entry = elem->FirstChild("counterMap")->FirstChild() ? elem->FirstChild("counterMap")->FirstChild()->ToElement() : NULL;
-		std::stringstream map;
-		bool first = true;
-		while (entry){
-			map << (first ? "" : ",") << entry->FirstChild("string")->ToElement()->GetText() << ":" << entry->FirstChild("int")->ToElement()->GetText();
-			entry = entry->NextSibling() ? entry->NextSibling()->ToElement() : NULL;
-			first = false;
+		TiXmlElement* elem;
+		DecisionDiagram::Node* node;
+	};
+}
+
+// creates the nodes top-down (in document order) and connects them bottom-up, such that deep trees do not exhaust the call stack
+class RmxmlFormat::XmlReading : public DecisionDiagram::Traversal<XmlReadTask, DecisionDiagram::Node*>{
+private:
+	RmxmlFormat& format;
+	DecisionDiagram* dd;
+
+	// returns the first element of a node (or NULL)
+	static TiXmlElement* firstElement(TiXmlNode* parent){
+		return parent->FirstChild() ? parent->FirstChild()->ToElement() : NULL;
+	}
+
+	// returns the next sibling element (or NULL)
+	static TiXmlElement* nextElement(TiXmlElement* elem){
+		return elem->NextSibling() ? elem->NextSibling()->ToElement() : NULL;
+	}
+
+public:
+	XmlReading(RmxmlFormat& format_, DecisionDiagram* dd_) : format(format_), dd(dd_){
+	}
+
+	virtual void enter(XmlReadTask& t, std::vector<XmlReadTask>& children){
+		TiXmlElement* elem = t.elem;
+
+		// enumerate children
+		if (!elem->FirstChild("label")){
+			// inner node
+
+			// <root>/<child>
+			// |
+			// |---<children>
+			//     |
+			//     |---<edge>
+			//     |   |
+			//     |   |---<condition>
+			//     |   |   |
+			//     |   |   |---<attributeName>
+			//     |   |   |---<value>
+			//     |   |
+			//     |   |---<child> (read below this node)
+			//     |
+			//     |---<edge>
+			//     |   |
+			//     |   |---<condition>
+			//     |   |   |
+			//     |   |   |---<attributeName>
+			//     |   |   |---<value>
+			//     |   |
+			//     |   |---<child> (read below this node)
+			//  	...
+
+			// create inner node
+			t.node = dd->addNode(std::string("node") + std::string(elem->Attribute("id")));
+
+			// subnodes (the edges are inserted after the subnodes were read, see leave)
+			for (TiXmlElement* child = firstElement(elem->FirstChild("children")); child; child = nextElement(child)){
+				children.push_back(XmlReadTask(child->FirstChild("child")->ToElement()));
+			}
+		}else{
+			// leaf node
+
+			// <root>/<child>
+			// |
+			// |---<label>
+			// |---<children/>
+			// |---<counterMap>
+			// |---<counterMap>
+			//     |
+			//     |---<entry>
+			//     |   |
+			//     |   |---<string>
+			//     |   |---<int>
+			//     |
+			//     |---<entry>
+			//     |   |
+			//     |   |---<string>
+			//     |   |---<int>
+			//     ...
+
+			// extract label
+			std::string label = elem->FirstChild("label")->ToElement()->GetText();
+
+			// extract distribution map
+			TiXmlElement* entry = elem->FirstChild("counterMap")->FirstChild() ? elem->FirstChild("counterMap")->FirstChild()->ToElement() : NULL;
+			std::stringstream map;
+			bool first = true;
+			while (entry){
+				map << (first ? "" : ",") << entry->FirstChild("string")->ToElement()->GetText() << ":" << entry->FirstChild("int")->ToElement()->GetText();
+				entry = entry->NextSibling() ? entry->NextSibling()->ToElement() : NULL;
+				first = false;
+			}
+			// node label is the class plus the distribution
+			label = label + std::string(" {") + map.str() + std::string("}");
+
+			t.node = dd->addLeafNode(std::string("node") + std::string(elem->Attribute("id")), label);
 		}
-		// node label is the class plus the distribution
-		label = label + std::string(" {") + map.str() + std::string("}");
+	}
 
-		return dd->addLeafNode(std::string("node") + std::string(elem->Attribute("id")), label);
+	virtual DecisionDiagram::Node* leave(const XmlReadTask& t, const std::vector<DecisionDiagram::Node*>& subnodes){
+		// connect the nodes using the conditions of the edge elements
+		int i = 0;
+		for (TiXmlElement* child = t.node->isLeaf() ? NULL : firstElement(t.elem->FirstChild("children")); child; child = nextElement(child)){
+			format.getDDedge(dd, t.node, subnodes[i++], child->FirstChild("condition")->ToElement());
+		}
+		return t.node;
 	}
+};
+
+// translates a node-element into a DD-node
+DecisionDiagram::Node* RmxmlFormat::getDDnode(DecisionDiagram* dd, TiXmlElement* elem){
+	XmlReading reading(*this, dd);
+	return reading.run(XmlReadTask(elem));
 }
 
 // Translates an edge-element into a DD-edge
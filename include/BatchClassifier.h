@@ -0,0 +1,191 @@
+#ifndef _BATCHCLASSIFIER_H_
+#define _BATCHCLASSIFIER_H_
+
+#include <DecisionDiagram.h>
+#include <SymbolTable.h>
+
+#include <boost/cstdint.hpp>
+#include <boost/unordered_map.hpp>
+
+#include <string>
+#include <vector>
+
+namespace dlvhex{
+	namespace dd{
+		namespace util{
+
+			/**
+			 * \brief
+			 * Classifies batches of data rows with a decision diagram.
+			 * The diagram is compiled once into flat arrays (nodes in topological order, conditions with pre-parsed numeric thresholds and normalized operators, see Condition::getNormalizedOperation).
+			 * A batch is evaluated breadth-first: each node receives the list of row indices which reached it and splits it among its outgoing edges, such that each node is visited
+			 * once per batch rather than once per row. The conditional edges of a node are tested in the order of insertion (see Node::getOutEdgeRange), the first satisfied condition wins;
+			 * rows which do not satisfy any condition follow the else edge. Rows which reach an inner node without a matching edge remain unclassified.
+			 */
+			class BatchClassifier{
+			public:
+				typedef boost::uint32_t Row;
+
+				/**
+				 * \brief Is thrown if a batch does not match the diagram (e.g. a column is missing or has the wrong length).
+				 */
+				class InvalidBatch{
+				private:
+					std::string msg;
+				public:
+					InvalidBatch(std::string msg);
+					std::string getMessage();
+				};
+
+				/**
+				 * \brief
+				 * A column-major batch of attribute values. Each column is identified by an attribute name (as used in the conditions of the diagram) and contains one value per row.
+				 * Numeric columns are compared with numeric thresholds, symbolic columns are compared with non-numeric operands (equality of symbols or lexical order) and, if the
+				 * value is a number, also with numeric thresholds. Missing numeric values can be represented as NaN; they do not satisfy any condition.
+				 * The values of symbolic columns are stored in a dictionary of the batch rather than in the SymbolTable, such that their memory is released with the batch.
+				 */
+				class Batch{
+				public:
+					typedef boost::uint32_t ValueId;
+
+					/**
+					 * \brief A distinct value of the symbolic columns of a batch; the string is parsed once.
+					 */
+					struct Value{
+						const std::string* str;
+						bool numeric;			// true iff str is a number
+						double number;			// the numeric value of str (0 if it is no number)
+					};
+
+				private:
+					int rowCount;
+					boost::unordered_map<SymbolTable::Id, std::vector<double> > numericColumns;
+					boost::unordered_map<SymbolTable::Id, std::vector<ValueId> > symbolicColumns;
+
+					// Batch-local dictionary of the values of symbolic columns (the strings are the keys of the index, whose addresses are stable)
+					boost::unordered_map<std::string, ValueId> valueIndex;
+					std::vector<Value> values;
+					ValueId addValue(const std::string& str);
+				public:
+					Batch(int rowCount_);
+
+					void addColumn(const std::string& attribute, const std::vector<double>& values);
+					void addColumn(const std::string& attribute, const std::vector<std::string>& values);
+					int getRowCount() const;
+					int getValueCount() const;
+					const std::vector<double>* getNumericColumn(SymbolTable::Id attribute) const;
+					const std::vector<ValueId>* getSymbolicColumn(SymbolTable::Id attribute) const;
+					const Value& getValue(ValueId v) const;
+				};
+
+			private:
+				// A conditional edge in compiled form
+				struct CompiledEdge{
+					SymbolTable::Id attribute;		// empty if the condition does not refer to an attribute (it is constant then)
+					DecisionDiagram::Condition::CmpOp operation;	// normalized, i.e. the attribute is the left operand
+					bool numeric;				// true iff the attribute is compared with a number
+					double threshold;			// the number (numeric conditions)
+					SymbolTable::Id value;			// the non-numeric operand (symbolic conditions)
+					bool constantValue;			// the outcome of constant conditions
+					int child;
+				};
+
+				// A node in compiled form; nodes are stored in topological order
+				struct CompiledNode{
+					bool leaf;
+					SymbolTable::Id classification;
+					int edgesBegin, edgesEnd;		// conditional out-edges in the order of insertion
+					int elseChild;				// -1 if the node has no else edge
+				};
+
+				// Marks batch values which are not in the SymbolTable (thus they are not equal to any operand of the diagram)
+				static const SymbolTable::Id noSymbol = 0xFFFFFFFF;
+
+				std::vector<CompiledNode> nodes;
+				std::vector<CompiledEdge> edges;
+				int root;
+
+				static bool compareSymbols(const Batch::Value& v, SymbolTable::Id symbol, DecisionDiagram::Condition::CmpOp op, SymbolTable::Id operand);
+				static bool compareNumbers(double v, DecisionDiagram::Condition::CmpOp op, double operand);
+				void split(const CompiledEdge& e, const Batch& batch, const std::vector<SymbolTable::Id>& symbols, std::vector<Row>& rows, std::vector<Row>& matched) const;
+			public:
+				BatchClassifier(const DecisionDiagram& dd);
+
+				void classify(const Batch& batch, std::vector<SymbolTable::Id>& classifications) const;
+			};
+		}
+	}
+}
+
+#endif
+
+
+/*! \fn dlvhex::dd::util::BatchClassifier::InvalidBatch::InvalidBatch(std::string msg)
+ * Constructs a new exception with a certain error message.
+ *  \param msg The error message to use
+ */
+
+/*! \fn std::string dlvhex::dd::util::BatchClassifier::InvalidBatch::getMessage()
+ * Retrieves the error message of this exception.
+ *  \return std::string The error message of this exception
+ */
+
+/*! \fn dlvhex::dd::util::BatchClassifier::Batch::Batch(int rowCount_)
+ * Creates an empty batch (without columns) for a certain number of rows.
+ *  \param rowCount_ The number of rows
+ */
+
+/*! \fn void dlvhex::dd::util::BatchClassifier::Batch::addColumn(const std::string& attribute, const std::vector<double>& values)
+ * Adds a numeric column. A column with the same name is replaced.
+ *  \param attribute The attribute name
+ *  \param values One value per row
+ *  \throws InvalidBatch If the number of values does not match the number of rows
+ */
+
+/*! \fn void dlvhex::dd::util::BatchClassifier::Batch::addColumn(const std::string& attribute, const std::vector<std::string>& values)
+ * Adds a symbolic column. The values are stored in the dictionary of the batch (see getValue), where each distinct value is parsed once. A column with the same name is replaced.
+ *  \param attribute The attribute name
+ *  \param values One value per row
+ *  \throws InvalidBatch If the number of values does not match the number of rows
+ */
+
+/*! \fn int dlvhex::dd::util::BatchClassifier::Batch::getRowCount() const
+ * Returns the number of rows of this batch.
+ *  \return int The number of rows
+ */
+
+/*! \fn int dlvhex::dd::util::BatchClassifier::Batch::getValueCount() const
+ * Returns the number of distinct values of the symbolic columns of this batch. The value ids are 0 to getValueCount() - 1.
+ *  \return int The number of distinct values
+ */
+
+/*! \fn const std::vector<double>* dlvhex::dd::util::BatchClassifier::Batch::getNumericColumn(SymbolTable::Id attribute) const
+ * Retrieves a numeric column.
+ *  \param attribute The attribute name (interned)
+ *  \return const std::vector<double>* The column or NULL if there is no numeric column with this name
+ */
+
+/*! \fn const std::vector<ValueId>* dlvhex::dd::util::BatchClassifier::Batch::getSymbolicColumn(SymbolTable::Id attribute) const
+ * Retrieves a symbolic column.
+ *  \param attribute The attribute name (interned)
+ *  \return const std::vector<ValueId>* The column (see getValue) or NULL if there is no symbolic column with this name
+ */
+
+/*! \fn const Value& dlvhex::dd::util::BatchClassifier::Batch::getValue(ValueId v) const
+ * Retrieves a value of the symbolic columns of this batch.
+ *  \param v A value id of a symbolic column
+ *  \return const Value& The value (valid as long as the batch exists)
+ */
+
+/*! \fn dlvhex::dd::util::BatchClassifier::BatchClassifier(const DecisionDiagram& dd)
+ * Compiles a decision diagram for classification. Since the classifier is independent of the diagram, the diagram may be modified or destroyed afterwards.
+ *  \param dd A decision diagram
+ *  \throws InvalidDecisionDiagram If the diagram has no root or contains cycles
+ */
+
+/*! \fn void dlvhex::dd::util::BatchClassifier::classify(const Batch& batch, std::vector<SymbolTable::Id>& classifications) const
+ * Classifies all rows of a batch. The values of symbolic columns are looked up in the SymbolTable on each call, thus the batch may be built before the diagram.
+ *  \param batch The data rows
+ *  \param classifications Receives the classification of each row (see SymbolTable::lookup); rows which do not reach a leaf node are classified as SymbolTable::empty (the empty string)
+ *  \throws InvalidBatch If the batch does not contain a column for an attribute which is tested on the way of a row
+ */
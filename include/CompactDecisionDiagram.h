@@ -0,0 +1,278 @@
+#ifndef _COMPACTDECISIONDIAGRAM_H_
+#define _COMPACTDECISIONDIAGRAM_H_
+
+#include <DecisionDiagram.h>
+#include <SymbolTable.h>
+#include <boost/cstdint.hpp>
+#include <boost/unordered_map.hpp>
+#include <vector>
+#include <set>
+#include <string>
+
+namespace dlvhex{
+	namespace dd{
+		namespace util{
+
+			/**
+			 * \brief
+			 * An immutable, compact snapshot of a DecisionDiagram for read-only passes.
+			 * The snapshot is built in one pass from a DecisionDiagram. Nodes are numbered by 32-bit ids (depth-first from the root, such that subdiagrams are stored contiguously),
+			 * the outgoing edges of all nodes are stored in compressed sparse row (CSR) format, i.e. the out-edges of node i are the edges with ids edgeOffsets[i] to edgeOffsets[i + 1] - 1.
+			 * Labels, classifications and condition operands are stored as symbols of the global SymbolTable; conditions are stored as packed records of symbols.
+			 * Since the snapshot is independent of the diagram it was built from, the original diagram may be modified or destroyed afterwards.
+			 */
+			class CompactDecisionDiagram{
+			public:
+				typedef boost::uint32_t NodeId;
+				typedef boost::uint32_t EdgeId;
+				typedef SymbolTable::Id StringId;
+
+				// Marks a non-existing node (e.g. the root of an empty diagram) or string (e.g. the classification of an inner node)
+				static const boost::uint32_t none = 0xFFFFFFFF;
+
+			private:
+				// A condition in packed form: both operands are symbols
+				struct PackedCondition{
+					StringId operand1;
+					StringId operand2;
+					boost::uint8_t operation;
+				};
+
+				std::vector<StringId> labels;			// label of each node
+				std::vector<StringId> classifications;		// classification of each node (none for inner nodes)
+				std::vector<EdgeId> edgeOffsets;		// CSR offsets (one entry per node plus one)
+				std::vector<NodeId> edgeTargets;		// destination node of each edge
+				std::vector<PackedCondition> conditions;	// condition of each edge
+				std::vector<boost::uint32_t> inDegrees;		// number of ingoing edges of each node
+				NodeId root;
+				int sharedNodes;				// number of nodes with more than one ingoing edge
+
+				boost::unordered_map<StringId, NodeId> labelIndex;
+
+			public:
+				CompactDecisionDiagram(const DecisionDiagram& dd);
+
+				// Getter
+				int nodeCount() const;
+				int edgeCount() const;
+				int leafCount() const;
+				NodeId getRoot() const;
+				NodeId getNodeByLabel(const std::string& label) const;
+				const std::string& getLabel(NodeId n) const;
+				StringId getLabelSymbol(NodeId n) const;
+				bool isLeaf(NodeId n) const;
+				const std::string& getClassification(NodeId n) const;
+				StringId getClassificationSymbol(NodeId n) const;
+				int getInDegree(NodeId n) const;
+				int getOutDegree(NodeId n) const;
+				EdgeId getOutEdgesBegin(NodeId n) const;
+				EdgeId getOutEdgesEnd(NodeId n) const;
+				NodeId getChild(NodeId n, int index) const;
+				NodeId getTo(EdgeId e) const;
+				DecisionDiagram::Condition::CmpOp getOperation(EdgeId e) const;
+				const std::string& getOperand1(EdgeId e) const;
+				const std::string& getOperand2(EdgeId e) const;
+				StringId getOperand1Symbol(EdgeId e) const;
+				StringId getOperand2Symbol(EdgeId e) const;
+				DecisionDiagram::Condition getCondition(EdgeId e) const;
+
+				// Traversal
+				std::vector<NodeId> containsCycles() const;
+				bool isTree() const;
+				bool containsPath(NodeId from, NodeId to) const;
+				bool operator==(const CompactDecisionDiagram& dd2) const;
+				bool operator!=(const CompactDecisionDiagram& dd2) const;
+
+				// Conversion
+				void toDecisionDiagram(DecisionDiagram& dd) const;
+				AtomSet toAnswerSet() const;
+				AtomSet toAnswerSet(bool addIndex, int index) const;
+			};
+		}
+	}
+}
+
+#endif
+
+
+/*! \fn dlvhex::dd::util::CompactDecisionDiagram::CompactDecisionDiagram(const DecisionDiagram& dd)
+ * Creates a snapshot of a decision diagram in one pass.
+ * \param dd The decision diagram to take the snapshot from
+ */
+
+/*! \fn int dlvhex::dd::util::CompactDecisionDiagram::nodeCount() const
+ * Returns the number of nodes in this snapshot. Valid node ids are 0 to nodeCount() - 1.
+ *  \return int Number of nodes
+ */
+
+/*! \fn int dlvhex::dd::util::CompactDecisionDiagram::edgeCount() const
+ * Returns the number of edges in this snapshot. Valid edge ids are 0 to edgeCount() - 1.
+ *  \return int Number of edges
+ */
+
+/*! \fn int dlvhex::dd::util::CompactDecisionDiagram::leafCount() const
+ * Returns the number of leaf nodes in this snapshot.
+ *  \return int Number of leaf nodes
+ */
+
+/*! \fn NodeId dlvhex::dd::util::CompactDecisionDiagram::getRoot() const
+ * Returns the id of the root node.
+ *  \return NodeId The id of the root node or CompactDecisionDiagram::none if the diagram has no root
+ */
+
+/*! \fn NodeId dlvhex::dd::util::CompactDecisionDiagram::getNodeByLabel(const std::string& label) const
+ * Looks up a node by it's label.
+ *  \param label The label of the node to retrieve
+ *  \return NodeId The id of the node with the given label
+ *  \throws DecisionDiagram::InvalidDecisionDiagram If there is no node with the given label
+ */
+
+/*! \fn const std::string& dlvhex::dd::util::CompactDecisionDiagram::getLabel(NodeId n) const
+ * Returns the label of a node.
+ *  \param n A node id
+ *  \return const std::string& The label of n
+ */
+
+/*! \fn StringId dlvhex::dd::util::CompactDecisionDiagram::getLabelSymbol(NodeId n) const
+ * Returns the label of a node as symbol.
+ *  \param n A node id
+ *  \return StringId The symbol id of the label of n
+ */
+
+/*! \fn bool dlvhex::dd::util::CompactDecisionDiagram::isLeaf(NodeId n) const
+ * Checks if a node is a leaf node.
+ *  \param n A node id
+ *  \return bool True iff n is a leaf node
+ */
+
+/*! \fn const std::string& dlvhex::dd::util::CompactDecisionDiagram::getClassification(NodeId n) const
+ * Returns the classification of a leaf node.
+ *  \param n The id of a leaf node
+ *  \return const std::string& The classification of n (empty for inner nodes)
+ */
+
+/*! \fn StringId dlvhex::dd::util::CompactDecisionDiagram::getClassificationSymbol(NodeId n) const
+ * Returns the classification of a leaf node as symbol.
+ *  \param n The id of a leaf node
+ *  \return StringId The symbol id of the classification of n (SymbolTable::empty for inner nodes)
+ */
+
+/*! \fn int dlvhex::dd::util::CompactDecisionDiagram::getInDegree(NodeId n) const
+ * Returns the number of ingoing edges of a node.
+ *  \param n A node id
+ *  \return int The number of ingoing edges of n
+ */
+
+/*! \fn int dlvhex::dd::util::CompactDecisionDiagram::getOutDegree(NodeId n) const
+ * Returns the number of outgoing edges of a node.
+ *  \param n A node id
+ *  \return int The number of outgoing edges of n
+ */
+
+/*! \fn EdgeId dlvhex::dd::util::CompactDecisionDiagram::getOutEdgesBegin(NodeId n) const
+ * Returns the id of the first outgoing edge of a node. The outgoing edges of n have the ids getOutEdgesBegin(n) to getOutEdgesEnd(n) - 1.
+ *  \param n A node id
+ *  \return EdgeId The id of the first outgoing edge of n
+ */
+
+/*! \fn EdgeId dlvhex::dd::util::CompactDecisionDiagram::getOutEdgesEnd(NodeId n) const
+ * Returns the id behind the last outgoing edge of a node. The outgoing edges of n have the ids getOutEdgesBegin(n) to getOutEdgesEnd(n) - 1.
+ *  \param n A node id
+ *  \return EdgeId The id behind the last outgoing edge of n
+ */
+
+/*! \fn NodeId dlvhex::dd::util::CompactDecisionDiagram::getChild(NodeId n, int index) const
+ * Returns the child of a node with a certain index.
+ *  \param n A node id
+ *  \param index The 0-based index of the child
+ *  \return NodeId The id of the child
+ *  \throws DecisionDiagram::InvalidDecisionDiagram If the index is out of bounds
+ */
+
+/*! \fn NodeId dlvhex::dd::util::CompactDecisionDiagram::getTo(EdgeId e) const
+ * Returns the destination node of an edge.
+ *  \param e An edge id
+ *  \return NodeId The id of the destination node of e
+ */
+
+/*! \fn DecisionDiagram::Condition::CmpOp dlvhex::dd::util::CompactDecisionDiagram::getOperation(EdgeId e) const
+ * Returns the comparison operator of an edge (DecisionDiagram::Condition::else_ for else edges).
+ *  \param e An edge id
+ *  \return DecisionDiagram::Condition::CmpOp The comparison operator of e
+ */
+
+/*! \fn const std::string& dlvhex::dd::util::CompactDecisionDiagram::getOperand1(EdgeId e) const
+ * Returns the first operand of the condition of an edge.
+ *  \param e An edge id
+ *  \return const std::string& The first operand of the condition of e
+ */
+
+/*! \fn const std::string& dlvhex::dd::util::CompactDecisionDiagram::getOperand2(EdgeId e) const
+ * Returns the second operand of the condition of an edge.
+ *  \param e An edge id
+ *  \return const std::string& The second operand of the condition of e
+ */
+
+/*! \fn StringId dlvhex::dd::util::CompactDecisionDiagram::getOperand1Symbol(EdgeId e) const
+ * Returns the first operand of the condition of an edge as symbol.
+ *  \param e An edge id
+ *  \return StringId The symbol id of the first operand of the condition of e
+ */
+
+/*! \fn StringId dlvhex::dd::util::CompactDecisionDiagram::getOperand2Symbol(EdgeId e) const
+ * Returns the second operand of the condition of an edge as symbol.
+ *  \param e An edge id
+ *  \return StringId The symbol id of the second operand of the condition of e
+ */
+
+/*! \fn DecisionDiagram::Condition dlvhex::dd::util::CompactDecisionDiagram::getCondition(EdgeId e) const
+ * Unpacks the condition of an edge.
+ *  \param e An edge id
+ *  \return DecisionDiagram::Condition The condition of e
+ */
+
+/*! \fn std::vector<NodeId> dlvhex::dd::util::CompactDecisionDiagram::containsCycles() const
+ * Checks if the diagram contains a cycle (see DecisionDiagram::containsCycles).
+ *  \return std::vector<NodeId> Will be empty if the diagram contains no cycle. Otherwise, the result will be the list of nodes building a cycle.
+ */
+
+/*! \fn bool dlvhex::dd::util::CompactDecisionDiagram::isTree() const
+ * Checks if this diagram is a tree. Answered in constant time since the in-degrees are computed during construction.
+ *  \return bool True iff no node has more than one ingoing edge
+ */
+
+/*! \fn bool dlvhex::dd::util::CompactDecisionDiagram::containsPath(NodeId from, NodeId to) const
+ * Checks if there is a path from a certain node to a certain other one. Each node is visited at most once.
+ *  \param from The start node
+ *  \param to The destination node
+ *  \return bool True iff there is a path from "from" to "to"
+ */
+
+/*! \fn bool dlvhex::dd::util::CompactDecisionDiagram::operator==(const CompactDecisionDiagram& dd2) const
+ * Compares this diagram with another one _semantically_ (see DecisionDiagram::operator==). Pairs of nodes which were already found to be equivalent are not compared again.
+ *  \param dd2 The diagram to compare with
+ *  \return bool True iff the diagrams are semantically equivalent
+ */
+
+/*! \fn bool dlvhex::dd::util::CompactDecisionDiagram::operator!=(const CompactDecisionDiagram& dd2) const
+ * Compares this diagram with another one _semantically_ (see DecisionDiagram::operator==).
+ *  \param dd2 The diagram to compare with
+ *  \return bool True iff the diagrams are not semantically equivalent
+ */
+
+/*! \fn void dlvhex::dd::util::CompactDecisionDiagram::toDecisionDiagram(DecisionDiagram& dd) const
+ * Converts this snapshot back into a mutable decision diagram.
+ *  \param dd The decision diagram to fill. It is cleared first.
+ */
+
+/*! \fn AtomSet dlvhex::dd::util::CompactDecisionDiagram::toAnswerSet() const
+ * Creates an answer set representing this diagram (see DecisionDiagram::toAnswerSet).
+ *  \return AtomSet An answer set representing this diagram
+ */
+
+/*! \fn AtomSet dlvhex::dd::util::CompactDecisionDiagram::toAnswerSet(bool addIndex, int index) const
+ * Creates an answer set representing this diagram (see DecisionDiagram::toAnswerSet(bool, int)).
+ *  \param addIndex If true, the atoms will be extended by the given index as an additional parameter at position 0.
+ *  \param index Index to be added to the atoms (ignored if addIndex=false).
+ *  \return AtomSet An answer set representing this diagram
+ */
@@ -2,6 +2,16 @@
 #define __DECISIONDIAGRAM_H_
 
 #include <dlvhex/AtomSet.h>
+#include <MemoryPool.h>
+#include <SmallVector.h>
+#include <SymbolTable.h>
+#include <boost/cstdint.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/range/iterator_range.hpp>
+#include <iterator>
+#include <map>
+#include <ostream>
+#include <utility>
 #include <vector>
 #include <set>
 #include <string>
@@ -40,30 +50,73 @@ namespace dlvhex{
 
 				class Edge;
 
+				/**
+				 * \brief Ranges borrow the internal containers of a decision diagram or node instead of copying them.
+				 *
+				 * Invalidation contract: A range obtained from a Node (getInEdgeRange, getOutEdgeRange) is invalidated by any edge insertion or removal at this node.
+				 * A range obtained from a DecisionDiagram (getNodeRange, getLeafNodeRange, getEdgeRange) stays valid if elements are added, but added elements may or may not be visited;
+				 * removing the element an iterator currently points to invalidates this iterator. Callers which modify the diagram while iterating must take an explicit snapshot
+				 * using the corresponding getter which returns a copy (getNodes, getLeafNodes, getEdges, Node::getInEdges, Node::getOutEdges).
+				 */
+				typedef boost::iterator_range<Edge* const*> EdgeList;
+
 				/**
 				 * \brief A class representing one node of a decision diagram.
 				 */
 				class LeafNode;
 				class Node{
+				public:
+					enum Kind{
+						inner,
+						leaf
+					};
 				private:
-					std::string label;		// This node's label
-					std::set<Edge*> inEdges;	// All the ingoing edges this Node is involved in
-					std::set<Edge*> outEdges;	// All the outgoing edges this Node is involved in
+					Kind kind;			// Inner or leaf node; fixed at construction (allows for type queries without RTTI)
+					SymbolTable::Id label;		// This node's label (interned); for fresh nodes the base label as long as the label is pending
+					bool labelPending;		// True for fresh nodes until their unique label is generated (see DecisionDiagram::addFreshNode)
+					boost::uint32_t id;		// Numeric identity of this node within its diagram (in the order of creation)
+					DecisionDiagram* owner;		// The decision diagram this node belongs to (used to keep its label index up to date)
+					SmallVector<Edge*, 2> inEdges;	// All the ingoing edges this Node is involved in (unordered)
+					SmallVector<Edge*, 4> outEdges;	// All the outgoing edges this Node is involved in (in insertion order)
+
+					// Structural hash of the subdiagram rooted at this node; computed on demand and cached until the subdiagram changes
+					// (invariant: if a node's hash is valid, then the hashes of all its descendants are valid as well)
+					mutable std::size_t structuralHash;
+					mutable bool structuralHashValid;
+
+					// Dense index of this node within its diagram (see DecisionDiagram::getNodeIndex); only valid as long as the diagram's topology cache is valid
+					mutable int topologyIndex;
+
+					// Computes the missing structural hashes of a subdiagram (see getStructuralHash)
+					class Hashing;
+					friend class Hashing;
 
 					// The following methods are only called by members of DecisionDiagram in order to maintain the decision diagram's integrity
 					friend class DecisionDiagram;
-					Node(std::string l);
+					Node(SymbolTable::Id l);
+					Node(SymbolTable::Id l, Kind k);
 					void addEdge(Edge* e);
 					void removeEdge(Edge* e);
+				protected:
+					void invalidateStructuralHash();
+					virtual std::size_t computeStructuralHash() const;
 				public:
 					virtual ~Node();
 
+					bool isLeaf() const{ return kind == leaf; }
+					LeafNode* asLeaf();
+					const LeafNode* asLeaf() const;
+
 					void setLabel(std::string l);
-					std::string getLabel() const;
+					const std::string& getLabel() const;
+					SymbolTable::Id getLabelSymbol() const;
+					boost::uint32_t getId() const;
 
 					std::set<Edge*> getEdges() const;
 					std::set<Edge*> getInEdges() const;
 					std::set<Edge*> getOutEdges() const;
+					EdgeList getInEdgeRange() const;
+					EdgeList getOutEdgeRange() const;
 					int getEdgesCount() const;
 					int getInEdgesCount() const;
 					int getOutEdgesCount() const;
@@ -73,21 +126,43 @@ namespace dlvhex{
 
 					virtual std::string toString() const;
 
+					std::size_t getStructuralHash() const;
 					virtual bool operator==(const Node& n2) const;
 					virtual bool operator==(const LeafNode& n2) const;
 					virtual bool operator!=(const Node& n2) const;
 					virtual bool operator!=(const LeafNode& n2) const;
 				};
 
-				/*! \fn DecisionDiagram::Node::Node(std::string l)
+				/*! \fn DecisionDiagram::Node::Node(SymbolTable::Id l)
 				 *  \brief Construct a new node with a certain label.
-				 *  \param l The label of the node
+				 *  \param l The label of the node (interned)
+				 */
+
+				/*! \fn DecisionDiagram::Node::Node(SymbolTable::Id l, Kind k)
+				 *  \brief Construct a new node with a certain label and kind (used by derived classes).
+				 *  \param l The label of the node (interned)
+				 *  \param k The kind of the node
 				 */
 
 				/*! \fn DecisionDiagram::Node::~Node()
 				 *  \brief Destructor
 				 */
 
+				/*! \fn bool DecisionDiagram::Node::isLeaf() const
+				 *  \brief Checks if this node is a leaf node. Unlike dynamic_cast, this only reads a field of the node.
+				 *  \return bool True iff this node is an instance of LeafNode
+				 */
+
+				/*! \fn LeafNode* DecisionDiagram::Node::asLeaf()
+				 *  \brief Converts this node into a leaf node.
+				 *  \return LeafNode* This node as leaf node or NULL if it is an inner node
+				 */
+
+				/*! \fn const LeafNode* DecisionDiagram::Node::asLeaf() const
+				 *  \brief Converts this node into a leaf node.
+				 *  \return const LeafNode* This node as leaf node or NULL if it is an inner node
+				 */
+
 				/*! \fn void DecisionDiagram::Node::addEdge(Edge* e)
 				 *  \brief Adds a new edge to this node. Note that the edge must be inzident with this node, otherwise an InvalidDecisionDiagram instance will be thrown.
 				 *  \param e The edge to add
@@ -100,14 +175,34 @@ namespace dlvhex{
 				 *  \throws InvalidDecisionDiagram If e was not added to this node.
 				 */
 
+				/*! \fn void DecisionDiagram::Node::invalidateStructuralHash()
+				 *  \brief Marks the cached structural hash of this node and of all its ancestors as invalid. Must be called whenever the subdiagram rooted at this node changes.
+				 */
+
+				/*! \fn std::size_t DecisionDiagram::Node::computeStructuralHash() const
+				 *  \brief Computes the structural hash of this node from the cached hashes of its children, which must be valid (see getStructuralHash). The order of the outgoing edges is irrelevant.
+				 *  \return std::size_t The structural hash
+				 */
+
 				/*! \fn void DecisionDiagram::Node::setLabel(std::string l)
-				 *  \brief Changes the label of this node.
+				 *  \brief Changes the label of this node. The label index of the decision diagram the node belongs to is updated accordingly.
 				 *  \param l The new label of the node
+				 *  \throws InvalidDecisionDiagram If another node of the same decision diagram already uses label l
+				 */
+
+				/*! \fn const std::string& DecisionDiagram::Node::getLabel() const
+				 *  \brief Retrieves the label of this node. If the node is a fresh node whose label is still pending, the labels of all pending nodes of the diagram are generated (see DecisionDiagram::addFreshNode).
+				 *  \return const std::string& The label of the node
+				 */
+
+				/*! \fn SymbolTable::Id DecisionDiagram::Node::getLabelSymbol() const
+				 *  \brief Retrieves the label of this node as symbol. Labels can be compared by comparing their symbols. Pending labels are generated as by getLabel.
+				 *  \return SymbolTable::Id The symbol id of the label of the node
 				 */
 
-				/*! \fn std::string DecisionDiagram::Node::getLabel() const
-				 *  \brief Retrieves the label of this node.
-				 *  \return std::string The label of the node
+				/*! \fn boost::uint32_t DecisionDiagram::Node::getId() const
+				 *  \brief Retrieves the numeric identity of this node. Ids are assigned in the order in which the nodes are added to a diagram and are never reused within that diagram.
+				 *  \return boost::uint32_t The id of the node
 				 */
 
 				/*! \fn std::set<Edge*> DecisionDiagram::LeafNode::getEdges() const
@@ -125,6 +220,16 @@ namespace dlvhex{
 				 *  \return std::set<Edge*> A set of ingoing edges of this node.
 				 */
 
+				/*! \fn EdgeList DecisionDiagram::Node::getInEdgeRange() const
+				 *  \brief Retrieves the ingoing edges of this node without copying them. The range is invalidated by adding or removing edges at this node (see EdgeList).
+				 *  \return EdgeList A range over the ingoing edges of this node.
+				 */
+
+				/*! \fn EdgeList DecisionDiagram::Node::getOutEdgeRange() const
+				 *  \brief Retrieves the outgoing edges of this node (in insertion order) without copying them. The range is invalidated by adding or removing edges at this node (see EdgeList).
+				 *  \return EdgeList A range over the outgoing edges of this node.
+				 */
+
 				/*! \fn int DecisionDiagram::Node::getEdgesCount() const
 				 *  \brief Returns the number of edges inzident with this node.
 				 *  \return int The number of edges inzident with this node.
@@ -146,14 +251,14 @@ namespace dlvhex{
 				 */
 
 				/*! \fn Node* DecisionDiagram::Node::getChild(int index) const
-				 *  \brief Returns a pointer to the child with the given index.
+				 *  \brief Returns a pointer to the child with the given index in constant time. Children are numbered in the order their edges were added.
 				 *  \param index The 0-based index of a child to retrieve.
 				 *  \return Node* A pointer to the child with the given index
 				 *  \throws InvalidDecisionDiagram If the index is out of bounds
 				 */
 
 				/*! \fn Edge* DecisionDiagram::Node::getOutEdge(int index)
-				 *  \brief Returns a pointer to the outgoing edge with the given index.
+				 *  \brief Returns a pointer to the outgoing edge with the given index in constant time. Outgoing edges are numbered in the order they were added.
 				 *  \param index The 0-based index of an outgoing edge to retrieve.
 				 *  \return Edge* A pointer to the outgoing edge with the given index
 				 *  \throws InvalidDecisionDiagram If the index is out of bounds
@@ -164,8 +269,15 @@ namespace dlvhex{
 				 *  \return std::string The string representation of this node.
 				 */
 
+				/*! \fn std::size_t DecisionDiagram::Node::getStructuralHash() const
+				 *  \brief Returns a hash value of the subdiagram rooted at this node, which does not depend on node labels. Semantically equivalent subdiagrams (see operator==) have the same hash.
+				 *  The hash is cached and only recomputed if the subdiagram was changed; missing hashes of descendants are computed bottom-up with an explicit stack.
+				 *  \return std::size_t The structural hash of the subdiagram
+				 */
+
 				/*! \fn virtual bool DecisionDiagram::Node::operator==(const Node& n2) const
 				 * Compares this node with another one _semantically_. Two nodes are equivalent if they encode the same classifier.
+				 * The comparison runs in time linear in the size of the subdiagrams, also if they contain shared nodes.
 				 *  \throws bool True iff the nodes are semantically equivalent.
 				 */
 
@@ -198,36 +310,40 @@ namespace dlvhex{
 						virtual ~Data();	// just to make this type polymorphic
 					};
 				private:
-					std::string classification;
+					SymbolTable::Id classification;	// interned
 					Data* data;
 
 					// The following methods are only called by members of DecisionDiagram in order to maintain the decision diagram's integrity
 					friend class DecisionDiagram;
-					LeafNode(std::string l, std::string c);
-					LeafNode(std::string l, std::string c, Data* d);
+					LeafNode(SymbolTable::Id l, SymbolTable::Id c);
+					LeafNode(SymbolTable::Id l, SymbolTable::Id c, Data* d);
 				public:
 					virtual ~LeafNode();
-					std::string getClassification();
+					const std::string& getClassification() const;
+					SymbolTable::Id getClassificationSymbol() const;
 					Data* getData();
 					void setClassification(std::string c);
 					void setData(Data* d);
 
 					virtual std::string toString() const;
+				protected:
+					virtual std::size_t computeStructuralHash() const;
+				public:
 
 					virtual bool operator==(const Node& n2) const;
 					virtual bool operator==(const LeafNode& n2) const;
 				};
 
-				/*! \fn DecisionDiagram::LeafNode::LeafNode(std::string l, std::string c)
+				/*! \fn DecisionDiagram::LeafNode::LeafNode(SymbolTable::Id l, SymbolTable::Id c)
 				 *  \brief Construct a new leaf node with a certain label and classification.
-				 *  \param l The label of the leaf node
-				 *  \param c The classification of the leaf node
+				 *  \param l The label of the leaf node (interned)
+				 *  \param c The classification of the leaf node (interned)
 				 */
 
-				/*! \fn DecisionDiagram::LeafNode::LeafNode(std::string l, std::string c, Data* d)
+				/*! \fn DecisionDiagram::LeafNode::LeafNode(SymbolTable::Id l, SymbolTable::Id c, Data* d)
 				 *  \brief Construct a new leaf node with a certain label and classification plus an additional data entry.
-				 *  \param l The label of the leaf node
-				 *  \param c The classification of the leaf node
+				 *  \param l The label of the leaf node (interned)
+				 *  \param c The classification of the leaf node (interned)
 				 *  \param d The data field of this leaf node
 				 */
 
@@ -235,9 +351,14 @@ namespace dlvhex{
 				 *  \brief Destructor
 				 */
 
-				/*! \fn std::string DecisionDiagram::LeafNode::getClassification()
+				/*! \fn const std::string& DecisionDiagram::LeafNode::getClassification() const
 				 *  \brief Returns the classification of this leaf node.
-				 *  \return std::string The classification of this leaf node.
+				 *  \return const std::string& The classification of this leaf node.
+				 */
+
+				/*! \fn SymbolTable::Id DecisionDiagram::LeafNode::getClassificationSymbol() const
+				 *  \brief Returns the classification of this leaf node as symbol. Classifications can be compared by comparing their symbols.
+				 *  \return SymbolTable::Id The symbol id of the classification of this leaf node.
 				 */
 
 				/*! \fn Data* DecisionDiagram::LeafNode::getData()
@@ -290,22 +411,41 @@ namespace dlvhex{
 						else_
 					};
 				private:
-					std::string operand1;
-					std::string operand2;
+					SymbolTable::Id operand1;	// interned
+					SymbolTable::Id operand2;	// interned
 					CmpOp operation;
+
+					// Typed form of the condition (derived from the operands once at construction)
+					SymbolTable::Id attribute;	// the alphanumeric operand
+					double cmpValue;		// the numeric operand
+					bool attributeFound;		// false if both operands are numbers (or for else conditions)
+					bool cmpValueFound;		// false if none of the operands is a number (or for else conditions)
+					bool attributeLeft;		// false iff the attribute is the second operand (e.g. "10 > X")
+					void parse();
 				public:
 					Condition(std::string operand1_, std::string operand2_, CmpOp operation_);
 					Condition(std::string operand1_, std::string operand2_, std::string operation_);
+					Condition(SymbolTable::Id operand1_, SymbolTable::Id operand2_, CmpOp operation_);
 
 					virtual ~Condition();
-					std::string getOperand1() const;
-					std::string getOperand2() const;
+					const std::string& getOperand1() const;
+					const std::string& getOperand2() const;
+					SymbolTable::Id getOperand1Symbol() const;
+					SymbolTable::Id getOperand2Symbol() const;
 					CmpOp getOperation() const;
-					std::string getAttribute() const;
-					float getCmpValue() const;
+					bool hasAttribute() const;
+					bool hasCmpValue() const;
+					const std::string& getAttribute() const;
+					SymbolTable::Id getAttributeSymbol() const;
+					double getCmpValue() const;
+					bool isAttributeLeft() const;
+					CmpOp getNormalizedOperation() const;
+					Condition getCanonical() const;
+					std::size_t hash() const;
 
 					static CmpOp stringToCmpOp(std::string operation_);
 					static std::string cmpOpToString(CmpOp op);
+					static CmpOp mirrorCmpOp(CmpOp op);
 
 					virtual std::string toString() const;
 
@@ -328,18 +468,35 @@ namespace dlvhex{
 				 *  \throws InvalidDecisionDiagram If the operation given as string is not a valid comparison operator (<, <=, =, >, >=)
 				 */
 
+				/*! \fn DecisionDiagram::Condition::Condition(SymbolTable::Id operand1_, SymbolTable::Id operand2_, CmpOp operation_)
+				 *  \brief Constructs a condition from operands which are already interned.
+				 *  \param operand1_ Symbol id of the first operand of the range query
+				 *  \param operand2_ Symbol id of the second operand of the range query
+				 *  \param operation_ The comparison operator used in the range query
+				 */
+
 				/*! \fn DecisionDiagram::Condition::~Condition()
 				 *  \brief Destructor
 				 */
 
-				/*! \fn std::string DecisionDiagram::Condition::getOperand1() const
+				/*! \fn const std::string& DecisionDiagram::Condition::getOperand1() const
 				 *  \brief Returns the first operand of the range query.
-				 *  \return std::string The first operand of the range query
+				 *  \return const std::string& The first operand of the range query
 				 */
 
-				/*! \fn std::string DecisionDiagram::Condition::getOperand2() const
+				/*! \fn const std::string& DecisionDiagram::Condition::getOperand2() const
 				 *  \brief Returns the second operand of the range query.
-				 *  \return std::string The second operand of the range query
+				 *  \return const std::string& The second operand of the range query
+				 */
+
+				/*! \fn SymbolTable::Id DecisionDiagram::Condition::getOperand1Symbol() const
+				 *  \brief Returns the first operand of the range query as symbol.
+				 *  \return SymbolTable::Id The symbol id of the first operand
+				 */
+
+				/*! \fn SymbolTable::Id DecisionDiagram::Condition::getOperand2Symbol() const
+				 *  \brief Returns the second operand of the range query as symbol.
+				 *  \return SymbolTable::Id The symbol id of the second operand
 				 */
 
 				/*! \fn CmpOp DecisionDiagram::Condition::getOperation() const
@@ -347,14 +504,49 @@ namespace dlvhex{
 				 *  \return CmpOp The operation of the range query
 				 */
 
-				/*! \fn std::string DecisionDiagram::Condition::getAttribute() const
-				 *  \brief Figures out the alphanumeric comparison attribute. If both operands are attributes (i.e. no numbers), operand1 will be returned. If none is an attribute, an exception is thrown.
-				 *  \return std::string The alphanumeric attribute. In the expression "X <= 10", "X" will be returned.
+				/*! \fn bool DecisionDiagram::Condition::hasAttribute() const
+				 *  \brief Checks if one of the operands is an alphanumeric attribute (i.e. no number).
+				 *  \return bool False if both operands are numbers or if this is an else condition.
+				 */
+
+				/*! \fn bool DecisionDiagram::Condition::hasCmpValue() const
+				 *  \brief Checks if one of the operands is a numeric comparison value.
+				 *  \return bool False if none of the operands is a number or if this is an else condition.
+				 */
+
+				/*! \fn const std::string& DecisionDiagram::Condition::getAttribute() const
+				 *  \brief Returns the alphanumeric comparison attribute, which was determined at construction. If both operands are attributes (i.e. no numbers), operand1 is the attribute.
+				 *  \return const std::string& The alphanumeric attribute. In the expression "X <= 10", "X" will be returned. Will be empty if hasAttribute() is false.
+				 */
+
+				/*! \fn SymbolTable::Id DecisionDiagram::Condition::getAttributeSymbol() const
+				 *  \brief Returns the alphanumeric comparison attribute as symbol.
+				 *  \return SymbolTable::Id The symbol id of the attribute (SymbolTable::empty if hasAttribute() is false)
+				 */
+
+				/*! \fn double DecisionDiagram::Condition::getCmpValue() const
+				 *  \brief Returns the numeric comparison value, which was parsed at construction. If both operands are numbers (i.e. no attributes), operand1 is the comparison value.
+				 *  \return double The numeric comparison value. In the expression "X <= 10", 10 will be returned. Will be 0 if hasCmpValue() is false.
+				 */
+
+				/*! \fn bool DecisionDiagram::Condition::isAttributeLeft() const
+				 *  \brief Checks if the attribute is the first operand.
+				 *  \return bool True for "X <= 10", false for "10 >= X"
 				 */
 
-				/*! \fn float DecisionDiagram::Condition::getCmpValue() const
-				 *  \brief Figures out the numeric comparison value. If both operands are numbers (i.e. no attributes), operand2 will be returned. If none is a number, an exception is thrown.
-				 *  \return std::string The alphanumeric attribute. In the expression "X <= 10", "10" will be returned.
+				/*! \fn CmpOp DecisionDiagram::Condition::getNormalizedOperation() const
+				 *  \brief Returns the comparison operator for the normalized form of this condition, where the attribute is on the left side.
+				 *  \return CmpOp The operation of the range query with the attribute on the left side. For "10 > X" this is lt (since it is equivalent to "X < 10").
+				 */
+
+				/*! \fn Condition DecisionDiagram::Condition::getCanonical() const
+				 *  \brief Returns an equivalent condition whose operands are ordered by their symbol ids (e.g. "X < 10" and "10 > X" have the same canonical form). Else conditions are returned unchanged.
+				 *  \return Condition The canonical form of this condition
+				 */
+
+				/*! \fn std::size_t DecisionDiagram::Condition::hash() const
+				 *  \brief Returns a hash value of this condition. Equivalent conditions (see operator==) have the same hash.
+				 *  \return std::size_t The hash value
 				 */
 
 				/*! \fn static CmpOp DecisionDiagram::Condition::stringToCmpOp(std::string operation_)
@@ -370,13 +562,19 @@ namespace dlvhex{
 				 *  \return std::string A string representation of op.
 				 */
 
+				/*! \fn static CmpOp DecisionDiagram::Condition::mirrorCmpOp(CmpOp op)
+				 *  \brief Returns the comparison operator which is needed if the operands of a condition are swapped (e.g. gt for lt).
+				 *  \param op A comparison operator
+				 *  \return CmpOp The mirrored comparison operator
+				 */
+
 				/*! \fn std::string DecisionDiagram::Condition::toString() const
 				 *  \brief Returns a string representation of this condition.
 				 *  \return std::string The string representation of this condition.
 				 */
 
 				/*! \fn bool DecisionDiagram::Condition::operator==(const Condition& c2) const
-				 * Compares this condition with another one _semantically_. Two conditions are equivalent if they encode the same classifier.
+				 * Compares this condition with another one _semantically_. Two conditions are equivalent if they encode the same classifier. Else conditions are only equivalent to else conditions.
 				 *  \throws bool True iff the conditions are semantically equivalent.
 				 */
 
@@ -391,18 +589,31 @@ namespace dlvhex{
 				 */
 				class ElseEdge;
 				class Edge{
+				public:
+					enum Kind{
+						conditional,
+						unconditional
+					};
 				private:
+					Kind kind;		// Conditional or else edge; fixed at construction (allows for type queries without RTTI)
 					Node *from, *to;
 					Condition condition;
+					int inIndex;		// Position of this edge in the ingoing edges of "to" (allows for removal in constant time)
 
 					// The following methods are only called by members of DecisionDiagram in order to maintain the decision diagram's integrity
 					friend class DecisionDiagram;
+					friend class Node;
 					Edge(Node *f, Node *t, Condition c);
+					Edge(Node *f, Node *t, Condition c, Kind k);
 				public:
 					virtual ~Edge();
 
-					Node* getFrom();
-					Node* getTo();
+					bool isElse() const{ return kind == unconditional; }
+					ElseEdge* asElse();
+					const ElseEdge* asElse() const;
+
+					Node* getFrom() const;
+					Node* getTo() const;
 					Condition getCondition() const;
 
 					virtual std::string toString() const;
@@ -420,16 +631,39 @@ namespace dlvhex{
 				 *  \param c The condition of this edge
 				 */
 
+				/*! \fn DecisionDiagram::Edge::Edge(Node *f, Node *t, Condition c, Kind k)
+				 *  \brief Construct a directed edge of a certain kind (used by derived classes)
+				 *  \param f The source node of this edge
+				 *  \param t The destination node of this edge
+				 *  \param c The condition of this edge
+				 *  \param k The kind of this edge
+				 */
+
 				/*! \fn DecisionDiagram::Edge::~Edge()
 				 *  \brief Destructor
 				 */
 
-				/*! \fn Node* DecisionDiagram::Edge::getFrom()
+				/*! \fn bool DecisionDiagram::Edge::isElse() const
+				 *  \brief Checks if this edge is an unconditional (else) edge. Unlike dynamic_cast, this only reads a field of the edge.
+				 *  \return bool True iff this edge is an instance of ElseEdge
+				 */
+
+				/*! \fn ElseEdge* DecisionDiagram::Edge::asElse()
+				 *  \brief Converts this edge into an else edge.
+				 *  \return ElseEdge* This edge as else edge or NULL if it is a conditional edge
+				 */
+
+				/*! \fn const ElseEdge* DecisionDiagram::Edge::asElse() const
+				 *  \brief Converts this edge into an else edge.
+				 *  \return const ElseEdge* This edge as else edge or NULL if it is a conditional edge
+				 */
+
+				/*! \fn Node* DecisionDiagram::Edge::getFrom() const
 				 *  \brief Returns the source node of this directed edge.
 				 *  \return Node* The source node of this edge
 				 */
 
-				/*! \fn Node* DecisionDiagram::Edge::getTo()
+				/*! \fn Node* DecisionDiagram::Edge::getTo() const
 				 *  \brief Returns the destination node of this directed edge.
 				 *  \return Node* The destination node of this edge
 				 */
@@ -508,24 +742,303 @@ namespace dlvhex{
 				 */
 
 
+				typedef boost::iterator_range<std::set<Node*>::const_iterator> NodeRange;
+				typedef boost::iterator_range<std::set<LeafNode*>::const_iterator> LeafNodeRange;
+				typedef boost::iterator_range<std::set<Edge*>::const_iterator> EdgeRange;
+
+				// Maps each attribute (symbol) to the number of conditional edges which refer to it
+				typedef boost::unordered_map<SymbolTable::Id, int> AttributeUsage;
+
+				// Treatment of label collisions in mergeInto
+				enum RenamePolicy{
+					keepLabels,		// labels must not collide (an InvalidDecisionDiagram is thrown otherwise)
+					renameColliding		// nodes with colliding labels are added as fresh nodes, i.e. they are renamed when their labels are requested (see addFreshNode)
+				};
+
+				/**
+				 * \brief Receives the elements of a decision diagram from DecisionDiagram::emit. Derived classes implement the actual output (e.g. answer sets, DLV facts, dot).
+				 */
+				class Sink{
+				public:
+					virtual ~Sink();
+					virtual void begin(const DecisionDiagram& dd);
+					virtual void innerNode(const Node* n) = 0;
+					virtual void leafNode(const LeafNode* n) = 0;
+					virtual void conditionalEdge(const Edge* e) = 0;
+					virtual void elseEdge(const Edge* e) = 0;
+					virtual void rootNode(const Node* n) = 0;
+					virtual void end();
+				};
+
+				/*! \fn virtual void DecisionDiagram::Sink::begin(const DecisionDiagram& dd)
+				 *  \brief Is called once before any element of a diagram is passed. Does nothing by default.
+				 *  \param dd The diagram which is emitted
+				 */
+
+				/*! \fn virtual void DecisionDiagram::Sink::innerNode(const Node* n)
+				 *  \brief Is called once for each inner node. The outgoing edges of the node are passed immediately afterwards.
+				 *  \param n An inner node
+				 */
+
+				/*! \fn virtual void DecisionDiagram::Sink::leafNode(const LeafNode* n)
+				 *  \brief Is called once for each leaf node.
+				 *  \param n A leaf node
+				 */
+
+				/*! \fn virtual void DecisionDiagram::Sink::conditionalEdge(const Edge* e)
+				 *  \brief Is called once for each conditional edge (after its from-node was passed).
+				 *  \param e A conditional edge
+				 */
+
+				/*! \fn virtual void DecisionDiagram::Sink::elseEdge(const Edge* e)
+				 *  \brief Is called once for each unconditional (else) edge (after its from-node was passed).
+				 *  \param e An else edge
+				 */
+
+				/*! \fn virtual void DecisionDiagram::Sink::rootNode(const Node* n)
+				 *  \brief Is called once after all nodes and edges were passed, if the diagram has a root.
+				 *  \param n The root node (it was passed before as inner or leaf node)
+				 */
+
+				/*! \fn virtual void DecisionDiagram::Sink::end()
+				 *  \brief Is called once after all elements of a diagram were passed. Does nothing by default.
+				 */
+
+				/**
+				 * \brief Depth-first traversal with an explicit stack, such that the depth of a diagram is not limited by the call stack (e.g. long chains of binary nodes).
+				 * A recursive algorithm is expressed by two callbacks: enter (pre-order) lists the items which are processed below an item, leave (post-order) computes the result of an item
+				 * from the results of these children. Items are usually nodes, but can be anything which identifies a subproblem (e.g. a pair of nodes); enter may also store information in
+				 * the item which is needed by leave. The children of an item are determined when it is entered, thus the diagram may be modified during the traversal.
+				 * Like a recursive function, the traversal processes an item once per path (see MemoizedTraversal for DAG walks).
+				 */
+				template<class Item, class Result> class Traversal{
+				private:
+					struct Frame{
+						Frame(const Item& item_) : item(item_){
+						}
+
+						Item item;
+						std::size_t childrenBegin;	// the children of the item are children[childrenBegin] to children[childrenEnd - 1]
+						std::size_t childrenEnd;
+						std::size_t nextChild;
+						std::size_t resultsBegin;	// the results of the children which were processed so far start at results[resultsBegin]
+					};
+
+					void push(std::vector<Frame>& frames, std::vector<Item>& children, std::vector<Result>& results, const Item& item){
+						Frame f(item);
+						f.childrenBegin = children.size();
+						f.resultsBegin = results.size();
+						enter(f.item, children);
+						f.childrenEnd = children.size();
+						f.nextChild = f.childrenBegin;
+						frames.push_back(f);
+					}
+
+				protected:
+					virtual const Result* lookup(const Item& item){
+						return NULL;
+					}
+
+					virtual void store(const Item& item, const Result& result){
+					}
+
+				public:
+					virtual ~Traversal(){
+					}
+
+					virtual void enter(Item& item, std::vector<Item>& children) = 0;
+					virtual Result leave(const Item& item, const std::vector<Result>& childResults) = 0;
+
+					Result run(const Item& start){
+						const Result* known = lookup(start);
+						if (known != NULL) return *known;
+
+						std::vector<Frame> frames;
+						std::vector<Item> children;
+						std::vector<Result> results;
+						push(frames, children, results, start);
+						while (true){
+							Frame& f = frames.back();
+							if (f.nextChild < f.childrenEnd){
+								// descend into the next child (unless its result is known)
+								Item child = children[f.nextChild++];
+								known = lookup(child);
+								if (known != NULL){
+									results.push_back(*known);
+								}else{
+									push(frames, children, results, child);
+								}
+							}else{
+								// all children are processed
+								std::vector<Result> childResults(results.begin() + f.resultsBegin, results.end());
+								Result r = leave(f.item, childResults);
+								store(f.item, r);
+								results.erase(results.begin() + f.resultsBegin, results.end());
+								children.erase(children.begin() + f.childrenBegin, children.end());
+								frames.pop_back();
+								if (frames.empty()) return r;
+								results.push_back(r);
+							}
+						}
+					}
+				};
+
+				/*! \fn virtual const Result* DecisionDiagram::Traversal::lookup(const Item& item)
+				 *  \brief Is called before an item is entered; allows derived classes to skip items whose result is known. Returns NULL by default.
+				 *  \param item An item
+				 *  \return const Result* The result of item or NULL if it is not known
+				 */
+
+				/*! \fn virtual void DecisionDiagram::Traversal::store(const Item& item, const Result& result)
+				 *  \brief Is called after an item was left. Does nothing by default.
+				 *  \param item An item
+				 *  \param result The result of item
+				 */
+
+				/*! \fn virtual void DecisionDiagram::Traversal::enter(Item& item, std::vector<Item>& children)
+				 *  \brief Is called when an item is reached (pre-order).
+				 *  \param item The current item; can be modified in order to pass information to leave
+				 *  \param children Receives the items which shall be processed below item (they are appended in the order in which they are processed)
+				 */
+
+				/*! \fn virtual Result DecisionDiagram::Traversal::leave(const Item& item, const std::vector<Result>& childResults)
+				 *  \brief Is called after all children of an item were processed (post-order).
+				 *  \param item The current item (as modified by enter)
+				 *  \param childResults The results of the children (in the order in which they were listed by enter)
+				 *  \return Result The result of item
+				 */
+
+				/*! \fn Result DecisionDiagram::Traversal::run(const Item& start)
+				 *  \brief Processes an item and everything below it.
+				 *  \param start The item to begin with
+				 *  \return Result The result of start
+				 */
+
+				/**
+				 * \brief Traversal which computes the result of each item only once and reuses it whenever the item is reached again (memoized DAG walk). Items must be hashable by boost::hash
+				 * and must not be reachable from themselves. The results are kept for subsequent runs of the same traversal.
+				 */
+				template<class Item, class Result> class MemoizedTraversal : public Traversal<Item, Result>{
+				private:
+					boost::unordered_map<Item, Result> memo;
+
+				protected:
+					virtual const Result* lookup(const Item& item){
+						typename boost::unordered_map<Item, Result>::const_iterator it = memo.find(item);
+						return it == memo.end() ? NULL : &it->second;
+					}
+
+					virtual void store(const Item& item, const Result& result){
+						memo.insert(std::pair<Item, Result>(item, result));
+					}
+				};
+
 			private:
 				std::set<Node*> nodes;
+				std::set<LeafNode*> leafNodes;	// subset of nodes; maintained incrementally such that leaf queries do not need to scan all nodes
 				std::set<Edge*> edges;
 				Node* root;
+				int multiParentNodeCount;	// number of nodes with more than one ingoing edge; maintained incrementally such that isTree() runs in constant time
+
+				// Maps each node label (symbol) to the according node; allows for label lookups in constant time
+				// (mutable since pending labels are generated and indexed by const lookups, see materializeLabels)
+				typedef boost::unordered_map<SymbolTable::Id, Node*> LabelIndex;
+				mutable LabelIndex labelIndex;
+
+				// Label generation: for each proposal passed to getUniqueLabel the largest N such that the labels proposal_1 to proposal_N are known to be in use;
+				// labels are only added as long as no node is removed or renamed, thus the counters are reset in that case
+				mutable boost::unordered_map<std::string, int> labelCounters;
+
+				// Hash-consing: structural signature of a node, i.e. its classification (leaf nodes) or the sorted list of its (normalized) out-edge conditions and children (inner nodes)
+				struct EdgeSignature{
+					Condition::CmpOp operation;
+					SymbolTable::Id operand1;
+					SymbolTable::Id operand2;
+					Node* child;
+					bool operator<(const EdgeSignature& es2) const;
+					bool operator==(const EdgeSignature& es2) const;
+				};
+				struct NodeSignature{
+					bool leaf;
+					SymbolTable::Id classification;
+					std::vector<EdgeSignature> edges;
+					bool operator==(const NodeSignature& ns2) const;
+				};
+				struct NodeSignatureHash{
+					std::size_t operator()(const NodeSignature& ns) const;
+				};
+
+				// Maps the signature of each shared node to the node itself (unique table), and each shared node back to its table entry
+				typedef boost::unordered_map<NodeSignature, Node*, NodeSignatureHash> UniqueTable;
+				UniqueTable uniqueTable;
+				boost::unordered_map<Node*, const NodeSignature*> sharedNodes;
+				static EdgeSignature getEdgeSignature(const Condition& c, Node* child);
+				Node* lookupShared(const NodeSignature& signature) const;
+				void registerShared(const NodeSignature& signature, Node* n);
+				void unshare(Node* n);
+
+				// All nodes and edges of this diagram are allocated from these pools; they are freed in bulk when the diagram is cleared or destructed
+				MemoryPool nodePool;
+				MemoryPool edgePool;
+				void destroyNode(Node* n);
+				void destroyEdge(Edge* e);
+
+				// Insertion without any checks (the callers guarantee unique labels and that the endpoints are members of this diagram)
+				boost::uint32_t nextNodeId;
+				void registerNode(Node* n, bool fresh);
+				Node* insertNode(SymbolTable::Id label, bool fresh);
+				LeafNode* insertLeafNode(SymbolTable::Id label, SymbolTable::Id classification, bool fresh);
+				Edge* insertEdge(Node* from, Node* to, const Condition& c);
+				ElseEdge* insertElseEdge(Node* from, Node* to);
+				Node* mergeInto(DecisionDiagram& target, RenamePolicy policy, const std::vector<const Node*>& sourceNodes, const Node* sourceRoot) const;
+
+				// Fresh nodes whose labels are pending (by id); their labels are generated in this order as soon as one of them is requested
+				// Every reader of the label index calls materializeLabels first, such that lookups also find fresh nodes and see their final labels
+				mutable std::map<boost::uint32_t, Node*> pendingLabels;
+				void materializeLabels() const;
+
+				// Called by Node::setLabel in order to keep the label index consistent
+				friend class Node;
+				void relabelNode(Node* n, std::string label);
+				bool containsLabel(const std::string& label) const;
+
+				// Topology cache: dense node numbering, topological order and reachability from the root; recomputed on demand after the diagram was modified
+				mutable bool topologyValid;
+				mutable bool acyclic;
+				mutable std::vector<Node*> topologicalOrder;
+				mutable std::vector<bool> reachableFromRoot;
+				void invalidateTopology();
+				void updateTopology() const;
+
+				// Statistics cache: depth, path counts and attribute usage; recomputed on demand after the diagram was modified
+				mutable bool statisticsValid;
+				mutable int depth;
+				mutable double pathCount;
+				mutable double unfoldedNodeCount;
+				mutable AttributeUsage attributeUsage;
+				void updateStatistics() const;
 
 			public:
 				// Constructors and destructors
 				DecisionDiagram();
 				DecisionDiagram(const DecisionDiagram &dd2);
-				DecisionDiagram(AtomSet as);
+				DecisionDiagram(const AtomSet& as);
 				~DecisionDiagram();
 				void clear();
+				void reserve(std::size_t nodeCount);
 
 				DecisionDiagram& operator=(const DecisionDiagram &dd2);
+				void swap(DecisionDiagram& dd2);
+				void moveFrom(DecisionDiagram& dd2);
+				DecisionDiagram* clone() const;
 
 				// Modification
 				Node* addNode(std::string label);
 				LeafNode* addLeafNode(std::string label, std::string classification);
+				Node* addFreshNode(std::string baseLabel);
+				LeafNode* addFreshLeafNode(std::string baseLabel, std::string classification);
+				Node* addFreshNode(const Node* original);
+				LeafNode* addFreshLeafNode(const LeafNode* original);
 				Node* addNode(Node* template_);
 				void removeNode(Node *n);
 				void removeNode(Node *n, bool forceRemoveEdges);
@@ -538,6 +1051,12 @@ namespace dlvhex{
 				void removeEdge(Edge* e);
 				Node* addDecisionDiagram(DecisionDiagram* dd2);
 				Node* partialAddDecisionDiagram(DecisionDiagram *dd2, Node *n);
+				Node* mergeInto(DecisionDiagram& target, RenamePolicy policy) const;
+				Node* mergeInto(DecisionDiagram& target, RenamePolicy policy, const Node* start) const;
+
+				// Hash-consing
+				LeafNode* addSharedLeafNode(std::string label, std::string classification);
+				Node* addSharedNode(std::string label, const std::vector<std::pair<Condition, Node*> >& children);
 
 				void setRoot(Node* root);
 				void useUniqueLabels(DecisionDiagram* dd2);
@@ -547,8 +1066,12 @@ namespace dlvhex{
 				std::set<Node*> getNodes() const;
 				std::set<LeafNode*> getLeafNodes() const;
 				std::set<Edge*> getEdges() const;
+				NodeRange getNodeRange() const;
+				LeafNodeRange getLeafNodeRange() const;
+				EdgeRange getEdgeRange() const;
 				Node* getRoot() const;
 				Node* getNodeByLabel(std::string label) const;
+				Node* getNodeByLabelSymbol(SymbolTable::Id label) const;
 				int nodeCount() const;
 				int leafCount() const;
 				int edgeCount() const;
@@ -560,12 +1083,46 @@ namespace dlvhex{
 				virtual bool operator!=(const DecisionDiagram &dd2) const;
 				bool containsPath(const Node* from, const Node* to) const;
 
+				// Topology
+				int getNodeIndex(const Node* n) const;
+				const std::vector<Node*>& getTopologicalOrder() const;
+				const std::vector<bool>& getReachableFromRoot() const;
+				bool isReachableFromRoot(const Node* n) const;
+				int collectUnreachable();
+
+				// Statistics
+				int getDepth() const;
+				double getPathCount() const;
+				double getUnfoldedNodeCount() const;
+				const AttributeUsage& getAttributeUsage() const;
+				int getAttributeUsage(SymbolTable::Id attribute) const;
 
 				// Output generation
+				void emit(Sink& sink) const;
 				AtomSet toAnswerSet() const;
 				AtomSet toAnswerSet(bool addIndex, int index) const;
 				std::string toString() const;
+
+				// Binary files (see DecisionDiagramFile)
+				void save(std::ostream& out) const;
+				void load(const std::string& filename);
 			};
+
+			inline DecisionDiagram::LeafNode* DecisionDiagram::Node::asLeaf(){
+				return isLeaf() ? static_cast<LeafNode*>(this) : NULL;
+			}
+
+			inline const DecisionDiagram::LeafNode* DecisionDiagram::Node::asLeaf() const{
+				return isLeaf() ? static_cast<const LeafNode*>(this) : NULL;
+			}
+
+			inline DecisionDiagram::ElseEdge* DecisionDiagram::Edge::asElse(){
+				return isElse() ? static_cast<ElseEdge*>(this) : NULL;
+			}
+
+			inline const DecisionDiagram::ElseEdge* DecisionDiagram::Edge::asElse() const{
+				return isElse() ? static_cast<const ElseEdge*>(this) : NULL;
+			}
 		}
 	}
 }
@@ -582,18 +1139,23 @@ namespace dlvhex{
  *  \param dd2 Template decision diagram
  */
 
-/*! \fn dlvhex::dd::util::DecisionDiagram::DecisionDiagram(AtomSet as)
- *  \brief Constructs a decision diagram from an answer set. The predicates root(Name), innernode(Label), leafnode(Label, Classification), edge(Node1, Node2, Operand1, comparisonOperator, Operand2) and elseedge(Node1, Node2) will be interpreted. During construction some validity checks (e.g. usage of undefined nodes, cycle checks, etc.) will be performed and an instance of InvalidDecisionDiagram will be thrown in case of an error.
+/*! \fn dlvhex::dd::util::DecisionDiagram::DecisionDiagram(const AtomSet& as)
+ *  \brief Constructs a decision diagram from an answer set (see DecisionDiagramBuilder). The predicates root(Name), innernode(Label), leafnode(Label, Classification), edge(Node1, Node2, Operand1, comparisonOperator, Operand2) and elseedge(Node1, Node2) will be interpreted. During construction some validity checks (e.g. usage of undefined nodes, cycle checks, etc.) will be performed and an instance of InvalidDecisionDiagram will be thrown in case of an error.
  *  \param as An answer set which defines a decision diagram using the following predicates: root(Name), innernode(Label), leafnode(Label, Classification), edge(Node1, Node2, Operand1, comparisonOperator, Operand2), elseedge(Node1, Node2).
  *  \throws InvalidDecisionDiagram The message text will describe the cause of the error.
  */
 
 /*! \fn dlvhex::dd::util::DecisionDiagram::~DecisionDiagram()
- * Destructor. Frees allocated memory.
+ * Destructor. Frees allocated memory. Nodes and edges are allocated from per-diagram memory pools, which are released in bulk.
  */
 
 /*! \fn void dlvhex::dd::util::DecisionDiagram::clear()
- * Removes all nodes and edges from this decision diagram.
+ * Removes all nodes and edges from this decision diagram. The memory pools of the diagram are released in bulk.
+ */
+
+/*! \fn void dlvhex::dd::util::DecisionDiagram::reserve(std::size_t nodeCount)
+ * Prepares the label index for a certain number of nodes, such that it does not need to grow while the nodes are inserted.
+ *  \param nodeCount The expected number of nodes
  */
 
 /*! \fn DecisionDiagram& dlvhex::dd::util::DecisionDiagram::operator=(const DecisionDiagram &dd2)
@@ -602,6 +1164,21 @@ namespace dlvhex{
  *  \return DecisionDiagram& Reference to this decision diagram after assignment.
  */
 
+/*! \fn void dlvhex::dd::util::DecisionDiagram::swap(DecisionDiagram& dd2)
+ * Exchanges the contents of this decision diagram and dd2 without copying any nodes or edges. Pointers to nodes and edges remain valid, but they belong to the other diagram afterwards.
+ *  \param dd2 Another decision diagram
+ */
+
+/*! \fn void dlvhex::dd::util::DecisionDiagram::moveFrom(DecisionDiagram& dd2)
+ * Takes over the contents of dd2 without copying them (the C++03 counterpart of a move assignment). This diagram's previous contents are destructed and dd2 is empty afterwards.
+ *  \param dd2 The decision diagram to move from
+ */
+
+/*! \fn DecisionDiagram* dlvhex::dd::util::DecisionDiagram::clone() const
+ * Creates an independent deep copy of this decision diagram (see operator=). Use this instead of passing diagrams by value in order to make expensive copies explicit.
+ *  \return DecisionDiagram* A new decision diagram; the caller is responsible for deleting it
+ */
+
 /*! \fn Node* dlvhex::dd::util::DecisionDiagram::addNode(std::string label)
  * Adds a node with a certain label to this decision diagram. Note that the label must be unique.
  *  \param label The label for the new node. If the label is not unique, an instance of InvalidDecisionDiagram will be thrown.
@@ -617,6 +1194,34 @@ namespace dlvhex{
  *  \throws InvalidDecisionDiagram If the node label is not unique
  */
 
+/*! \fn Node* dlvhex::dd::util::DecisionDiagram::addFreshNode(std::string baseLabel)
+ * Adds a new inner node whose label does not matter (e.g. a copy of a node created by an operator). No label is checked or generated at this point: the node receives a unique label
+ * only when its label is requested first (e.g. when the diagram is written). Then the labels of all pending nodes are generated in the order of creation, where each node gets its base label if
+ * that is unused and otherwise baseLabel_N (see getUniqueLabel). Thus the labels are deterministic, but other nodes which are added in between may take base labels first.
+ *  \param baseLabel The desired label
+ *  \return Node* A pointer to the new node
+ */
+
+/*! \fn LeafNode* dlvhex::dd::util::DecisionDiagram::addFreshLeafNode(std::string baseLabel, std::string classification)
+ * Adds a new leaf node whose label is generated when it is requested first (see addFreshNode).
+ *  \param baseLabel The desired label
+ *  \param classification The classification of the new leaf node
+ *  \return LeafNode* A pointer to the new node
+ */
+
+/*! \fn Node* dlvhex::dd::util::DecisionDiagram::addFreshNode(const Node* original)
+ * Adds a new inner node whose base label is the one of another node (e.g. when the node is copied). If the label of original is still pending, its base label is taken,
+ * thus no labels are generated in either diagram (unlike addFreshNode(original->getLabel())).
+ *  \param original A node of this or of another decision diagram
+ *  \return Node* A pointer to the new node
+ */
+
+/*! \fn LeafNode* dlvhex::dd::util::DecisionDiagram::addFreshLeafNode(const LeafNode* original)
+ * Adds a new leaf node with the (base) label and the classification of another leaf node (see addFreshNode(const Node* original)).
+ *  \param original A leaf node of this or of another decision diagram
+ *  \return LeafNode* A pointer to the new node
+ */
+
 /*! \fn Node* dlvhex::dd::util::DecisionDiagram::addNode(Node* template_)
  * Adds a new node (can be inner or leaf) from a given template. The new node will be exactly the same as the template.
  *  \param template_ Another node which acts as a template for the new one. The new node will have the same attribute values as the template. Note that a copy is created, i.e. the new node and the template will be independent of each other.
@@ -691,6 +1296,25 @@ namespace dlvhex{
  *  \throws InvalidDecisionDiagram If dd2 and this decision diagram have node labels in common.
  */
 
+/*! \fn Node* dlvhex::dd::util::DecisionDiagram::mergeInto(DecisionDiagram& target, RenamePolicy policy) const
+ * Copies all nodes and edges of this decision diagram into another one (the root of target is not changed). Labels are looked up in the label indices of both diagrams and the copies are inserted
+ * directly, thus the runtime is linear in the size of this diagram. This replaces copying the diagram, calling useUniqueLabels and addDecisionDiagram. Fresh nodes stay fresh.
+ *  \param target The diagram to add the nodes and edges to (may be this diagram)
+ *  \param policy keepLabels if the labels must not collide with those in target, renameColliding if colliding labels shall be renamed
+ *  \return Node* The copy of the root within target (NULL if this diagram has no root)
+ *  \throws InvalidDecisionDiagram If the policy is keepLabels and a label is used in both diagrams; target is not modified in this case.
+ */
+
+/*! \fn Node* dlvhex::dd::util::DecisionDiagram::mergeInto(DecisionDiagram& target, RenamePolicy policy, const Node* start) const
+ * Copies the subdiagram which is reachable from a certain node into another decision diagram (see mergeInto(DecisionDiagram&, RenamePolicy)). This replaces partialAddDecisionDiagram followed by
+ * useUniqueLabels and addDecisionDiagram.
+ *  \param target The diagram to add the nodes and edges to (may be this diagram, e.g. in order to duplicate a subtree)
+ *  \param policy keepLabels if the labels must not collide with those in target, renameColliding if colliding labels shall be renamed
+ *  \param start A node of this diagram
+ *  \return Node* The copy of start within target
+ *  \throws InvalidDecisionDiagram If start is not part of this diagram, or if the policy is keepLabels and a label is used in both diagrams
+ */
+
 /*! \fn Node* dlvhex::dd::util::DecisionDiagram::partialAddDecisionDiagram(DecisionDiagram *dd2, Node *n)
  *  \brief "Partial copy". Copies only the component of the graph reachable from n. This is especially useful if the graph is a tree. The nodes and edges will be added to this decision diagram
  *  i.e. existing element will be kept.
@@ -706,6 +1330,24 @@ namespace dlvhex{
  *  \throws InvalidDecisionDiagram If root is not part of this decision diagram
  */
 
+/*! \fn LeafNode* dlvhex::dd::util::DecisionDiagram::addSharedLeafNode(std::string label, std::string classification)
+ * Returns the canonical leaf node with a certain classification. If the diagram does not contain such a shared leaf node yet, it is created.
+ * Note: Shared nodes (see also addSharedNode) are possibly used in several places and should not be modified. If edges are added to or removed from a shared node anyway, it is withdrawn from the unique table (i.e. it is not reused anymore).
+ * Changing the classification of a shared leaf node is not detected.
+ *  \param label The desired node label in case that a new node is created. It is made unique if necessary (see getUniqueLabel).
+ *  \param classification The classification of the leaf node
+ *  \return LeafNode* A pointer to the (possibly pre-existing) shared leaf node
+ */
+
+/*! \fn Node* dlvhex::dd::util::DecisionDiagram::addSharedNode(std::string label, const std::vector<std::pair<Condition, Node*> >& children)
+ * Returns the canonical inner node with a certain list of out-edges. If the diagram does not contain a shared node with the same conditions leading to the same children yet, it is created (together with it's out-edges).
+ * If all subdiagrams are built bottom-up by addSharedLeafNode and addSharedNode, structurally equal subdiagrams are created exactly once and equality becomes pointer identity.
+ *  \param label The desired node label in case that a new node is created. It is made unique if necessary (see getUniqueLabel).
+ *  \param children The out-edges of the node, given as pairs of edge conditions and destination nodes. The destination nodes must be shared nodes of this diagram.
+ *  \return Node* A pointer to the (possibly pre-existing) shared inner node
+ *  \throws InvalidDecisionDiagram If one of the children is not part of this decision diagram
+ */
+
 /*! \fn void dlvhex::dd::util::DecisionDiagram::useUniqueLabels(DecisionDiagram* dd2)
  * Modifies the labels of this diagram's nodes s.t. they are unique also within dd2.
  *  \param dd2 A reference decision diagram. The node's labels will be uique within this decision diagram and within dd2.
@@ -713,6 +1355,7 @@ namespace dlvhex{
 
 /*! \fn std::string dlvhex::dd::util::DecisionDiagram::getUniqueLabel(std::string proposal) const
  * Returns a new node label which is as similar to the proposal as possible, such that it is unique within the decision diagram.
+ * The result is the proposal itself or proposal_N for the smallest N >= 1 that is not in use. Runs in amortized constant time, since the numbers which are known to be in use are remembered per proposal.
  *  \param proposal The desired node label. If it is unique, it is returned unchanged. Otherwise, a number will be added such that it becomes unique.
  *  \param std::string A new unique node label similar or equal to the proposal
  */
@@ -723,7 +1366,7 @@ namespace dlvhex{
  */
 
 /*! \fn std::set<LeafNode*> dlvhex::dd::util::DecisionDiagram::getLeafNodes() const
- * Returns a set with the leaf nodes (pointers) of this decision diagram.
+ * Returns a set with the leaf nodes (pointers) of this decision diagram. The leaf nodes are tracked while the diagram is modified, i.e. inner nodes are not visited.
  *  \return std::set<LeafNode*> Leaf nodes (pointers) of this decision diagram.
  */
 
@@ -732,13 +1375,34 @@ namespace dlvhex{
  *  \return std::set<Edge*> Edges (pointers) of this decision diagram.
  */
 
+/*! \fn NodeRange dlvhex::dd::util::DecisionDiagram::getNodeRange() const
+ * Returns a range over the nodes (pointers) of this decision diagram without copying them. See EdgeList for the invalidation rules.
+ *  \return NodeRange Nodes (pointers) of this decision diagram.
+ */
+
+/*! \fn LeafNodeRange dlvhex::dd::util::DecisionDiagram::getLeafNodeRange() const
+ * Returns a range over the leaf nodes (pointers) of this decision diagram without copying them. See EdgeList for the invalidation rules.
+ *  \return LeafNodeRange Leaf nodes (pointers) of this decision diagram.
+ */
+
+/*! \fn EdgeRange dlvhex::dd::util::DecisionDiagram::getEdgeRange() const
+ * Returns a range over the edges (pointers) of this decision diagram without copying them. See EdgeList for the invalidation rules.
+ *  \return EdgeRange Edges (pointers) of this decision diagram.
+ */
+
 /*! \fn Node* dlvhex::dd::util::DecisionDiagram::getRoot() const
  * Returns a pointer to the root node of this decision diagram.
  *  \return Node* A pointer to the root node of this decision diagram.
  */
 
 /*! \fn Node* dlvhex::dd::util::DecisionDiagram::getNodeByLabel(std::string label) const
- * Looks up a node in this decision diagram by it's label.
+ * Looks up a node in this decision diagram by it's label. The lookup is answered from a hash index over the node labels in (expected) constant time.
+ *  \return Node* A pointer to the node with the given label.
+ *  \throw InvalidDecisionDiagram If the decision diagram does not contain a node with the given label.
+ */
+
+/*! \fn Node* dlvhex::dd::util::DecisionDiagram::getNodeByLabelSymbol(SymbolTable::Id label) const
+ * Looks up a node in this decision diagram by the symbol of it's label (see Node::getLabelSymbol). Unlike getNodeByLabel, no string needs to be hashed.
  *  \return Node* A pointer to the node with the given label.
  *  \throw InvalidDecisionDiagram If the decision diagram does not contain a node with the given label.
  */
@@ -749,7 +1413,7 @@ namespace dlvhex{
  */
 
 /*! \fn int dlvhex::dd::util::DecisionDiagram::leafCount() const
- * Returns the number of leaf nodes in this decision diagram.
+ * Returns the number of leaf nodes in this decision diagram in constant time.
  *  \return int Number of leaf nodes in this decision diagram.
  */
 
@@ -760,11 +1424,12 @@ namespace dlvhex{
 
 /*! \fn std::vector<Node*> bool dlvhex::dd::util::DecisionDiagram::containsCycles() const
  * Checks if the decision diagram contains at least one cycle. While most kinds of inconsistencies are automatically prevented while the decision diagram is creates, cycles are not detected on the fly because of performance reasons. This method starts a cycle detection algorithm and returns the result.
+ * Runtime: O(|V| + |E|); if the diagram is known to be acyclic from the topology cache, the answer is immediate.
  *  \return std::vector<Node*> Will be empty if the decision diagram contains no cycle. Otherwise, the result will be the list of nodes building a cycle.
  */
 
 /*! \fn bool dlvhex::dd::util::DecisionDiagram::isTree() const
- * Checks if this decision diagram is a tree.
+ * Checks if this decision diagram is a tree, i.e. no node has more than one ingoing edge. Runs in constant time (the number of such nodes is maintained incrementally).
  *  \throws bool True iff this decision diagram is a tree, otherwise false.
  */
 
@@ -779,10 +1444,77 @@ namespace dlvhex{
  */
 
 /*! \fn bool dlvhex::dd::util::DecisionDiagram::containsPath(const Node* from, const Node* to) const;
- * Checks if there is a path from a certain node to a certain other one
+ * Checks if there is a path from a certain node to a certain other one. Each node is visited at most once, i.e. the runtime is O(|V| + |E|) also for diagrams with shared nodes.
  *  \throws bool True iff there is a path from "from" to "to"
  */
 
+/*! \fn int dlvhex::dd::util::DecisionDiagram::getNodeIndex(const Node* n) const
+ * Returns a dense index of a node, which can be used to address per-node data in vectors (e.g. the result of getReachableFromRoot). The indices are reassigned whenever the diagram is modified.
+ *  \param n A node of this diagram
+ *  \return int The index of n, which is in the range 0 to nodeCount() - 1
+ *  \throws InvalidDecisionDiagram If n is not part of this decision diagram
+ */
+
+/*! \fn const std::vector<Node*>& dlvhex::dd::util::DecisionDiagram::getTopologicalOrder() const
+ * Returns all nodes of the diagram in topological order, i.e. each node occurs before its children. The order is cached until the diagram is modified.
+ *  \return const std::vector<Node*>& The nodes in topological order (valid until the diagram is modified)
+ *  \throws InvalidDecisionDiagram If the diagram contains a cycle
+ */
+
+/*! \fn const std::vector<bool>& dlvhex::dd::util::DecisionDiagram::getReachableFromRoot() const
+ * Returns the set of nodes which are reachable from the root as bitset (see getNodeIndex). The bitset is cached until the diagram is modified.
+ *  \return const std::vector<bool>& Element i is true iff the node with index i is reachable from the root (valid until the diagram is modified)
+ */
+
+/*! \fn bool dlvhex::dd::util::DecisionDiagram::isReachableFromRoot(const Node* n) const
+ * Checks if a node is reachable from the root. Runs in constant time as long as the diagram is not modified.
+ *  \param n A node of this diagram
+ *  \return bool True iff there is a path from the root to n
+ *  \throws InvalidDecisionDiagram If n is not part of this decision diagram
+ */
+
+/*! \fn int dlvhex::dd::util::DecisionDiagram::collectUnreachable()
+ * Removes all nodes which are not reachable from the root together with their edges (mark and sweep). If the diagram has no root, all nodes are removed.
+ *  \return int The number of removed nodes
+ */
+
+/*! \fn int dlvhex::dd::util::DecisionDiagram::getDepth() const
+ * Returns the maximum depth of this decision diagram, i.e. the number of edges on the longest path from the root. The statistics are cached until the diagram is modified.
+ *  \return int The maximum depth (0 if the diagram has no root or the root is a leaf)
+ *  \throws InvalidDecisionDiagram If the diagram contains a cycle
+ */
+
+/*! \fn double dlvhex::dd::util::DecisionDiagram::getPathCount() const
+ * Returns the number of paths from the root to a leaf node. Shared subdiagrams are counted once per path, i.e. this is the number of leaf nodes after unfolding (see OpUnfold).
+ * Since the number can be exponential in the size of the diagram, it is returned as floating point number.
+ *  \return double The number of root-to-leaf paths (0 if the diagram has no root)
+ *  \throws InvalidDecisionDiagram If the diagram contains a cycle
+ */
+
+/*! \fn double dlvhex::dd::util::DecisionDiagram::getUnfoldedNodeCount() const
+ * Returns the number of paths from the root to any node, i.e. the number of nodes of the tree which results from unfolding this diagram (see OpUnfold).
+ *  \return double The number of nodes after unfolding (0 if the diagram has no root)
+ *  \throws InvalidDecisionDiagram If the diagram contains a cycle
+ */
+
+/*! \fn const AttributeUsage& dlvhex::dd::util::DecisionDiagram::getAttributeUsage() const
+ * Returns for each attribute the number of conditional edges (of the whole diagram) which refer to it.
+ *  \return const AttributeUsage& Maps attribute symbols to usage counts (valid until the diagram is modified)
+ */
+
+/*! \fn int dlvhex::dd::util::DecisionDiagram::getAttributeUsage(SymbolTable::Id attribute) const
+ * Returns the number of conditional edges which refer to a certain attribute.
+ *  \param attribute The symbol of an attribute
+ *  \return int The number of conditional edges which refer to the attribute (0 if it is not used)
+ */
+
+/*! \fn void dlvhex::dd::util::DecisionDiagram::emit(Sink& sink) const
+ * Passes all nodes and edges of this decision diagram to a sink in a single walk (see Sink and DecisionDiagramSinks.h).
+ * The order is deterministic: The nodes are visited depth-first starting at the root, where the children of each node are visited in the order of its outgoing edges; nodes which are not reachable from the root
+ * are visited afterwards (in the order of their labels). Each node is passed exactly once, followed by its outgoing edges. Finally, the root is passed.
+ *  \param sink The receiver of the diagram's elements
+ */
+
 /*! \fn AtomSet dlvhex::dd::util::DecisionDiagram::toAnswerSet() const
  * Creates an answer set representing this decision diagram with the predicates root(Name), innernode(Label), leafnode(Label, Classification), conditionaledge(Node1, Node2, Operand1, comparisonOperator, Operand2) and elseedge(Node1, Node2).
  *  \return AtomSet An answer set representing this decision diagram with the predicates root(Name), innernode(Label), leafnode(Label, Classification), edge(Node1, Node2, Operand1, comparisonOperator, Operand2) and elseedge(Node1, Node2).
@@ -799,3 +1531,14 @@ namespace dlvhex{
  * Returns a string representation of this decision diagram.
  *  \return A string representation of this decision diagram.
  */
+
+/*! \fn void dlvhex::dd::util::DecisionDiagram::save(std::ostream& out) const
+ * Writes this decision diagram in binary format (a file with a single diagram, see DecisionDiagramFile::write).
+ *  \param out A binary stream to write to
+ */
+
+/*! \fn void dlvhex::dd::util::DecisionDiagram::load(const std::string& filename)
+ * Replaces the contents of this decision diagram by the first diagram of a binary file. The file is memory-mapped (see DecisionDiagramFile).
+ *  \param filename The name of a file which was written by save or DecisionDiagramFile::write
+ *  \throws InvalidDecisionDiagram If the file cannot be read, is not a valid diagram file or contains no diagram
+ */
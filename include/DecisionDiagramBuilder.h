@@ -0,0 +1,56 @@
+#ifndef _DECISIONDIAGRAMBUILDER_H_
+#define _DECISIONDIAGRAMBUILDER_H_
+
+#include <dlvhex/AtomSet.h>
+#include <DecisionDiagram.h>
+#include <SymbolTable.h>
+#include <vector>
+
+DLVHEX_NAMESPACE_USE
+
+namespace dlvhex{
+	namespace dd{
+		namespace util{
+
+			/**
+			 * \brief
+			 * Builds decision diagrams from answer sets using the predicates root(Name), innernode(Label), leafnode(Label, Classification),
+			 * conditionaledge(Node1, Node2, Operand1, comparisonOperator, Operand2) and elseedge(Node1, Node2).
+			 * The atoms are visited exactly once and dispatched on their predicate. Nodes are created immediately, whereas edges and the root are recorded (as interned labels)
+			 * and resolved through the label index of the diagram as soon as all nodes are known. Atoms with other predicates are ignored.
+			 * The diagram is built in a temporary diagram and only moved into the target if the whole input is valid, i.e. malformed input never leaves a partially constructed diagram behind.
+			 */
+			class DecisionDiagramBuilder{
+			private:
+				// An edge which was read but not yet inserted (since its endpoints might not exist yet)
+				struct PendingEdge{
+					SymbolTable::Id from;
+					SymbolTable::Id to;
+					DecisionDiagram::Condition condition;
+					PendingEdge(SymbolTable::Id from_, SymbolTable::Id to_, const DecisionDiagram::Condition& condition_);
+				};
+
+				static void checkArity(const Atom& atom, unsigned int arity);
+			public:
+				static void build(const AtomSet& as, DecisionDiagram& dd);
+			};
+		}
+	}
+}
+
+#endif
+
+
+/*! \fn static void dlvhex::dd::util::DecisionDiagramBuilder::checkArity(const Atom& atom, unsigned int arity)
+ * Checks if an atom has (at least) the expected number of arguments. Additional arguments are ignored by the builder.
+ *  \param atom An atom of the input answer set
+ *  \param arity The expected arity of the atom's predicate
+ *  \throws InvalidDecisionDiagram If the atom has less arguments than expected
+ */
+
+/*! \fn static void dlvhex::dd::util::DecisionDiagramBuilder::build(const AtomSet& as, DecisionDiagram& dd)
+ * Constructs a decision diagram from an answer set in a single pass over the atoms.
+ *  \param as An answer set which defines a decision diagram (see DecisionDiagram::DecisionDiagram(const AtomSet& as))
+ *  \param dd The diagram to overwrite with the result; it is left unchanged if an error occurs
+ *  \throws InvalidDecisionDiagram If the answer set is malformed (missing arguments, unknown comparison operators, duplicate labels, edges between undefined nodes, multiple roots). The message text will describe the cause of the error.
+ */
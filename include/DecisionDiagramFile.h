@@ -0,0 +1,300 @@
+#ifndef _DECISIONDIAGRAMFILE_H_
+#define _DECISIONDIAGRAMFILE_H_
+
+#include <DecisionDiagram.h>
+
+#include <boost/cstdint.hpp>
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace dlvhex{
+	namespace dd{
+		namespace util{
+
+			/**
+			 * \brief
+			 * Read-only view on a binary file of decision diagrams.
+			 * A file stores a forest of diagrams in the following sections (8-byte aligned, native byte order):
+			 *   - a header (magic number, format version, byte order mark, section sizes and offsets)
+			 *   - a diagram table (first node, number of nodes, first edge, number of edges and root of each diagram)
+			 *   - a string table (offsets into a block of zero-terminated strings), shared by all diagrams; labels, classifications and operands are string ids
+			 *   - a node table with 32-bit ids (label, classification, first outgoing edge and number of outgoing edges)
+			 *   - an edge table in compressed sparse row format (destination node, operands, operator, condition flags and the parsed comparison value)
+			 * Node ids and edge ids are relative to their diagram. Files can be memory-mapped and accessed without per-node allocation: the accessors read the tables in place.
+			 * The file is validated completely when it is opened, such that the accessors do not need to check their arguments.
+			 */
+			class DecisionDiagramFile{
+			public:
+				typedef boost::uint32_t NodeId;
+				typedef boost::uint32_t EdgeId;
+				typedef boost::uint32_t StringId;
+
+				// Marks a non-existing node (e.g. the root of an empty diagram) or string (e.g. the classification of an inner node)
+				static const boost::uint32_t none = 0xFFFFFFFF;
+				static const boost::uint32_t version = 1;
+
+			private:
+				struct Header{
+					char magic[4];
+					boost::uint32_t version;
+					boost::uint32_t byteOrder;
+					boost::uint32_t diagramCount;
+					boost::uint32_t stringCount;
+					boost::uint32_t nodeCount;
+					boost::uint32_t edgeCount;
+					boost::uint32_t reserved;
+					boost::uint64_t stringDataSize;
+					boost::uint64_t diagramsOffset;
+					boost::uint64_t stringOffsetsOffset;
+					boost::uint64_t stringDataOffset;
+					boost::uint64_t nodesOffset;
+					boost::uint64_t edgesOffset;
+				};
+
+				struct DiagramRecord{
+					boost::uint32_t firstNode;
+					boost::uint32_t nodeCount;
+					boost::uint32_t firstEdge;
+					boost::uint32_t edgeCount;
+					NodeId root;
+					boost::uint32_t reserved;
+				};
+
+				struct NodeRecord{
+					StringId label;
+					StringId classification;	// none for inner nodes
+					EdgeId firstEdge;
+					boost::uint32_t outDegree;
+				};
+
+				// Condition flags
+				enum{
+					hasAttributeFlag = 1,
+					hasCmpValueFlag = 2,
+					attributeLeftFlag = 4
+				};
+
+				struct EdgeRecord{
+					NodeId to;
+					StringId operand1;
+					StringId operand2;
+					boost::uint8_t operation;
+					boost::uint8_t flags;
+					boost::uint16_t reserved;
+					double cmpValue;
+				};
+
+				const char* data;
+				std::size_t size;
+				void* mapping;				// NULL if the data is not owned by this object
+
+				const Header* header;
+				const DiagramRecord* diagrams;
+				const boost::uint32_t* stringOffsets;
+				const char* stringData;
+				const NodeRecord* nodes;
+				const EdgeRecord* edges;
+
+				// files own the mapping and must not be copied
+				DecisionDiagramFile(const DecisionDiagramFile&);
+				DecisionDiagramFile& operator=(const DecisionDiagramFile&);
+
+				void open();
+				const NodeRecord& node(int d, NodeId n) const;
+				const EdgeRecord& edge(int d, EdgeId e) const;
+
+			public:
+				DecisionDiagramFile(const std::string& filename);
+				DecisionDiagramFile(const char* data_, std::size_t size_);
+				~DecisionDiagramFile();
+
+				static void write(std::ostream& out, const std::vector<const DecisionDiagram*>& diagrams);
+
+				// Getter
+				int diagramCount() const;
+				int stringCount() const;
+				const char* getString(StringId s) const;
+
+				int nodeCount(int d) const;
+				int edgeCount(int d) const;
+				NodeId getRoot(int d) const;
+				StringId getLabel(int d, NodeId n) const;
+				bool isLeaf(int d, NodeId n) const;
+				StringId getClassification(int d, NodeId n) const;
+				EdgeId getOutEdgesBegin(int d, NodeId n) const;
+				EdgeId getOutEdgesEnd(int d, NodeId n) const;
+				NodeId getTo(int d, EdgeId e) const;
+				DecisionDiagram::Condition::CmpOp getOperation(int d, EdgeId e) const;
+				StringId getOperand1(int d, EdgeId e) const;
+				StringId getOperand2(int d, EdgeId e) const;
+				bool hasAttribute(int d, EdgeId e) const;
+				bool hasCmpValue(int d, EdgeId e) const;
+				bool isAttributeLeft(int d, EdgeId e) const;
+				double getCmpValue(int d, EdgeId e) const;
+
+				// Conversion
+				void toDecisionDiagram(int d, DecisionDiagram& dd) const;
+			};
+		}
+	}
+}
+
+#endif
+
+
+/*! \fn dlvhex::dd::util::DecisionDiagramFile::DecisionDiagramFile(const std::string& filename)
+ * Maps a file into memory (read-only and shared, such that several processes can use the same pages).
+ *  \param filename The name of a file which was written by DecisionDiagramFile::write
+ *  \throws DecisionDiagram::InvalidDecisionDiagram If the file cannot be mapped or is not a valid diagram file
+ */
+
+/*! \fn dlvhex::dd::util::DecisionDiagramFile::DecisionDiagramFile(const char* data_, std::size_t size_)
+ * Creates a view on a file which is already in memory. The data is not copied, thus it must stay valid as long as this object is used.
+ *  \param data_ The contents of a file which was written by DecisionDiagramFile::write (must be 8-byte aligned)
+ *  \param size_ The number of bytes
+ *  \throws DecisionDiagram::InvalidDecisionDiagram If the data is not a valid diagram file
+ */
+
+/*! \fn dlvhex::dd::util::DecisionDiagramFile::~DecisionDiagramFile()
+ * Destructor. Unmaps the file (if it was mapped by this object).
+ */
+
+/*! \fn static void dlvhex::dd::util::DecisionDiagramFile::write(std::ostream& out, const std::vector<const DecisionDiagram*>& diagrams)
+ * Writes a forest of decision diagrams in binary format. The nodes of each diagram are numbered depth-first from the root (see CompactDecisionDiagram), the strings of all diagrams are
+ * stored once.
+ *  \param out A binary stream to write to
+ *  \param diagrams The diagrams to write
+ */
+
+/*! \fn int dlvhex::dd::util::DecisionDiagramFile::diagramCount() const
+ * Returns the number of diagrams in this file. Valid diagram indices are 0 to diagramCount() - 1.
+ *  \return int Number of diagrams
+ */
+
+/*! \fn int dlvhex::dd::util::DecisionDiagramFile::stringCount() const
+ * Returns the number of strings in the string table of this file.
+ *  \return int Number of strings
+ */
+
+/*! \fn const char* dlvhex::dd::util::DecisionDiagramFile::getString(StringId s) const
+ * Looks up a string in the string table.
+ *  \param s A string id
+ *  \return const char* The zero-terminated string (points into the file)
+ */
+
+/*! \fn int dlvhex::dd::util::DecisionDiagramFile::nodeCount(int d) const
+ * Returns the number of nodes of a diagram. Valid node ids are 0 to nodeCount(d) - 1.
+ *  \param d A diagram index
+ *  \return int Number of nodes
+ */
+
+/*! \fn int dlvhex::dd::util::DecisionDiagramFile::edgeCount(int d) const
+ * Returns the number of edges of a diagram. Valid edge ids are 0 to edgeCount(d) - 1.
+ *  \param d A diagram index
+ *  \return int Number of edges
+ */
+
+/*! \fn NodeId dlvhex::dd::util::DecisionDiagramFile::getRoot(int d) const
+ * Returns the root of a diagram.
+ *  \param d A diagram index
+ *  \return NodeId The id of the root node or DecisionDiagramFile::none if the diagram has no root
+ */
+
+/*! \fn StringId dlvhex::dd::util::DecisionDiagramFile::getLabel(int d, NodeId n) const
+ * Returns the label of a node.
+ *  \param d A diagram index
+ *  \param n A node id
+ *  \return StringId The string id of the label
+ */
+
+/*! \fn bool dlvhex::dd::util::DecisionDiagramFile::isLeaf(int d, NodeId n) const
+ * Checks if a node is a leaf node.
+ *  \param d A diagram index
+ *  \param n A node id
+ *  \return bool True iff n is a leaf node
+ */
+
+/*! \fn StringId dlvhex::dd::util::DecisionDiagramFile::getClassification(int d, NodeId n) const
+ * Returns the classification of a leaf node.
+ *  \param d A diagram index
+ *  \param n A node id
+ *  \return StringId The string id of the classification or DecisionDiagramFile::none for inner nodes
+ */
+
+/*! \fn EdgeId dlvhex::dd::util::DecisionDiagramFile::getOutEdgesBegin(int d, NodeId n) const
+ * Returns the id of the first outgoing edge of a node. The outgoing edges of n have the ids getOutEdgesBegin(d, n) to getOutEdgesEnd(d, n) - 1 (in insertion order).
+ *  \param d A diagram index
+ *  \param n A node id
+ *  \return EdgeId The id of the first outgoing edge of n
+ */
+
+/*! \fn EdgeId dlvhex::dd::util::DecisionDiagramFile::getOutEdgesEnd(int d, NodeId n) const
+ * Returns the id behind the last outgoing edge of a node.
+ *  \param d A diagram index
+ *  \param n A node id
+ *  \return EdgeId The id behind the last outgoing edge of n
+ */
+
+/*! \fn NodeId dlvhex::dd::util::DecisionDiagramFile::getTo(int d, EdgeId e) const
+ * Returns the destination node of an edge.
+ *  \param d A diagram index
+ *  \param e An edge id
+ *  \return NodeId The id of the destination node
+ */
+
+/*! \fn DecisionDiagram::Condition::CmpOp dlvhex::dd::util::DecisionDiagramFile::getOperation(int d, EdgeId e) const
+ * Returns the comparison operator of an edge.
+ *  \param d A diagram index
+ *  \param e An edge id
+ *  \return DecisionDiagram::Condition::CmpOp The operator (else_ for else edges)
+ */
+
+/*! \fn StringId dlvhex::dd::util::DecisionDiagramFile::getOperand1(int d, EdgeId e) const
+ * Returns the first operand of the condition of an edge.
+ *  \param d A diagram index
+ *  \param e An edge id
+ *  \return StringId The string id of the first operand
+ */
+
+/*! \fn StringId dlvhex::dd::util::DecisionDiagramFile::getOperand2(int d, EdgeId e) const
+ * Returns the second operand of the condition of an edge.
+ *  \param d A diagram index
+ *  \param e An edge id
+ *  \return StringId The string id of the second operand
+ */
+
+/*! \fn bool dlvhex::dd::util::DecisionDiagramFile::hasAttribute(int d, EdgeId e) const
+ * Checks if one of the operands of the condition of an edge is an attribute (see DecisionDiagram::Condition::hasAttribute).
+ *  \param d A diagram index
+ *  \param e An edge id
+ *  \return bool True iff the condition refers to an attribute
+ */
+
+/*! \fn bool dlvhex::dd::util::DecisionDiagramFile::hasCmpValue(int d, EdgeId e) const
+ * Checks if one of the operands of the condition of an edge is a number (see DecisionDiagram::Condition::hasCmpValue).
+ *  \param d A diagram index
+ *  \param e An edge id
+ *  \return bool True iff the condition contains a numeric comparison value
+ */
+
+/*! \fn bool dlvhex::dd::util::DecisionDiagramFile::isAttributeLeft(int d, EdgeId e) const
+ * Checks if the attribute is the first operand of the condition of an edge (see DecisionDiagram::Condition::isAttributeLeft).
+ *  \param d A diagram index
+ *  \param e An edge id
+ *  \return bool True iff the attribute is the first operand
+ */
+
+/*! \fn double dlvhex::dd::util::DecisionDiagramFile::getCmpValue(int d, EdgeId e) const
+ * Returns the parsed comparison value of the condition of an edge (see DecisionDiagram::Condition::getCmpValue).
+ *  \param d A diagram index
+ *  \param e An edge id
+ *  \return double The numeric comparison value (0 if hasCmpValue is false)
+ */
+
+/*! \fn void dlvhex::dd::util::DecisionDiagramFile::toDecisionDiagram(int d, DecisionDiagram& dd) const
+ * Converts a diagram of this file into a DecisionDiagram. Each string of the file is interned at most once.
+ *  \param d A diagram index
+ *  \param dd Receives the diagram (previous contents are removed)
+ */
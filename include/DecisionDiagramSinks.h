@@ -0,0 +1,130 @@
+#ifndef _DECISIONDIAGRAMSINKS_H_
+#define _DECISIONDIAGRAMSINKS_H_
+
+#include <dlvhex/AtomSet.h>
+#include <DecisionDiagram.h>
+#include <ostream>
+#include <sstream>
+#include <string>
+
+DLVHEX_NAMESPACE_USE
+
+namespace dlvhex{
+	namespace dd{
+		namespace util{
+
+			/**
+			 * \brief
+			 * Appends the atoms representing a decision diagram (see DecisionDiagram::toAnswerSet) to a caller-provided answer set.
+			 * The predicate names are built once per sink rather than once per atom.
+			 */
+			class AtomSetSink : public DecisionDiagram::Sink{
+			private:
+				AtomSet& as;
+				bool addIndex;
+				int index;
+				std::string innerNodePredicate, leafNodePredicate, conditionalEdgePredicate, elseEdgePredicate, rootPredicate;
+
+				void initPredicates();
+				Tuple newTuple() const;
+			public:
+				AtomSetSink(AtomSet& as_);
+				AtomSetSink(AtomSet& as_, int index_);
+
+				virtual void innerNode(const DecisionDiagram::Node* n);
+				virtual void leafNode(const DecisionDiagram::LeafNode* n);
+				virtual void conditionalEdge(const DecisionDiagram::Edge* e);
+				virtual void elseEdge(const DecisionDiagram::Edge* e);
+				virtual void rootNode(const DecisionDiagram::Node* n);
+			};
+
+			/**
+			 * \brief
+			 * Writes a decision diagram as DLV facts (one per line) with the predicates root, innernode, leafnode, conditionaledge and elseedge, i.e. the answer set representation of the diagram
+			 * is written without constructing the atoms.
+			 */
+			class DlvFactSink : public DecisionDiagram::Sink{
+			private:
+				std::ostream& out;
+			public:
+				DlvFactSink(std::ostream& out_);
+
+				virtual void innerNode(const DecisionDiagram::Node* n);
+				virtual void leafNode(const DecisionDiagram::LeafNode* n);
+				virtual void conditionalEdge(const DecisionDiagram::Edge* e);
+				virtual void elseEdge(const DecisionDiagram::Edge* e);
+				virtual void rootNode(const DecisionDiagram::Node* n);
+			};
+
+			/**
+			 * \brief
+			 * Writes a decision diagram in graphviz dot format. Node labels are shortened to the part before the first underscore (which is usually a suffix added to make labels unique).
+			 */
+			class DotSink : public DecisionDiagram::Sink{
+			private:
+				std::ostream& out;
+			public:
+				DotSink(std::ostream& out_);
+
+				virtual void begin(const DecisionDiagram& dd);
+				virtual void innerNode(const DecisionDiagram::Node* n);
+				virtual void leafNode(const DecisionDiagram::LeafNode* n);
+				virtual void conditionalEdge(const DecisionDiagram::Edge* e);
+				virtual void elseEdge(const DecisionDiagram::Edge* e);
+				virtual void rootNode(const DecisionDiagram::Node* n);
+				virtual void end();
+			};
+
+			/**
+			 * \brief
+			 * Writes the human-readable representation of a decision diagram (see DecisionDiagram::toString): a list of nodes followed by a list of edges.
+			 */
+			class TextSink : public DecisionDiagram::Sink{
+			private:
+				std::ostream& out;
+				std::stringstream edgeList;	// edges are collected while the nodes are written
+				bool first;
+			public:
+				TextSink(std::ostream& out_);
+
+				virtual void begin(const DecisionDiagram& dd);
+				virtual void innerNode(const DecisionDiagram::Node* n);
+				virtual void leafNode(const DecisionDiagram::LeafNode* n);
+				virtual void conditionalEdge(const DecisionDiagram::Edge* e);
+				virtual void elseEdge(const DecisionDiagram::Edge* e);
+				virtual void rootNode(const DecisionDiagram::Node* n);
+				virtual void end();
+			};
+		}
+	}
+}
+
+#endif
+
+
+/*! \fn dlvhex::dd::util::AtomSetSink::AtomSetSink(AtomSet& as_)
+ * Creates a sink which inserts the atoms root(Name), innernode(Label), leafnode(Label, Classification), conditionaledge(Node1, Node2, Operand1, comparisonOperator, Operand2) and elseedge(Node1, Node2) into an answer set.
+ *  \param as_ The answer set to extend; it must live at least as long as the sink
+ */
+
+/*! \fn dlvhex::dd::util::AtomSetSink::AtomSetSink(AtomSet& as_, int index_)
+ * Creates a sink which inserts the atoms rootIn(Index, Name), innernodeIn(Index, Label), leafnodeIn(Index, Label, Classification), conditionaledgeIn(Index, Node1, Node2, Operand1, comparisonOperator, Operand2)
+ * and elseedgeIn(Index, Node1, Node2) into an answer set.
+ *  \param as_ The answer set to extend; it must live at least as long as the sink
+ *  \param index_ The index to add at parameter position 0
+ */
+
+/*! \fn dlvhex::dd::util::DlvFactSink::DlvFactSink(std::ostream& out_)
+ * Creates a sink which writes DLV facts.
+ *  \param out_ The stream to write to
+ */
+
+/*! \fn dlvhex::dd::util::DotSink::DotSink(std::ostream& out_)
+ * Creates a sink which writes one dot graph per emitted diagram.
+ *  \param out_ The stream to write to
+ */
+
+/*! \fn dlvhex::dd::util::TextSink::TextSink(std::ostream& out_)
+ * Creates a sink which writes a human-readable list of nodes and edges.
+ *  \param out_ The stream to write to
+ */
@@ -0,0 +1,130 @@
+#ifndef _FLATBINARYTREE_H_
+#define _FLATBINARYTREE_H_
+
+#include <DecisionDiagram.h>
+#include <BatchClassifier.h>
+#include <SymbolTable.h>
+
+#include <boost/cstdint.hpp>
+
+#include <string>
+#include <vector>
+
+namespace dlvhex{
+	namespace dd{
+		namespace util{
+
+			/**
+			 * \brief
+			 * A flattened binary decision tree for fast classification of numeric data rows (as produced by the tobinarydecisiontree and orderbinarydecisiontree operators).
+			 * Each inner node must have exactly one conditional edge, which compares an attribute with a number, and one else edge. The nodes are stored level-wise (breadth-first from the root)
+			 * in flat arrays: the attribute index, the condition as closed interval [lower, upper] (strict comparisons are turned into non-strict ones with the next representable number,
+			 * such that the outcome is exactly the same) and the child indices. Leaf nodes point to themselves, such that all rows can be moved down the tree in lockstep for getDepth() steps.
+			 * This allows for evaluating several rows per instruction: on CPUs with AVX2, the nodes, attribute values and children of 4 rows are fetched with gather instructions
+			 * (two groups of 4 rows are interleaved to hide the latency); otherwise a scalar kernel is used. The kernel is selected at runtime.
+			 */
+			class FlatBinaryTree{
+			public:
+				enum Kernel{
+					scalar,
+					avx2
+				};
+
+			private:
+				std::vector<SymbolTable::Id> attributes;		// attribute names (ordered lexically); the index of an attribute is its column in the data rows
+				std::vector<boost::int32_t> nodeAttributes;		// attribute index of each node (0 for leaf nodes)
+				std::vector<double> lower, upper;			// condition of each node: lower <= value <= upper
+				std::vector<boost::int32_t> children;			// child if the condition is satisfied (2 * i) or not (2 * i + 1); leaf nodes point to themselves
+				std::vector<SymbolTable::Id> classifications;		// classification of each node (SymbolTable::empty for inner nodes)
+				int depth;
+			public:
+				FlatBinaryTree(const DecisionDiagram& dd);
+
+				int nodeCount() const;
+				int getDepth() const;
+				int getAttributeCount() const;
+				const std::string& getAttribute(int index) const;
+				int getAttributeIndex(const std::string& attribute) const;
+
+				static bool isSupported(Kernel kernel);
+				static Kernel getDefaultKernel();
+
+				void classify(const double* rows, int rowCount, SymbolTable::Id* result) const;
+				void classify(const double* rows, int rowCount, SymbolTable::Id* result, Kernel kernel) const;
+				void classify(const BatchClassifier::Batch& batch, std::vector<SymbolTable::Id>& result) const;
+			};
+		}
+	}
+}
+
+#endif
+
+
+/*! \fn dlvhex::dd::util::FlatBinaryTree::FlatBinaryTree(const DecisionDiagram& dd)
+ * Flattens a binary decision diagram. The diagram does not need to be a tree (shared subdiagrams are stored once), but it must be acyclic. Since the flattened tree is independent of the
+ * diagram, the diagram may be modified or destroyed afterwards.
+ *  \param dd A binary decision diagram
+ *  \throws InvalidDecisionDiagram If the diagram has no root, contains cycles, or contains an inner node which does not have exactly one numeric condition and one else edge
+ */
+
+/*! \fn int dlvhex::dd::util::FlatBinaryTree::nodeCount() const
+ * Returns the number of (reachable) nodes.
+ *  \return int Number of nodes
+ */
+
+/*! \fn int dlvhex::dd::util::FlatBinaryTree::getDepth() const
+ * Returns the length of the longest path from the root to a leaf node, i.e. the number of steps needed to classify a row.
+ *  \return int The depth of the tree
+ */
+
+/*! \fn int dlvhex::dd::util::FlatBinaryTree::getAttributeCount() const
+ * Returns the number of attributes tested by the tree, i.e. the number of values of each data row.
+ *  \return int Number of attributes
+ */
+
+/*! \fn const std::string& dlvhex::dd::util::FlatBinaryTree::getAttribute(int index) const
+ * Returns the name of an attribute.
+ *  \param index An attribute index between 0 and getAttributeCount() - 1
+ *  \return const std::string& The name of the attribute stored in column index of the data rows
+ */
+
+/*! \fn int dlvhex::dd::util::FlatBinaryTree::getAttributeIndex(const std::string& attribute) const
+ * Looks up the column of an attribute.
+ *  \param attribute An attribute name
+ *  \return int The index of the attribute or -1 if it is not tested by the tree
+ */
+
+/*! \fn static bool dlvhex::dd::util::FlatBinaryTree::isSupported(Kernel kernel)
+ * Checks if a kernel can be used on this machine (i.e. it was compiled in and the CPU supports the required instructions).
+ *  \param kernel A kernel
+ *  \return bool True iff the kernel can be used
+ */
+
+/*! \fn static Kernel dlvhex::dd::util::FlatBinaryTree::getDefaultKernel()
+ * Returns the fastest kernel which is supported on this machine.
+ *  \return Kernel The kernel used by classify if no kernel is given
+ */
+
+/*! \fn void dlvhex::dd::util::FlatBinaryTree::classify(const double* rows, int rowCount, SymbolTable::Id* result) const
+ * Classifies data rows using the default kernel.
+ *  \param rows The data rows in row-major order, i.e. value j of row i is stored at rows[i * getAttributeCount() + j]. Missing values can be represented as NaN; they do not satisfy any condition.
+ *  \param rowCount The number of rows
+ *  \param result Receives the classification of each row (rowCount symbols)
+ */
+
+/*! \fn void dlvhex::dd::util::FlatBinaryTree::classify(const double* rows, int rowCount, SymbolTable::Id* result, Kernel kernel) const
+ * Classifies data rows using a certain kernel. All kernels yield the same results.
+ *  \param rows The data rows in row-major order (see above)
+ *  \param rowCount The number of rows
+ *  \param result Receives the classification of each row (rowCount symbols)
+ *  \param kernel The kernel to use
+ *  \throws InvalidDecisionDiagram If the kernel is not supported on this machine
+ */
+
+/*! \fn void dlvhex::dd::util::FlatBinaryTree::classify(const BatchClassifier::Batch& batch, std::vector<SymbolTable::Id>& result) const
+ * Classifies a column-major batch (see BatchClassifier). The batch is transposed block-wise. Symbolic values are converted to numbers (non-numeric values are treated as missing), such that
+ * the result is the same as the one of BatchClassifier::classify.
+ *  \param batch The data rows
+ *  \param result Receives the classification of each row
+ *  \throws BatchClassifier::InvalidBatch If the batch does not contain a column for an attribute of the tree
+ */
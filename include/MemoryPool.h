@@ -0,0 +1,82 @@
+#ifndef _MEMORYPOOL_H_
+#define _MEMORYPOOL_H_
+
+#include <vector>
+#include <cstddef>
+
+namespace dlvhex{
+	namespace dd{
+		namespace util{
+
+			/**
+			 * \brief
+			 * A simple slab allocator for objects of (at most) a fixed size.
+			 * Memory is requested from the system in chunks of many slots. Slots which are given back are kept in a free list and reused by subsequent allocations.
+			 * The pool does not know anything about the objects stored in it, i.e. the caller is responsible for constructing (placement new) and destructing them.
+			 * Since all slots of a chunk are adjacent, objects which are allocated together are also close together in memory.
+			 */
+			class MemoryPool{
+			private:
+				std::size_t slotSize;		// size of one slot in bytes (rounded up to the alignment boundary)
+				std::size_t chunkSlots;		// number of slots in the next chunk to allocate
+				std::vector<char*> chunks;	// all chunks allocated so far
+				char* next;			// next unused slot in the most recent chunk
+				char* end;			// end of the most recent chunk
+				void* freeList;			// slots which were given back (linked through their first bytes)
+				std::size_t liveCount;		// number of slots currently in use
+
+				// pools own raw memory and must not be copied
+				MemoryPool(const MemoryPool&);
+				MemoryPool& operator=(const MemoryPool&);
+
+				void allocateChunk();
+			public:
+				MemoryPool(std::size_t objectSize);
+				~MemoryPool();
+
+				void* allocate();
+				void deallocate(void* p);
+				void releaseAll();
+				void swap(MemoryPool& pool2);
+
+				std::size_t size() const;
+			};
+		}
+	}
+}
+
+#endif
+
+
+/*! \fn dlvhex::dd::util::MemoryPool::MemoryPool(std::size_t objectSize)
+ * Creates an empty pool for objects of a certain size. No memory is allocated until the first call of allocate().
+ * \param objectSize The maximum size of the objects to store in this pool (e.g. sizeof(T))
+ */
+
+/*! \fn dlvhex::dd::util::MemoryPool::~MemoryPool()
+ * Destructor. Frees all chunks at once. Note that no destructors of the stored objects are called.
+ */
+
+/*! \fn void* dlvhex::dd::util::MemoryPool::allocate()
+ * Returns memory for one object. Previously freed slots are reused first, otherwise the slot is taken from the current chunk (a new one is allocated if necessary).
+ *  \return void* A pointer to uninitialized memory of at least the object size given in the constructor.
+ */
+
+/*! \fn void dlvhex::dd::util::MemoryPool::deallocate(void* p)
+ * Gives a slot back to the pool. The object stored in it must already have been destructed.
+ * \param p A pointer which was returned by allocate() of this pool
+ */
+
+/*! \fn void dlvhex::dd::util::MemoryPool::releaseAll()
+ * Frees all chunks of this pool in bulk. All objects stored in the pool must already have been destructed, pointers into the pool become invalid.
+ */
+
+/*! \fn void dlvhex::dd::util::MemoryPool::swap(MemoryPool& pool2)
+ * Exchanges the chunks (and thus all stored objects) of this pool with those of another one in constant time. Pointers into both pools remain valid.
+ * \param pool2 Another pool
+ */
+
+/*! \fn std::size_t dlvhex::dd::util::MemoryPool::size() const
+ * Returns the number of slots which are currently in use.
+ *  \return std::size_t Number of allocated and not yet deallocated slots
+ */
@@ -3,6 +3,7 @@
 
 #include "dlvhex-mergingplugin/IOperator.h"
 #include <DecisionDiagram.h>
+#include <CompactDecisionDiagram.h>
 
 DLVHEX_NAMESPACE_USE
 
@@ -24,11 +25,12 @@ namespace dlvhex{
 			 * </pre>
 			 */
 			class OpAvg : public IOperator{
-				DecisionDiagram::Condition getCondition(DecisionDiagram::Node* node);
-				DecisionDiagram::Node* averageLeafs(DecisionDiagram& result, DecisionDiagram* dd1, DecisionDiagram::LeafNode* leaf1, DecisionDiagram* dd2, DecisionDiagram::LeafNode* leaf2);
-				DecisionDiagram::Node* averageInner(DecisionDiagram& result, DecisionDiagram* dd1, DecisionDiagram::Node* inner1, DecisionDiagram* dd2, DecisionDiagram::Node* inner2);
-				DecisionDiagram::Node* averageInnerLeaf(DecisionDiagram& result, DecisionDiagram* innerdiag, DecisionDiagram::Node* inner, DecisionDiagram* leafdiag, DecisionDiagram::LeafNode* leaf);
-				DecisionDiagram::Node* average(DecisionDiagram& result, DecisionDiagram* dd1, DecisionDiagram::Node* n1, DecisionDiagram* dd2, DecisionDiagram::Node* n2);
+				class Averaging;
+				friend class Averaging;
+
+				CompactDecisionDiagram::EdgeId getConditionalEdge(const CompactDecisionDiagram& dd, CompactDecisionDiagram::NodeId node);
+				DecisionDiagram::Node* averageLeafs(DecisionDiagram& result, const CompactDecisionDiagram& dd1, CompactDecisionDiagram::NodeId leaf1, const CompactDecisionDiagram& dd2, CompactDecisionDiagram::NodeId leaf2);
+				DecisionDiagram::Node* average(DecisionDiagram& result, const CompactDecisionDiagram& dd1, CompactDecisionDiagram::NodeId n1, const CompactDecisionDiagram& dd2, CompactDecisionDiagram::NodeId n2);
 			public:
 				virtual std::string getName();
 				virtual std::string getInfo();
@@ -34,15 +34,16 @@ namespace dlvhex{
 			 */
 			class OpDistributionMapVoting : public OpMajorityVoting{
 			protected:
-				virtual void insert(DecisionDiagram& input, DecisionDiagram& output);
+				virtual void insert(DecisionDiagram& input, DecisionDiagram& output, VoteTable& votes);
 			private:
 				float eps;
+				static int* toVotes(VoteTable& votes, const std::string& classification);
 			public:
 				virtual std::string getName();
 				virtual std::string getInfo();
 				virtual std::set<std::string> getRecognizedParameters();
 				virtual HexAnswer apply(int arity, std::vector<HexAnswer*>& answers, OperatorArguments& parameters) throw (OperatorException);
-				virtual std::vector<DecisionDiagram> extractDiagrams(float eps, DecisionDiagram& diag);
+				virtual void extractDiagrams(float eps, DecisionDiagram& diag, VoteTable& votes, HexAnswer& result);
 			};
 		}
 	}
@@ -3,6 +3,7 @@
 
 #include "dlvhex-mergingplugin/IOperator.h"
 #include <DecisionDiagram.h>
+#include <VoteTable.h>
 
 DLVHEX_NAMESPACE_USE
 
@@ -26,14 +27,11 @@ namespace dlvhex{
 			 */
 			class OpMajorityVoting : public IOperator{
 			protected:
-				typedef std::map<std::string, int> Votings;
-				/**
-				 * Stores a map containing labels (strings) paired with their voting counts (integers).
-				 */
-				struct Votes : public DecisionDiagram::LeafNode::Data{
-					Votings v;
-				};
-				virtual void insert(DecisionDiagram& input, DecisionDiagram& output);
+				static void collectClasses(const DecisionDiagram& dd, std::set<std::string>& classes);
+				static void groupByVotes(const DecisionDiagram& output, const VoteTable& votes, std::vector<std::vector<DecisionDiagram::LeafNode*> >& groups);
+				static void replaceLeaf(DecisionDiagram& output, VoteTable& votes, DecisionDiagram::LeafNode* leaf, DecisionDiagram::Node* subdiagram);
+				static void unfoldShared(DecisionDiagram& dd, VoteTable& votes);
+				virtual void insert(DecisionDiagram& input, DecisionDiagram& output, VoteTable& votes);
 			public:
 				virtual std::string getName();
 				virtual std::string getInfo();
@@ -24,6 +24,11 @@ namespace dlvhex{
 			 */
 			class OpOrderBinaryDecisionTree : public IOperator{
 			private:
+				class Sinking;
+				class Ordering;
+				friend class Sinking;
+				friend class Ordering;
+
 				std::string getCompareAttribute(DecisionDiagram::Node* node);
 				DecisionDiagram::Node* sink(DecisionDiagram& dd, DecisionDiagram::Node* root);
 				DecisionDiagram::Node* order(DecisionDiagram& dd, DecisionDiagram::Node* root);
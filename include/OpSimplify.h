@@ -25,8 +25,8 @@ namespace dlvhex{
 			class OpSimplify : public IOperator{
 			private:
 				DecisionDiagram::Node* reduceSubgraph(DecisionDiagram& dd, DecisionDiagram::Node* n);
-				void removeConnectiveComponent(DecisionDiagram& dd, DecisionDiagram::Node* n);
-				DecisionDiagram simplify(DecisionDiagram dd);
+				DecisionDiagram::Node* share(DecisionDiagram& result, DecisionDiagram::Node* n);
+				void simplify(DecisionDiagram& dd);
 			public:
 				virtual std::string getName();
 				virtual std::string getInfo();
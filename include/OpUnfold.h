@@ -24,7 +24,7 @@ namespace dlvhex{
 			 */
 			class OpUnfold : public IOperator{
 			private:
-				DecisionDiagram unfold(DecisionDiagram::Node* root, DecisionDiagram& ddin);
+				DecisionDiagram::Node* unfold(DecisionDiagram::Node* root, DecisionDiagram& ddResult);
 			public:
 				virtual std::string getName();
 				virtual std::string getInfo();
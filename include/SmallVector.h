@@ -0,0 +1,124 @@
+#ifndef _SMALLVECTOR_H_
+#define _SMALLVECTOR_H_
+
+#include <cstddef>
+
+namespace dlvhex{
+	namespace dd{
+		namespace util{
+
+			/**
+			 * \brief
+			 * A vector which stores up to N elements inline (i.e. without any heap allocation) and switches to heap storage only if it grows beyond that.
+			 * It is intended for small collections of trivially copyable elements (such as pointers) which are mostly short, e.g. the ingoing and outgoing edges of a node.
+			 * Elements are kept in insertion order; iteration is over contiguous memory.
+			 */
+			template<class T, std::size_t N> class SmallVector{
+			private:
+				T inlineStorage[N];	// used as long as the vector has at most N elements
+				T* elements;		// either inlineStorage or a heap array
+				std::size_t count;
+				std::size_t capacity;
+
+				void grow(){
+					std::size_t newCapacity = capacity * 2;
+					T* newElements = new T[newCapacity];
+					for (std::size_t i = 0; i < count; i++) newElements[i] = elements[i];
+					if (elements != inlineStorage) delete[] elements;
+					elements = newElements;
+					capacity = newCapacity;
+				}
+
+			public:
+				typedef T* iterator;
+				typedef const T* const_iterator;
+
+				SmallVector() : elements(inlineStorage), count(0), capacity(N){
+				}
+
+				SmallVector(const SmallVector& v) : elements(inlineStorage), count(0), capacity(N){
+					*this = v;
+				}
+
+				~SmallVector(){
+					if (elements != inlineStorage) delete[] elements;
+				}
+
+				SmallVector& operator=(const SmallVector& v){
+					if (this == &v) return *this;
+					clear();
+					for (std::size_t i = 0; i < v.count; i++) push_back(v.elements[i]);
+					return *this;
+				}
+
+				std::size_t size() const{
+					return count;
+				}
+
+				bool empty() const{
+					return count == 0;
+				}
+
+				T& operator[](std::size_t index){
+					return elements[index];
+				}
+
+				const T& operator[](std::size_t index) const{
+					return elements[index];
+				}
+
+				iterator begin(){
+					return elements;
+				}
+
+				iterator end(){
+					return elements + count;
+				}
+
+				const_iterator begin() const{
+					return elements;
+				}
+
+				const_iterator end() const{
+					return elements + count;
+				}
+
+				T& back(){
+					return elements[count - 1];
+				}
+
+				void push_back(const T& t){
+					if (count == capacity) grow();
+					elements[count++] = t;
+				}
+
+				void pop_back(){
+					count--;
+				}
+
+				// Returns the index of the first occurrence of t or -1 if t is not contained
+				int find(const T& t) const{
+					for (std::size_t i = 0; i < count; i++){
+						if (elements[i] == t) return i;
+					}
+					return -1;
+				}
+
+				// Removes the element at a certain index; the order of the remaining elements is preserved
+				void erase(std::size_t index){
+					for (std::size_t i = index + 1; i < count; i++) elements[i - 1] = elements[i];
+					count--;
+				}
+
+				void clear(){
+					if (elements != inlineStorage) delete[] elements;
+					elements = inlineStorage;
+					count = 0;
+					capacity = N;
+				}
+			};
+		}
+	}
+}
+
+#endif
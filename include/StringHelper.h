@@ -43,6 +43,7 @@ namespace dlvhex{
 				static std::string toString(double v);
 				static int atoi(std::string str);
 				static double atof(std::string str);
+				static bool tryAtof(const std::string& str, double& value);
 			};
 		}
 	}
@@ -122,3 +123,10 @@ namespace dlvhex{
  * \param str Input
  *  \return double The double value of str
  */
+
+/*! \fn static bool dlvhex::dd::util::StringHelper::tryAtof(const std::string& str, double& value)
+ * Converts the input into a double value like atof, but reports failure by the return value instead of an exception.
+ * \param str Input
+ * \param value Will be set to the double value of str (if str contains a valid double value)
+ *  \return bool True iff str contains a valid double value
+ */
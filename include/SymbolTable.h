@@ -0,0 +1,128 @@
+#ifndef _SYMBOLTABLE_H_
+#define _SYMBOLTABLE_H_
+
+#include <boost/cstdint.hpp>
+#include <boost/unordered_map.hpp>
+#include <deque>
+#include <vector>
+#include <string>
+
+namespace dlvhex{
+	namespace dd{
+		namespace util{
+
+			/**
+			 * \brief
+			 * A global table of interned strings. Each distinct string is stored exactly once and identified by a 32-bit symbol id, such that node labels, condition operands
+			 * and classifications can be stored and compared as integers. Strings are materialized only where they are really needed (output generation, error messages).
+			 * Only the vocabulary of diagrams (labels, operands, classifications and attribute names) is interned; data values (e.g. the rows of a batch) must not be interned.
+			 * Symbols are removed only by leaving a Scope, which releases all symbols interned within it. Code which does not open a scope keeps its ids and the references
+			 * returned by lookup valid for the lifetime of the program. Each operator application opens a scope, such that the symbols of intermediate and generated diagrams
+			 * (e.g. unique labels and averaged thresholds) do not accumulate in long-running processes.
+			 * Each string is also parsed as number once when it is interned, such that numeric operands do not need to be parsed again and again.
+			 * Note: The table is not synchronized, as the plugin is used single-threaded only.
+			 */
+			class SymbolTable{
+			public:
+				typedef boost::uint32_t Id;
+
+				// The id of the empty string (used e.g. for the operands of else conditions)
+				static const Id empty = 0;
+
+			private:
+				// Hashing and equality of the strings stored in the table (the index refers to the stored strings instead of holding a second copy)
+				struct StringPtrHash{
+					std::size_t operator()(const std::string* s) const;
+				};
+				struct StringPtrEqual{
+					bool operator()(const std::string* s1, const std::string* s2) const;
+				};
+
+				std::deque<std::string> strings;	// a deque does not move it's elements when growing
+				boost::unordered_map<const std::string*, Id, StringPtrHash, StringPtrEqual> ids;
+				std::vector<bool> numeric;		// true iff the according string is a number
+				std::vector<double> values;		// numeric value of the according string (0 if it is no number)
+
+				SymbolTable();
+				static SymbolTable& instance();
+			public:
+				/**
+				 * \brief
+				 * Releases all symbols which were interned during its lifetime when it is destroyed. Scopes must be nested (which is guaranteed for local variables) and no id
+				 * or string of a released symbol may be used afterwards, i.e. all diagrams which refer to such symbols must be destroyed before the scope.
+				 */
+				class Scope{
+				private:
+					std::size_t mark;
+
+					// a scope releases the symbols once and must not be copied
+					Scope(const Scope&);
+					Scope& operator=(const Scope&);
+				public:
+					Scope();
+					~Scope();
+				};
+
+				static Id intern(const std::string& str);
+				static bool find(const std::string& str, Id& id);
+				static const std::string& lookup(Id id);
+				static bool isNumeric(Id id);
+				static double getNumericValue(Id id);
+				static std::size_t size();
+				static void release(std::size_t mark);
+			};
+		}
+	}
+}
+
+#endif
+
+
+/*! \fn static Id dlvhex::dd::util::SymbolTable::intern(const std::string& str)
+ * Returns the symbol id of a string. If the string was not interned before, it is added to the table.
+ *  \param str An arbitrary string
+ *  \return Id The symbol id of str
+ */
+
+/*! \fn static bool dlvhex::dd::util::SymbolTable::find(const std::string& str, Id& id)
+ * Looks up the symbol id of a string without adding it to the table. Useful for lookups of strings which will not be stored (e.g. label queries).
+ *  \param str An arbitrary string
+ *  \param id Will be set to the symbol id of str if it is contained in the table
+ *  \return bool True iff str was interned before
+ */
+
+/*! \fn static const std::string& dlvhex::dd::util::SymbolTable::lookup(Id id)
+ * Returns the string of a symbol.
+ *  \param id A symbol id which was returned by intern or find
+ *  \return const std::string& The interned string (valid for the lifetime of the program)
+ */
+
+/*! \fn static bool dlvhex::dd::util::SymbolTable::isNumeric(Id id)
+ * Checks if the string of a symbol is a number (see StringHelper::atof). The check is answered from the cache, i.e. the string is not parsed again.
+ *  \param id A symbol id
+ *  \return bool True iff the string of the symbol is a valid double value
+ */
+
+/*! \fn static double dlvhex::dd::util::SymbolTable::getNumericValue(Id id)
+ * Returns the numeric value of a symbol (see isNumeric).
+ *  \param id A symbol id
+ *  \return double The value of the string of the symbol or 0 if it is no number
+ */
+
+/*! \fn static std::size_t dlvhex::dd::util::SymbolTable::size()
+ * Returns the number of interned strings.
+ *  \return std::size_t Number of distinct strings in the table
+ */
+
+/*! \fn static void dlvhex::dd::util::SymbolTable::release(std::size_t mark)
+ * Removes all symbols with an id of at least mark (i.e. the symbols interned after size() returned mark). The empty string is never removed. Usually called by Scope.
+ *  \param mark A previous result of size()
+ */
+
+/*! \fn dlvhex::dd::util::SymbolTable::Scope::Scope()
+ * Opens a scope: remembers the current size of the table.
+ */
+
+/*! \fn dlvhex::dd::util::SymbolTable::Scope::~Scope()
+ * Closes the scope: releases all symbols which were interned since it was opened.
+ */
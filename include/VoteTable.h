@@ -0,0 +1,142 @@
+#ifndef _VOTETABLE_H_
+#define _VOTETABLE_H_
+
+#include <DecisionDiagram.h>
+#include <MemoryPool.h>
+#include <SymbolTable.h>
+
+#include <boost/unordered_map.hpp>
+
+#include <set>
+#include <string>
+#include <vector>
+
+namespace dlvhex{
+	namespace dd{
+		namespace util{
+
+			/**
+			 * \brief
+			 * Stores the votes of the leaf nodes of a decision diagram (used by the voting operators).
+			 * The classes are numbered densely by a dictionary which is fixed at construction and sorted lexically, i.e. iterating over the class ids visits the classes in the same order as a
+			 * std::map<std::string, int> would. The votes of a leaf node are a vector of fixed width (one counter per class, or VoteTable::absent for classes which were never voted for).
+			 * All vectors are allocated from an arena owned by the table. Vectors are reference counted: leaf nodes with equal votes can share one vector, which is copied as soon as
+			 * one of them is modified (copy-on-write).
+			 */
+			class VoteTable{
+			public:
+				typedef int ClassId;
+				static const int absent;		// counter value of a class which was never voted for
+			private:
+				std::vector<SymbolTable::Id> classes;				// class names (ordered lexically)
+				boost::unordered_map<SymbolTable::Id, ClassId> classIds;	// inverse of classes
+				MemoryPool arena;						// slots consist of a reference counter followed by the counters
+				boost::unordered_map<const DecisionDiagram::LeafNode*, int*> votes;
+
+				// vote tables own raw memory and must not be copied
+				VoteTable(const VoteTable&);
+				VoteTable& operator=(const VoteTable&);
+
+				static int& refCount(const int* v);
+			public:
+				VoteTable(const std::set<std::string>& classNames);
+				~VoteTable();
+
+				int getWidth() const;
+				ClassId getClassId(const std::string& className) const;
+				ClassId getClassId(SymbolTable::Id className) const;
+				const std::string& getClassName(ClassId c) const;
+
+				int* newVotes();
+				int* copyVotes(const int* v);
+				void release(const int* v);
+
+				const int* getVotes(const DecisionDiagram::LeafNode* leaf) const;
+				int* getMutableVotes(const DecisionDiagram::LeafNode* leaf);
+				void attach(const DecisionDiagram::LeafNode* leaf, int* v);
+				void share(const DecisionDiagram::LeafNode* leaf, const DecisionDiagram::LeafNode* original);
+				void detach(const DecisionDiagram::LeafNode* leaf);
+			};
+		}
+	}
+}
+
+#endif
+
+
+/*! \fn dlvhex::dd::util::VoteTable::VoteTable(const std::set<std::string>& classNames)
+ * Creates an empty vote table for a fixed set of classes.
+ *  \param classNames All classes which may receive votes (classes which are not contained cannot be voted for)
+ */
+
+/*! \fn dlvhex::dd::util::VoteTable::~VoteTable()
+ * Destructor. Frees all vote vectors at once.
+ */
+
+/*! \fn int dlvhex::dd::util::VoteTable::getWidth() const
+ * Returns the number of classes, i.e. the number of counters of each vote vector.
+ *  \return int The width of the vote vectors
+ */
+
+/*! \fn ClassId dlvhex::dd::util::VoteTable::getClassId(const std::string& className) const
+ * Looks up the index of a class within the vote vectors.
+ *  \param className The name of a class
+ *  \return ClassId The index of the class or -1 if the class is unknown
+ */
+
+/*! \fn ClassId dlvhex::dd::util::VoteTable::getClassId(SymbolTable::Id className) const
+ * Looks up the index of a class within the vote vectors without hashing the class name.
+ *  \param className The name of a class (interned)
+ *  \return ClassId The index of the class or -1 if the class is unknown
+ */
+
+/*! \fn const std::string& dlvhex::dd::util::VoteTable::getClassName(ClassId c) const
+ * Returns the name of a class.
+ *  \param c A class id between 0 and getWidth() - 1
+ *  \return const std::string& The name of the class
+ */
+
+/*! \fn int* dlvhex::dd::util::VoteTable::newVotes()
+ * Allocates a vote vector in which all classes are absent. The caller holds one reference, which must be given back using release (possibly after the vector was attached to leaf nodes).
+ *  \return int* A vector of getWidth() counters
+ */
+
+/*! \fn int* dlvhex::dd::util::VoteTable::copyVotes(const int* v)
+ * Allocates a copy of a vote vector. The caller holds one reference (see newVotes).
+ *  \param v A vector of this table
+ *  \return int* A vector of getWidth() counters
+ */
+
+/*! \fn void dlvhex::dd::util::VoteTable::release(const int* v)
+ * Gives back one reference to a vote vector. The vector is returned to the arena as soon as no references remain.
+ *  \param v A vector of this table
+ */
+
+/*! \fn const int* dlvhex::dd::util::VoteTable::getVotes(const DecisionDiagram::LeafNode* leaf) const
+ * Retrieves the votes of a leaf node.
+ *  \param leaf A leaf node
+ *  \return const int* The vote vector of the leaf node or NULL if no votes were attached to it
+ */
+
+/*! \fn int* dlvhex::dd::util::VoteTable::getMutableVotes(const DecisionDiagram::LeafNode* leaf)
+ * Retrieves the votes of a leaf node for modification. If the vector is shared, the leaf node receives a copy first.
+ *  \param leaf A leaf node
+ *  \return int* The (unshared) vote vector of the leaf node or NULL if no votes were attached to it
+ */
+
+/*! \fn void dlvhex::dd::util::VoteTable::attach(const DecisionDiagram::LeafNode* leaf, int* v)
+ * Attaches a vote vector to a leaf node. The vector is shared, not copied. Votes which were attached to the leaf node before are released.
+ *  \param leaf A leaf node
+ *  \param v A vector of this table
+ */
+
+/*! \fn void dlvhex::dd::util::VoteTable::share(const DecisionDiagram::LeafNode* leaf, const DecisionDiagram::LeafNode* original)
+ * Attaches the votes of another leaf node to a leaf node (e.g. to a copy of the other one). The vector is shared until one of the leaf nodes is modified (see getMutableVotes).
+ *  \param leaf A leaf node
+ *  \param original A leaf node whose votes are shared (nothing is attached if it has no votes)
+ */
+
+/*! \fn void dlvhex::dd::util::VoteTable::detach(const DecisionDiagram::LeafNode* leaf)
+ * Releases the votes of a leaf node. Must be called before the leaf node is removed from its diagram, since the node's memory may be reused by other nodes.
+ *  \param leaf A leaf node
+ */
@@ -0,0 +1,269 @@
+#include <BatchClassifier.h>
+#include <StringHelper.h>
+
+#include <functional>
+#include <sstream>
+
+using namespace dlvhex::dd::util;
+
+
+// ------------------------------ InvalidBatch ------------------------------
+
+BatchClassifier::InvalidBatch::InvalidBatch(std::string m) : msg(m){
+}
+
+std::string BatchClassifier::InvalidBatch::getMessage(){
+	return msg;
+}
+
+
+// ------------------------------ Batch ------------------------------
+
+BatchClassifier::Batch::Batch(int rowCount_) : rowCount(rowCount_){
+}
+
+BatchClassifier::Batch::ValueId BatchClassifier::Batch::addValue(const std::string& str){
+	std::pair<boost::unordered_map<std::string, ValueId>::iterator, bool> inserted = valueIndex.insert(std::pair<std::string, ValueId>(str, values.size()));
+	if (!inserted.second) return inserted.first->second;
+
+	// new value: parse it once (it is not interned, see BatchClassifier::classify)
+	Value v;
+	v.str = &inserted.first->first;
+	v.number = 0.0;
+	v.numeric = StringHelper::tryAtof(str, v.number);
+	if (!v.numeric) v.number = 0.0;
+	values.push_back(v);
+	return inserted.first->second;
+}
+
+void BatchClassifier::Batch::addColumn(const std::string& attribute, const std::vector<double>& values){
+	if ((int)values.size() != rowCount){
+		std::stringstream msg;
+		msg << "Column \"" << attribute << "\" has " << values.size() << " values, but the batch has " << rowCount << " rows.";
+		throw InvalidBatch(msg.str());
+	}
+	SymbolTable::Id a = SymbolTable::intern(attribute);
+	symbolicColumns.erase(a);
+	numericColumns[a] = values;
+}
+
+void BatchClassifier::Batch::addColumn(const std::string& attribute, const std::vector<std::string>& values){
+	if ((int)values.size() != rowCount){
+		std::stringstream msg;
+		msg << "Column \"" << attribute << "\" has " << values.size() << " values, but the batch has " << rowCount << " rows.";
+		throw InvalidBatch(msg.str());
+	}
+	SymbolTable::Id a = SymbolTable::intern(attribute);
+	numericColumns.erase(a);
+	std::vector<ValueId>& column = symbolicColumns[a];
+	column.clear();
+	column.reserve(values.size());
+	for (std::vector<std::string>::const_iterator it = values.begin(); it != values.end(); it++){
+		column.push_back(addValue(*it));
+	}
+}
+
+int BatchClassifier::Batch::getRowCount() const{
+	return rowCount;
+}
+
+int BatchClassifier::Batch::getValueCount() const{
+	return values.size();
+}
+
+const std::vector<double>* BatchClassifier::Batch::getNumericColumn(SymbolTable::Id attribute) const{
+	boost::unordered_map<SymbolTable::Id, std::vector<double> >::const_iterator it = numericColumns.find(attribute);
+	return it == numericColumns.end() ? NULL : &it->second;
+}
+
+const std::vector<BatchClassifier::Batch::ValueId>* BatchClassifier::Batch::getSymbolicColumn(SymbolTable::Id attribute) const{
+	boost::unordered_map<SymbolTable::Id, std::vector<ValueId> >::const_iterator it = symbolicColumns.find(attribute);
+	return it == symbolicColumns.end() ? NULL : &it->second;
+}
+
+const BatchClassifier::Batch::Value& BatchClassifier::Batch::getValue(ValueId v) const{
+	return values[v];
+}
+
+
+// ------------------------------ BatchClassifier ------------------------------
+
+const SymbolTable::Id BatchClassifier::noSymbol;
+
+namespace{
+	// Moves the rows whose value satisfies a comparison from rows to matched (both lists keep their order).
+	// The comparison is a template parameter, such that the loop does not need to dispatch on the operator for each row.
+	template<class Cmp> void splitNumeric(const double* column, double threshold, Cmp cmp, std::vector<BatchClassifier::Row>& rows, std::vector<BatchClassifier::Row>& matched){
+		std::size_t kept = 0;
+		for (std::size_t i = 0; i < rows.size(); i++){
+			BatchClassifier::Row r = rows[i];
+			if (cmp(column[r], threshold)) matched.push_back(r);
+			else rows[kept++] = r;
+		}
+		rows.resize(kept);
+	}
+}
+
+BatchClassifier::BatchClassifier(const DecisionDiagram& dd) : root(-1){
+	if (dd.getRoot() == NULL) throw DecisionDiagram::InvalidDecisionDiagram("Tried to compile a decision diagram for classification. Error: The diagram has no root.");
+
+	// Number the nodes topologically (throws if the diagram contains cycles), such that all rows reaching a node are known before the node is visited
+	const std::vector<DecisionDiagram::Node*>& order = dd.getTopologicalOrder();
+	std::vector<int> position(order.size());
+	for (unsigned int i = 0; i < order.size(); i++){
+		position[dd.getNodeIndex(order[i])] = i;
+	}
+	root = position[dd.getNodeIndex(dd.getRoot())];
+
+	nodes.resize(order.size());
+	edges.reserve(dd.edgeCount());
+	for (unsigned int i = 0; i < order.size(); i++){
+		DecisionDiagram::Node* n = order[i];
+		CompiledNode& cn = nodes[i];
+		cn.leaf = n->isLeaf();
+		cn.classification = cn.leaf ? n->asLeaf()->getClassificationSymbol() : SymbolTable::empty;
+		cn.elseChild = -1;
+		cn.edgesBegin = edges.size();
+
+		DecisionDiagram::EdgeList outEdges = n->getOutEdgeRange();
+		for (DecisionDiagram::EdgeList::iterator it = outEdges.begin(); it != outEdges.end(); it++){
+			int child = position[dd.getNodeIndex((*it)->getTo())];
+			if ((*it)->isElse()){
+				// only the first else edge can ever be taken
+				if (cn.elseChild == -1) cn.elseChild = child;
+				continue;
+			}
+
+			DecisionDiagram::Condition c = (*it)->getCondition();
+			CompiledEdge ce;
+			ce.attribute = c.hasAttribute() ? c.getAttributeSymbol() : SymbolTable::empty;
+			ce.operation = c.getNormalizedOperation();
+			ce.numeric = c.hasCmpValue();
+			ce.threshold = c.getCmpValue();
+			ce.value = c.isAttributeLeft() ? c.getOperand2Symbol() : c.getOperand1Symbol();
+			ce.constantValue = false;
+			if (!c.hasAttribute()){
+				// both operands are numbers
+				ce.constantValue = compareNumbers(SymbolTable::getNumericValue(c.getOperand1Symbol()), c.getOperation(), SymbolTable::getNumericValue(c.getOperand2Symbol()));
+			}
+			ce.child = child;
+			edges.push_back(ce);
+		}
+		cn.edgesEnd = edges.size();
+	}
+}
+
+bool BatchClassifier::compareNumbers(double v, DecisionDiagram::Condition::CmpOp op, double operand){
+	switch (op){
+		case DecisionDiagram::Condition::lt: return v < operand;
+		case DecisionDiagram::Condition::le: return v <= operand;
+		case DecisionDiagram::Condition::eq: return v == operand;
+		case DecisionDiagram::Condition::ge: return v >= operand;
+		case DecisionDiagram::Condition::gt: return v > operand;
+		default: return false;
+	}
+}
+
+bool BatchClassifier::compareSymbols(const Batch::Value& v, SymbolTable::Id symbol, DecisionDiagram::Condition::CmpOp op, SymbolTable::Id operand){
+	// equal strings have equal symbols (values which are not in the symbol table are not equal to any operand)
+	if (op == DecisionDiagram::Condition::eq) return symbol == operand;
+	int cmp = v.str->compare(SymbolTable::lookup(operand));
+	switch (op){
+		case DecisionDiagram::Condition::lt: return cmp < 0;
+		case DecisionDiagram::Condition::le: return cmp <= 0;
+		case DecisionDiagram::Condition::ge: return cmp >= 0;
+		case DecisionDiagram::Condition::gt: return cmp > 0;
+		default: return false;
+	}
+}
+
+void BatchClassifier::split(const CompiledEdge& e, const Batch& batch, const std::vector<SymbolTable::Id>& symbols, std::vector<Row>& rows, std::vector<Row>& matched) const{
+	// Constant conditions
+	if (e.attribute == SymbolTable::empty){
+		if (e.constantValue){
+			matched.insert(matched.end(), rows.begin(), rows.end());
+			rows.clear();
+		}
+		return;
+	}
+
+	// Numeric column
+	const std::vector<double>* numericColumn = batch.getNumericColumn(e.attribute);
+	if (numericColumn != NULL){
+		// numeric columns cannot satisfy conditions with non-numeric operands
+		if (!e.numeric) return;
+		const double* column = &(*numericColumn)[0];
+		switch (e.operation){
+			case DecisionDiagram::Condition::lt: splitNumeric(column, e.threshold, std::less<double>(), rows, matched); break;
+			case DecisionDiagram::Condition::le: splitNumeric(column, e.threshold, std::less_equal<double>(), rows, matched); break;
+			case DecisionDiagram::Condition::eq: splitNumeric(column, e.threshold, std::equal_to<double>(), rows, matched); break;
+			case DecisionDiagram::Condition::ge: splitNumeric(column, e.threshold, std::greater_equal<double>(), rows, matched); break;
+			case DecisionDiagram::Condition::gt: splitNumeric(column, e.threshold, std::greater<double>(), rows, matched); break;
+			default: break;
+		}
+		return;
+	}
+
+	// Symbolic column
+	const std::vector<Batch::ValueId>* symbolicColumn = batch.getSymbolicColumn(e.attribute);
+	if (symbolicColumn == NULL) throw InvalidBatch(std::string("The batch does not contain a column for attribute \"") + SymbolTable::lookup(e.attribute) + std::string("\"."));
+	const Batch::ValueId* column = &(*symbolicColumn)[0];
+	std::size_t kept = 0;
+	for (std::size_t i = 0; i < rows.size(); i++){
+		Row r = rows[i];
+		const Batch::Value& v = batch.getValue(column[r]);
+		bool satisfied;
+		if (e.numeric){
+			// the numeric value of a value is cached by the batch
+			satisfied = v.numeric && compareNumbers(v.number, e.operation, e.threshold);
+		}else{
+			satisfied = compareSymbols(v, symbols[column[r]], e.operation, e.value);
+		}
+		if (satisfied) matched.push_back(r);
+		else rows[kept++] = r;
+	}
+	rows.resize(kept);
+}
+
+void BatchClassifier::classify(const Batch& batch, std::vector<SymbolTable::Id>& classifications) const{
+	classifications.assign(batch.getRowCount(), SymbolTable::empty);
+	if (batch.getRowCount() == 0) return;
+
+	// Look up the values of the symbolic columns (here rather than in addColumn, since the operands of the diagram may have been interned after the batch was built)
+	std::vector<SymbolTable::Id> symbols(batch.getValueCount());
+	for (int v = 0; v < batch.getValueCount(); v++){
+		if (!SymbolTable::find(*batch.getValue(v).str, symbols[v])) symbols[v] = noSymbol;
+	}
+
+	// The rows which reached each node (filled by the parents, since the nodes are visited in topological order)
+	std::vector<std::vector<Row> > pending(nodes.size());
+	pending[root].reserve(batch.getRowCount());
+	for (int r = 0; r < batch.getRowCount(); r++){
+		pending[root].push_back(r);
+	}
+
+	for (unsigned int i = root; i < nodes.size(); i++){
+		std::vector<Row>& rows = pending[i];
+		if (rows.empty()) continue;
+		const CompiledNode& n = nodes[i];
+
+		if (n.leaf){
+			for (std::vector<Row>::iterator it = rows.begin(); it != rows.end(); it++){
+				classifications[*it] = n.classification;
+			}
+		}else{
+			// Each edge takes the rows which satisfy its condition and were not taken by a previous edge
+			for (int e = n.edgesBegin; e < n.edgesEnd && !rows.empty(); e++){
+				split(edges[e], batch, symbols, rows, pending[edges[e].child]);
+			}
+			// The remaining rows follow the else edge (if any)
+			if (n.elseChild != -1){
+				std::vector<Row>& elseRows = pending[n.elseChild];
+				elseRows.insert(elseRows.end(), rows.begin(), rows.end());
+			}
+		}
+
+		// release the memory of the row list
+		std::vector<Row>().swap(rows);
+	}
+}
@@ -0,0 +1,385 @@
+#include <CompactDecisionDiagram.h>
+
+#include <stack>
+#include <sstream>
+
+using namespace dlvhex::dd::util;
+
+const boost::uint32_t CompactDecisionDiagram::none;
+
+CompactDecisionDiagram::CompactDecisionDiagram(const DecisionDiagram& dd) : root(none), sharedNodes(0){
+
+	DecisionDiagram::NodeRange nodes = dd.getNodeRange();
+	std::size_t nodeCount = dd.nodeCount();
+	labels.reserve(nodeCount);
+	classifications.reserve(nodeCount);
+	edgeOffsets.reserve(nodeCount + 1);
+	edgeTargets.reserve(dd.edgeCount());
+	conditions.reserve(dd.edgeCount());
+
+	// Number the nodes depth-first, starting at the root, such that subdiagrams are stored contiguously. Unreachable nodes get the remaining ids.
+	std::vector<DecisionDiagram::Node*> order;
+	order.reserve(nodeCount);
+	boost::unordered_map<DecisionDiagram::Node*, NodeId> ids;
+	std::stack<DecisionDiagram::Node*> stack;
+	if (dd.getRoot() != NULL) stack.push(dd.getRoot());
+	DecisionDiagram::NodeRange::iterator nodeIt = nodes.begin();
+	while (order.size() < nodeCount){
+		if (stack.empty()){
+			// continue with the next node which was not reached so far
+			while (ids.find(*nodeIt) != ids.end()) nodeIt++;
+			stack.push(*nodeIt);
+		}
+		DecisionDiagram::Node* n = stack.top();
+		stack.pop();
+		if (ids.find(n) != ids.end()) continue;
+		ids[n] = order.size();
+		order.push_back(n);
+
+		// push the children in reverse order such that the first child is numbered first
+		for (int i = n->getChildCount() - 1; i >= 0; i--){
+			if (ids.find(n->getChild(i)) == ids.end()) stack.push(n->getChild(i));
+		}
+	}
+	if (dd.getRoot() != NULL) root = ids[dd.getRoot()];
+
+	// Build the node arrays and the CSR edge arrays (strings are already interned by the diagram, thus the symbols are just copied)
+	inDegrees.resize(order.size(), 0);
+	for (std::vector<DecisionDiagram::Node*>::iterator it = order.begin(); it != order.end(); it++){
+		DecisionDiagram::Node* n = *it;
+		labels.push_back(n->getLabelSymbol());
+		labelIndex[n->getLabelSymbol()] = labels.size() - 1;
+		DecisionDiagram::LeafNode* leaf = n->asLeaf();
+		classifications.push_back(leaf != NULL ? leaf->getClassificationSymbol() : none);
+
+		edgeOffsets.push_back(edgeTargets.size());
+		for (int i = 0; i < n->getOutEdgesCount(); i++){
+			DecisionDiagram::Edge* e = n->getOutEdge(i);
+			NodeId to = ids[e->getTo()];
+			edgeTargets.push_back(to);
+			if (++inDegrees[to] == 2) sharedNodes++;
+
+			DecisionDiagram::Condition c = e->getCondition();
+			PackedCondition pc;
+			pc.operand1 = c.getOperand1Symbol();
+			pc.operand2 = c.getOperand2Symbol();
+			pc.operation = c.getOperation();
+			conditions.push_back(pc);
+		}
+	}
+	edgeOffsets.push_back(edgeTargets.size());
+}
+
+int CompactDecisionDiagram::nodeCount() const{
+	return labels.size();
+}
+
+int CompactDecisionDiagram::edgeCount() const{
+	return edgeTargets.size();
+}
+
+int CompactDecisionDiagram::leafCount() const{
+	int lc = 0;
+	for (std::vector<StringId>::const_iterator it = classifications.begin(); it != classifications.end(); it++){
+		if (*it != none) lc++;
+	}
+	return lc;
+}
+
+CompactDecisionDiagram::NodeId CompactDecisionDiagram::getRoot() const{
+	return root;
+}
+
+CompactDecisionDiagram::NodeId CompactDecisionDiagram::getNodeByLabel(const std::string& label) const{
+	StringId l;
+	if (SymbolTable::find(label, l)){
+		boost::unordered_map<StringId, NodeId>::const_iterator it = labelIndex.find(l);
+		if (it != labelIndex.end()) return it->second;
+	}
+	throw DecisionDiagram::InvalidDecisionDiagram(std::string("Tried to retrieve node by label. Error: Node with label \"") + label + std::string("\" does not exist"));
+}
+
+const std::string& CompactDecisionDiagram::getLabel(NodeId n) const{
+	return SymbolTable::lookup(labels[n]);
+}
+
+CompactDecisionDiagram::StringId CompactDecisionDiagram::getLabelSymbol(NodeId n) const{
+	return labels[n];
+}
+
+bool CompactDecisionDiagram::isLeaf(NodeId n) const{
+	return classifications[n] != none;
+}
+
+const std::string& CompactDecisionDiagram::getClassification(NodeId n) const{
+	return SymbolTable::lookup(getClassificationSymbol(n));
+}
+
+CompactDecisionDiagram::StringId CompactDecisionDiagram::getClassificationSymbol(NodeId n) const{
+	return classifications[n] != none ? classifications[n] : SymbolTable::empty;
+}
+
+int CompactDecisionDiagram::getInDegree(NodeId n) const{
+	return inDegrees[n];
+}
+
+int CompactDecisionDiagram::getOutDegree(NodeId n) const{
+	return edgeOffsets[n + 1] - edgeOffsets[n];
+}
+
+CompactDecisionDiagram::EdgeId CompactDecisionDiagram::getOutEdgesBegin(NodeId n) const{
+	return edgeOffsets[n];
+}
+
+CompactDecisionDiagram::EdgeId CompactDecisionDiagram::getOutEdgesEnd(NodeId n) const{
+	return edgeOffsets[n + 1];
+}
+
+CompactDecisionDiagram::NodeId CompactDecisionDiagram::getChild(NodeId n, int index) const{
+	if (index < 0 || index >= getOutDegree(n)) throw DecisionDiagram::InvalidDecisionDiagram("Tried to retrieve child. Index was out of bounds.");
+	return edgeTargets[edgeOffsets[n] + index];
+}
+
+CompactDecisionDiagram::NodeId CompactDecisionDiagram::getTo(EdgeId e) const{
+	return edgeTargets[e];
+}
+
+DecisionDiagram::Condition::CmpOp CompactDecisionDiagram::getOperation(EdgeId e) const{
+	return static_cast<DecisionDiagram::Condition::CmpOp>(conditions[e].operation);
+}
+
+const std::string& CompactDecisionDiagram::getOperand1(EdgeId e) const{
+	return SymbolTable::lookup(conditions[e].operand1);
+}
+
+const std::string& CompactDecisionDiagram::getOperand2(EdgeId e) const{
+	return SymbolTable::lookup(conditions[e].operand2);
+}
+
+CompactDecisionDiagram::StringId CompactDecisionDiagram::getOperand1Symbol(EdgeId e) const{
+	return conditions[e].operand1;
+}
+
+CompactDecisionDiagram::StringId CompactDecisionDiagram::getOperand2Symbol(EdgeId e) const{
+	return conditions[e].operand2;
+}
+
+DecisionDiagram::Condition CompactDecisionDiagram::getCondition(EdgeId e) const{
+	return DecisionDiagram::Condition(conditions[e].operand1, conditions[e].operand2, getOperation(e));
+}
+
+std::vector<CompactDecisionDiagram::NodeId> CompactDecisionDiagram::containsCycles() const{
+
+	// Depth-first search with three colors: 0 = unvisited, 1 = on the current path, 2 = finished
+	std::vector<char> color(nodeCount(), 0);
+	std::vector<NodeId> parent(nodeCount(), none);
+
+	// Each stack entry holds a node and the next out-edge to process
+	std::stack<std::pair<NodeId, EdgeId> > stack;
+	for (NodeId start = 0; start < (NodeId)nodeCount(); start++){
+		if (color[start] != 0) continue;
+		color[start] = 1;
+		stack.push(std::pair<NodeId, EdgeId>(start, getOutEdgesBegin(start)));
+
+		while (!stack.empty()){
+			std::pair<NodeId, EdgeId>& top = stack.top();
+			NodeId n = top.first;
+			if (top.second == getOutEdgesEnd(n)){
+				// all children processed
+				color[n] = 2;
+				stack.pop();
+				continue;
+			}
+			NodeId child = edgeTargets[top.second++];
+			if (color[child] == 1){
+				// Cycle detected: backtrack the path to extract it
+				std::vector<NodeId> cycle;
+				cycle.push_back(child);
+				for (NodeId backtrack = n; backtrack != child; backtrack = parent[backtrack]) cycle.push_back(backtrack);
+				cycle.push_back(child);
+				// Reverse content due to edge direction
+				return std::vector<NodeId>(cycle.rbegin(), cycle.rend());
+			}else if (color[child] == 0){
+				color[child] = 1;
+				parent[child] = n;
+				stack.push(std::pair<NodeId, EdgeId>(child, getOutEdgesBegin(child)));
+			}
+		}
+	}
+
+	// No cycle was detected
+	return std::vector<NodeId>();
+}
+
+bool CompactDecisionDiagram::isTree() const{
+	return sharedNodes == 0;
+}
+
+bool CompactDecisionDiagram::containsPath(NodeId from, NodeId to) const{
+	std::vector<bool> visited(nodeCount(), false);
+	std::stack<NodeId> stack;
+	stack.push(from);
+	visited[from] = true;
+	while (!stack.empty()){
+		NodeId n = stack.top();
+		stack.pop();
+		if (n == to) return true;
+		for (EdgeId e = getOutEdgesBegin(n); e != getOutEdgesEnd(n); e++){
+			if (!visited[edgeTargets[e]]){
+				visited[edgeTargets[e]] = true;
+				stack.push(edgeTargets[e]);
+			}
+		}
+	}
+	// no path found
+	return false;
+}
+
+namespace{
+	// a pair of nodes whose subdiagrams are compared by operator==; equal is cleared by enter if the pair differs regardless of the children
+	struct CompactComparisonTask{
+		CompactComparisonTask(CompactDecisionDiagram::NodeId n1_, CompactDecisionDiagram::NodeId n2_) : n1(n1_), n2(n2_), equal(true){
+		}
+
+		CompactDecisionDiagram::NodeId n1;
+		CompactDecisionDiagram::NodeId n2;
+		bool equal;
+	};
+
+	// compares two subdiagrams _semantically_ (like the comparison of DecisionDiagram nodes); the remaining pairs are not entered as soon as one pair differs
+	class CompactComparison : public DecisionDiagram::Traversal<CompactComparisonTask, bool>{
+	private:
+		const CompactDecisionDiagram& dd1;
+		const CompactDecisionDiagram& dd2;
+
+		// Pairs which were already found to be equivalent do not need to be compared again
+		std::set<std::pair<CompactDecisionDiagram::NodeId, CompactDecisionDiagram::NodeId> > equalPairs;
+		bool failed;
+		bool knownResult;	// the result of the pairs in equalPairs
+
+	protected:
+		virtual const bool* lookup(const CompactComparisonTask& t){
+			return equalPairs.find(std::make_pair(t.n1, t.n2)) != equalPairs.end() ? &knownResult : NULL;
+		}
+
+	public:
+		CompactComparison(const CompactDecisionDiagram& dd1_, const CompactDecisionDiagram& dd2_) : dd1(dd1_), dd2(dd2_), failed(false), knownResult(true){
+		}
+
+		virtual void enter(CompactComparisonTask& t, std::vector<CompactComparisonTask>& children){
+			if (failed) return;
+
+			// Leaf nodes are equivalent iff their classifications are equal
+			if (dd1.isLeaf(t.n1) || dd2.isLeaf(t.n2)){
+				t.equal = dd1.isLeaf(t.n1) && dd2.isLeaf(t.n2) && dd1.getClassificationSymbol(t.n1) == dd2.getClassificationSymbol(t.n2);
+				return;
+			}
+
+			if (dd1.getOutDegree(t.n1) != dd2.getOutDegree(t.n2)){
+				t.equal = false;
+				return;
+			}
+
+			// For all edges of n1, search the appropriate edge of n2 (with respect to the edge condition) and compare the subdiagrams
+			std::vector<CompactComparisonTask> pairs;
+			for (CompactDecisionDiagram::EdgeId e1 = dd1.getOutEdgesBegin(t.n1); e1 != dd1.getOutEdgesEnd(t.n1); e1++){
+				DecisionDiagram::Condition c1 = dd1.getCondition(e1);
+				bool accordingEdgeFound = false;
+				for (CompactDecisionDiagram::EdgeId e2 = dd2.getOutEdgesBegin(t.n2); e2 != dd2.getOutEdgesEnd(t.n2); e2++){
+					if (c1 == dd2.getCondition(e2)){
+						pairs.push_back(CompactComparisonTask(dd1.getTo(e1), dd2.getTo(e2)));
+						accordingEdgeFound = true;
+						break;
+					}
+				}
+				if (!accordingEdgeFound){
+					t.equal = false;
+					return;
+				}
+			}
+			children.insert(children.end(), pairs.begin(), pairs.end());
+		}
+
+		virtual bool leave(const CompactComparisonTask& t, const std::vector<bool>& childResults){
+			// the children are equivalent unless the comparison failed below this pair
+			if (!t.equal) failed = true;
+			if (failed) return false;
+			if (!dd1.isLeaf(t.n1)) equalPairs.insert(std::make_pair(t.n1, t.n2));
+			return true;
+		}
+	};
+}
+
+bool CompactDecisionDiagram::operator==(const CompactDecisionDiagram& dd2) const{
+	if (root == none || dd2.root == none) return root == dd2.root;
+	CompactComparison comparison(*this, dd2);
+	return comparison.run(CompactComparisonTask(root, dd2.root));
+}
+
+bool CompactDecisionDiagram::operator!=(const CompactDecisionDiagram& dd2) const{
+	return !(*this == dd2);
+}
+
+void CompactDecisionDiagram::toDecisionDiagram(DecisionDiagram& dd) const{
+	dd.clear();
+
+	std::vector<DecisionDiagram::Node*> nodes;
+	nodes.reserve(nodeCount());
+	for (NodeId n = 0; n < (NodeId)nodeCount(); n++){
+		if (isLeaf(n))	nodes.push_back(dd.addLeafNode(getLabel(n), getClassification(n)));
+		else		nodes.push_back(dd.addNode(getLabel(n)));
+	}
+	for (NodeId n = 0; n < (NodeId)nodeCount(); n++){
+		for (EdgeId e = getOutEdgesBegin(n); e != getOutEdgesEnd(n); e++){
+			dd.addEdge(nodes[n], nodes[getTo(e)], getCondition(e));
+		}
+	}
+	if (root != none) dd.setRoot(nodes[root]);
+}
+
+AtomSet CompactDecisionDiagram::toAnswerSet() const{
+	return toAnswerSet(false, 0);
+}
+
+AtomSet CompactDecisionDiagram::toAnswerSet(bool addIndex, int index) const{
+	AtomSet as;
+	std::string suffix = addIndex ? std::string("In") : std::string("");
+
+	for (NodeId n = 0; n < (NodeId)nodeCount(); n++){
+		// Create tuples for nodes
+		Tuple args;
+		if (addIndex) args.push_back(Term(index));
+		args.push_back(Term(getLabel(n)));
+		if (isLeaf(n)){
+			args.push_back(Term(getClassification(n), true));
+			as.insert(AtomPtr(new Atom(std::string("leafnode") + suffix, args)));
+		}else{
+			as.insert(AtomPtr(new Atom(std::string("innernode") + suffix, args)));
+		}
+
+		// Create tuples for the outgoing edges
+		for (EdgeId e = getOutEdgesBegin(n); e != getOutEdgesEnd(n); e++){
+			Tuple eargs;
+			if (addIndex) eargs.push_back(Term(index));
+			eargs.push_back(Term(getLabel(n)));
+			eargs.push_back(Term(getLabel(getTo(e))));
+			if (getOperation(e) != DecisionDiagram::Condition::else_){
+				eargs.push_back(Term(getOperand1(e), true));
+				eargs.push_back(Term(DecisionDiagram::Condition::cmpOpToString(getOperation(e)), true));
+				eargs.push_back(Term(getOperand2(e), true));
+				as.insert(AtomPtr(new Atom(std::string("conditionaledge") + suffix, eargs)));
+			}else{
+				as.insert(AtomPtr(new Atom(std::string("elseedge") + suffix, eargs)));
+			}
+		}
+	}
+
+	// Root node
+	if (root != none){
+		Tuple arg;
+		if (addIndex) arg.push_back(Term(index));
+		arg.push_back(Term(getLabel(root)));
+		as.insert(AtomPtr(new Atom(std::string("root") + suffix, arg)));
+	}
+	return as;
+}
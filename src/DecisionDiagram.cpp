@@ -1,11 +1,16 @@
 #include <DecisionDiagram.h>
+#include <DecisionDiagramBuilder.h>
+#include <DecisionDiagramFile.h>
+#include <DecisionDiagramSinks.h>
 #include <StringHelper.h>
 
-#include <map>
+#include <boost/functional/hash.hpp>
+
+#include <algorithm>
+#include <new>
 #include <stack>
 #include <iostream>
 #include <sstream>
-#include <typeinfo>
 
 using namespace dlvhex::dd::util;
 
@@ -22,29 +27,60 @@ std::string DecisionDiagram::InvalidDecisionDiagram::getMessage(){
 
 // ------------------------------ Node ------------------------------
 
-DecisionDiagram::Node::Node(std::string l) : label(l){
+DecisionDiagram::Node::Node(SymbolTable::Id l) : kind(inner), label(l), labelPending(false), id(0), owner(NULL), structuralHash(0), structuralHashValid(false), topologyIndex(-1){
+}
+
+DecisionDiagram::Node::Node(SymbolTable::Id l, Kind k) : kind(k), label(l), labelPending(false), id(0), owner(NULL), structuralHash(0), structuralHashValid(false), topologyIndex(-1){
 }
 
 DecisionDiagram::Node::~Node(){
 }
 
 void DecisionDiagram::Node::setLabel(std::string l){
-	label = l;
+	if (owner != NULL) owner->relabelNode(this, l);
+	else label = SymbolTable::intern(l);
 }
 
-std::string DecisionDiagram::Node::getLabel() const{
+const std::string& DecisionDiagram::Node::getLabel() const{
+	return SymbolTable::lookup(getLabelSymbol());
+}
+
+SymbolTable::Id DecisionDiagram::Node::getLabelSymbol() const{
+	// Fresh nodes receive their labels when they are requested first
+	if (labelPending) owner->materializeLabels();
 	return label;
 }
 
+boost::uint32_t DecisionDiagram::Node::getId() const{
+	return id;
+}
+
 void DecisionDiagram::Node::addEdge(Edge* e){
-	if (e->getFrom() == this) outEdges.insert(e);
-	else if (e->getTo() == this) inEdges.insert(e);
+	if (e->getFrom() == this){
+		outEdges.push_back(e);
+		invalidateStructuralHash();
+	}else if (e->getTo() == this){
+		e->inIndex = inEdges.size();
+		inEdges.push_back(e);
+	}
 	else throw InvalidDecisionDiagram(std::string("Tried to add edge to node. Error: Node \"") + getLabel() + std::string("\" is not an endpoint of the given edge (\"") + e->toString() + std::string("\")"));
 }
 
 void DecisionDiagram::Node::removeEdge(Edge* e){
-	outEdges.erase(e);
-	inEdges.erase(e);
+	// Outgoing edges keep their order
+	int index = outEdges.find(e);
+	if (index >= 0){
+		outEdges.erase(index);
+		invalidateStructuralHash();
+	}
+
+	// Ingoing edges are unordered: move the last one into the gap
+	if (e->inIndex >= 0 && e->inIndex < (int)inEdges.size() && inEdges[e->inIndex] == e){
+		inEdges[e->inIndex] = inEdges.back();
+		inEdges[e->inIndex]->inIndex = e->inIndex;
+		inEdges.pop_back();
+		e->inIndex = -1;
+	}
 }
 
 std::set<DecisionDiagram::Edge*> DecisionDiagram::Node::getEdges() const{
@@ -55,11 +91,19 @@ std::set<DecisionDiagram::Edge*> DecisionDiagram::Node::getEdges() const{
 }
 
 std::set<DecisionDiagram::Edge*> DecisionDiagram::Node::getInEdges() const{
-	return inEdges;
+	return std::set<Edge*>(inEdges.begin(), inEdges.end());
 }
 
 std::set<DecisionDiagram::Edge*> DecisionDiagram::Node::getOutEdges() const{
-	return outEdges;
+	return std::set<Edge*>(outEdges.begin(), outEdges.end());
+}
+
+DecisionDiagram::EdgeList DecisionDiagram::Node::getInEdgeRange() const{
+	return EdgeList(inEdges.begin(), inEdges.end());
+}
+
+DecisionDiagram::EdgeList DecisionDiagram::Node::getOutEdgeRange() const{
+	return EdgeList(outEdges.begin(), outEdges.end());
 }
 
 int DecisionDiagram::Node::getEdgesCount() const{
@@ -75,9 +119,7 @@ int DecisionDiagram::Node::getOutEdgesCount() const{
 }
 
 DecisionDiagram::Node* DecisionDiagram::Node::getChild(int index){
-	for (std::set<Edge*>::iterator it = outEdges.begin(); it != outEdges.end(); it++){
-		if (index-- == 0) return (*it)->getTo();
-	}
+	if (index >= 0 && index < (int)outEdges.size()) return outEdges[index]->getTo();
 	// Error: Index out of bounds
 	throw InvalidDecisionDiagram("Tried to retrieve child. Index was out of bounds.");
 }
@@ -87,56 +129,164 @@ int DecisionDiagram::Node::getChildCount() const{
 }
 
 DecisionDiagram::Edge* DecisionDiagram::Node::getOutEdge(int index){
-	for (std::set<Edge*>::iterator it = outEdges.begin(); it != outEdges.end(); it++){
-		if (index-- == 0) return *it;
-	}
+	if (index >= 0 && index < (int)outEdges.size()) return outEdges[index];
 	// Error: Index out of bounds
 	throw InvalidDecisionDiagram("Tried to retrieve child. Index was out of bounds.");
 }
 
 std::string DecisionDiagram::Node::toString() const{
-	return label;
+	return getLabel();
 }
 
-bool DecisionDiagram::Node::operator==(const DecisionDiagram::Node &n2) const{
+void DecisionDiagram::Node::invalidateStructuralHash(){
+	// Walk up with an explicit stack; if the hash of a node is invalid already, then the hashes of all its ancestors are invalid as well
+	std::vector<Node*> stack(1, this);
+	while (!stack.empty()){
+		Node* n = stack.back();
+		stack.pop_back();
+		if (!n->structuralHashValid) continue;
+		n->structuralHashValid = false;
+		for (SmallVector<Edge*, 2>::iterator it = n->inEdges.begin(); it != n->inEdges.end(); it++){
+			stack.push_back((*it)->getFrom());
+		}
+	}
+}
 
-	try{
-		// check if n2 is a leaf
-		const LeafNode& l2 = dynamic_cast<const LeafNode&>(n2);
-		return *this == l2;
-	}catch(std::bad_cast){
-		// n2 is an inner node
-		std::set<Edge*> outEdges_n2 = n2.getOutEdges();
-		if (outEdges_n2.size() != outEdges.size()) return false;
-
-		// For all edges of n1, search the appropriate edge of n2 (with respect to the edge condition)
-		for (std::set<Edge*>::iterator it1 = outEdges.begin(); it1 != outEdges.end(); it1++){
-			Edge* e1 = *it1;
-			bool accordingEdgeFound = false;
-			for (std::set<Edge*>::iterator it2 = outEdges_n2.begin(); it2 != outEdges_n2.end(); it2++){
-				Edge* e2 = *it2;
-
-				// check if these two edges coincide
-				if (e1->getCondition() == e2->getCondition()){
-					// yes: now compare the subdiagrams
-					if (*(e1->getTo()) != *(e2->getTo())){
-						return false;
-					}
-					// yes, they coincide
-					accordingEdgeFound = true;
-					break;
-				}
+std::size_t DecisionDiagram::Node::computeStructuralHash() const{
+	// The edge hashes are summed up, such that the order of the edges does not matter
+	std::size_t edgesHash = 0;
+	for (SmallVector<Edge*, 4>::const_iterator it = outEdges.begin(); it != outEdges.end(); it++){
+		std::size_t edgeHash = (*it)->getCondition().hash();
+		boost::hash_combine(edgeHash, (*it)->getTo()->getStructuralHash());
+		edgesHash += edgeHash;
+	}
+	std::size_t seed = 0;
+	boost::hash_combine(seed, false);
+	boost::hash_combine(seed, outEdges.size());
+	boost::hash_combine(seed, edgesHash);
+	return seed;
+}
+
+// computes the hashes of the nodes bottom-up; nodes with a valid hash are not entered (their descendants have valid hashes as well)
+class DecisionDiagram::Node::Hashing : public DecisionDiagram::Traversal<const DecisionDiagram::Node*, std::size_t>{
+protected:
+	virtual const std::size_t* lookup(const Node* const& n){
+		return n->structuralHashValid ? &n->structuralHash : NULL;
+	}
+
+public:
+	virtual void enter(const Node*& n, std::vector<const Node*>& children){
+		for (SmallVector<Edge*, 4>::const_iterator it = n->outEdges.begin(); it != n->outEdges.end(); it++){
+			children.push_back((*it)->getTo());
+		}
+	}
+
+	virtual std::size_t leave(const Node* const& n, const std::vector<std::size_t>& childHashes){
+		// the hashes of all children are valid now
+		n->structuralHash = n->computeStructuralHash();
+		n->structuralHashValid = true;
+		return n->structuralHash;
+	}
+};
+
+std::size_t DecisionDiagram::Node::getStructuralHash() const{
+	if (!structuralHashValid){
+		Hashing hashing;
+		hashing.run(this);
+	}
+	return structuralHash;
+}
+
+namespace{
+	// a pair of nodes whose subdiagrams are compared by Node::operator==; equal is cleared by enter if the pair differs regardless of the children
+	struct ComparisonTask{
+		ComparisonTask(const DecisionDiagram::Node* n1_, const DecisionDiagram::Node* n2_) : n1(n1_), n2(n2_), equal(true){
+		}
+
+		const DecisionDiagram::Node* n1;
+		const DecisionDiagram::Node* n2;
+		bool equal;
+	};
+
+	// compares two subdiagrams _semantically_; as soon as one pair of nodes differs, the whole comparison fails and the remaining pairs are not entered
+	class Comparison : public DecisionDiagram::Traversal<ComparisonTask, bool>{
+	private:
+		// Pairs which were already found to be equivalent do not need to be compared again (this keeps the comparison of shared subdiagrams linear)
+		// (non-equivalent pairs need not be remembered since the whole comparison fails in this case)
+		std::set<std::pair<const DecisionDiagram::Node*, const DecisionDiagram::Node*> > equalPairs;
+		bool failed;
+		bool knownResult;	// the result of the pairs in equalPairs
+
+	protected:
+		virtual const bool* lookup(const ComparisonTask& t){
+			return equalPairs.find(std::make_pair(t.n1, t.n2)) != equalPairs.end() ? &knownResult : NULL;
+		}
+
+	public:
+		Comparison() : failed(false), knownResult(true){
+		}
+
+		virtual void enter(ComparisonTask& t, std::vector<ComparisonTask>& children){
+			if (failed || t.n1 == t.n2) return;
 
+			// Different hashes imply different subdiagrams
+			if (t.n1->getStructuralHash() != t.n2->getStructuralHash()){
+				t.equal = false;
+				return;
 			}
-			// we must find an according edge in n2 for each edge in n1
-			// Note: We do not have to check it the other way round since we safely assume that all edge conditions are distinct.
-			//       Thus is is sufficient to check the edge count (see above).
-			if (!accordingEdgeFound){
-				return false;
+
+			// Leaf nodes are equivalent iff their classifications are equal
+			if (t.n1->isLeaf() || t.n2->isLeaf()){
+				t.equal = t.n1->isLeaf() && t.n2->isLeaf() && t.n1->asLeaf()->getClassificationSymbol() == t.n2->asLeaf()->getClassificationSymbol();
+				return;
+			}
+
+			DecisionDiagram::EdgeList outEdges1 = t.n1->getOutEdgeRange();
+			DecisionDiagram::EdgeList outEdges2 = t.n2->getOutEdgeRange();
+			if (outEdges1.size() != outEdges2.size()){
+				t.equal = false;
+				return;
 			}
+
+			// For all edges of n1, search the appropriate edge of n2 (with respect to the edge condition) and compare the subdiagrams
+			std::vector<ComparisonTask> pairs;
+			for (DecisionDiagram::EdgeList::iterator it1 = outEdges1.begin(); it1 != outEdges1.end(); it1++){
+				DecisionDiagram::Edge* e1 = *it1;
+				bool accordingEdgeFound = false;
+				for (DecisionDiagram::EdgeList::iterator it2 = outEdges2.begin(); it2 != outEdges2.end(); it2++){
+					DecisionDiagram::Edge* e2 = *it2;
+
+					// check if these two edges coincide
+					if (e1->getCondition() == e2->getCondition()){
+						pairs.push_back(ComparisonTask(e1->getTo(), e2->getTo()));
+						accordingEdgeFound = true;
+						break;
+					}
+				}
+				// we must find an according edge in n2 for each edge in n1
+				// Note: We do not have to check it the other way round since we safely assume that all edge conditions are distinct.
+				//       Thus is is sufficient to check the edge count (see above).
+				if (!accordingEdgeFound){
+					t.equal = false;
+					return;
+				}
+			}
+			children.insert(children.end(), pairs.begin(), pairs.end());
 		}
-		return true;
-	}
+
+		virtual bool leave(const ComparisonTask& t, const std::vector<bool>& childResults){
+			// the children are equivalent unless the comparison failed below this pair
+			if (!t.equal) failed = true;
+			if (failed) return false;
+			if (t.n1 != t.n2 && !t.n1->isLeaf()) equalPairs.insert(std::make_pair(t.n1, t.n2));
+			return true;
+		}
+	};
+}
+
+bool DecisionDiagram::Node::operator==(const DecisionDiagram::Node &n2) const{
+	Comparison comparison;
+	return comparison.run(ComparisonTask(this, &n2));
 }
 
 bool DecisionDiagram::Node::operator==(const DecisionDiagram::LeafNode &n2) const{
@@ -157,16 +307,20 @@ bool DecisionDiagram::Node::operator!=(const DecisionDiagram::LeafNode &n2) cons
 DecisionDiagram::LeafNode::Data::~Data(){
 }
 
-DecisionDiagram::LeafNode::LeafNode(std::string l, std::string c) : Node(l), classification(c), data(NULL){
+DecisionDiagram::LeafNode::LeafNode(SymbolTable::Id l, SymbolTable::Id c) : Node(l, leaf), classification(c), data(NULL){
 }
 
-DecisionDiagram::LeafNode::LeafNode(std::string l, std::string c, Data* d) : Node(l), classification(c), data(d){
+DecisionDiagram::LeafNode::LeafNode(SymbolTable::Id l, SymbolTable::Id c, Data* d) : Node(l, leaf), classification(c), data(d){
 }
 
 DecisionDiagram::LeafNode::~LeafNode(){
 }
 
-std::string DecisionDiagram::LeafNode::getClassification(){
+const std::string& DecisionDiagram::LeafNode::getClassification() const{
+	return SymbolTable::lookup(classification);
+}
+
+SymbolTable::Id DecisionDiagram::LeafNode::getClassificationSymbol() const{
 	return classification;
 }
 
@@ -175,7 +329,8 @@ DecisionDiagram::LeafNode::Data* DecisionDiagram::LeafNode::getData(){
 }
 
 void DecisionDiagram::LeafNode::setClassification(std::string c){
-	classification = c;
+	classification = SymbolTable::intern(c);
+	invalidateStructuralHash();
 }
 
 void DecisionDiagram::LeafNode::setData(Data* d){
@@ -183,18 +338,19 @@ void DecisionDiagram::LeafNode::setData(Data* d){
 }
 
 std::string DecisionDiagram::LeafNode::toString() const{
-	return label + std::string(" [") + classification + std::string("]");
+	return getLabel() + std::string(" [") + getClassification() + std::string("]");
+}
+
+std::size_t DecisionDiagram::LeafNode::computeStructuralHash() const{
+	std::size_t seed = 0;
+	boost::hash_combine(seed, true);
+	boost::hash_combine(seed, classification);
+	return seed;
 }
 
 bool DecisionDiagram::LeafNode::operator==(const DecisionDiagram::Node &n2) const{
-	try{
-		// check if n2 is a leaf
-		const LeafNode& l2 = dynamic_cast<const LeafNode&>(n2);
-		return *this == l2;
-	}catch(std::bad_cast){
-		// n2 is an innner node
-		return false;
-	}
+	// check if n2 is a leaf
+	return n2.isLeaf() && *this == *n2.asLeaf();
 }
 
 bool DecisionDiagram::LeafNode::operator==(const DecisionDiagram::LeafNode &n2) const{
@@ -204,21 +360,67 @@ bool DecisionDiagram::LeafNode::operator==(const DecisionDiagram::LeafNode &n2)
 
 // ------------------------------ Condition ------------------------------
 
-DecisionDiagram::Condition::Condition(std::string operand1_, std::string operand2_, CmpOp operation_) : operand1(operand1_), operand2(operand2_), operation(operation_){
+DecisionDiagram::Condition::Condition(std::string operand1_, std::string operand2_, CmpOp operation_) : operand1(SymbolTable::intern(operand1_)), operand2(SymbolTable::intern(operand2_)), operation(operation_){
+	parse();
 }
 
-DecisionDiagram::Condition::Condition(std::string operand1_, std::string operand2_, std::string operation_) : operand1(operand1_), operand2(operand2_){
+DecisionDiagram::Condition::Condition(std::string operand1_, std::string operand2_, std::string operation_) : operand1(SymbolTable::intern(operand1_)), operand2(SymbolTable::intern(operand2_)){
 	operation = DecisionDiagram::Condition::stringToCmpOp(operation_);
+	parse();
+}
+
+DecisionDiagram::Condition::Condition(SymbolTable::Id operand1_, SymbolTable::Id operand2_, CmpOp operation_) : operand1(operand1_), operand2(operand2_), operation(operation_){
+	parse();
+}
+
+void DecisionDiagram::Condition::parse(){
+	attribute = SymbolTable::empty;
+	cmpValue = 0.0;
+	attributeFound = false;
+	cmpValueFound = false;
+	attributeLeft = true;
+	if (operation == Condition::else_) return;
+
+	// The numeric value of the operands is cached by the symbol table, thus no string needs to be parsed here
+	bool numeric1 = SymbolTable::isNumeric(operand1);
+	bool numeric2 = SymbolTable::isNumeric(operand2);
+
+	// If the first operand is no number, it is the attribute. Otherwise the second one is the attribute (if it is no number).
+	if (!numeric1){
+		attribute = operand1;
+		attributeFound = true;
+	}else if (!numeric2){
+		attribute = operand2;
+		attributeFound = true;
+		attributeLeft = false;
+	}
+
+	// If the first operand is a number, it is the comparison value. Otherwise the second one is the comparison value (if it is a number).
+	if (numeric1){
+		cmpValue = SymbolTable::getNumericValue(operand1);
+		cmpValueFound = true;
+	}else if (numeric2){
+		cmpValue = SymbolTable::getNumericValue(operand2);
+		cmpValueFound = true;
+	}
 }
 
 DecisionDiagram::Condition::~Condition(){
 }
 
-std::string DecisionDiagram::Condition::getOperand1() const{
+const std::string& DecisionDiagram::Condition::getOperand1() const{
+	return SymbolTable::lookup(operand1);
+}
+
+const std::string& DecisionDiagram::Condition::getOperand2() const{
+	return SymbolTable::lookup(operand2);
+}
+
+SymbolTable::Id DecisionDiagram::Condition::getOperand1Symbol() const{
 	return operand1;
 }
 
-std::string DecisionDiagram::Condition::getOperand2() const{
+SymbolTable::Id DecisionDiagram::Condition::getOperand2Symbol() const{
 	return operand2;
 }
 
@@ -226,37 +428,32 @@ DecisionDiagram::Condition::CmpOp DecisionDiagram::Condition::getOperation() con
 	return operation;
 }
 
-std::string DecisionDiagram::Condition::getAttribute() const{
-	try{
-		// check if the first operand is a number
-		StringHelper::atof(getOperand1());
+bool DecisionDiagram::Condition::hasAttribute() const{
+	return attributeFound;
+}
 
-		// yes: then the second operand is the attribute (check if it is NO number!)
-		try{
-			StringHelper::atof(getOperand2());
-			throw DecisionDiagram::InvalidDecisionDiagram(std::string("None of the operands in condition \"") + toString() + "\" is an attribute (both are numbers)");
-		}catch(StringHelper::NotContainedException nce){}
+bool DecisionDiagram::Condition::hasCmpValue() const{
+	return cmpValueFound;
+}
 
-		return getOperand2();
-	}catch(StringHelper::NotContainedException nce){
-		// no, then it's the attribute
-		return getOperand1();
-	}
+const std::string& DecisionDiagram::Condition::getAttribute() const{
+	return SymbolTable::lookup(attribute);
 }
 
-float DecisionDiagram::Condition::getCmpValue() const{
-	try{
-		// check if the first operand is a number
-		// if this is the case, then it's the compare value
-		return StringHelper::atof(getOperand1());
-	}catch(StringHelper::NotContainedException nce){
-		// no, then it's the second operand (must be a float value - check this!)
-		try{
-			return StringHelper::atof(getOperand2());
-		}catch(StringHelper::NotContainedException nce2){
-			throw DecisionDiagram::InvalidDecisionDiagram(std::string("None of the operands in condition \"") + toString() + "\" is a float value");
-		}
-	}
+SymbolTable::Id DecisionDiagram::Condition::getAttributeSymbol() const{
+	return attribute;
+}
+
+double DecisionDiagram::Condition::getCmpValue() const{
+	return cmpValue;
+}
+
+bool DecisionDiagram::Condition::isAttributeLeft() const{
+	return attributeLeft;
+}
+
+DecisionDiagram::Condition::CmpOp DecisionDiagram::Condition::getNormalizedOperation() const{
+	return attributeLeft ? operation : mirrorCmpOp(operation);
 }
 
 DecisionDiagram::Condition::CmpOp DecisionDiagram::Condition::stringToCmpOp(std::string operation_){
@@ -280,26 +477,45 @@ std::string DecisionDiagram::Condition::cmpOpToString(DecisionDiagram::Condition
 	}
 }
 
+DecisionDiagram::Condition::CmpOp DecisionDiagram::Condition::mirrorCmpOp(DecisionDiagram::Condition::CmpOp op){
+	switch(op){
+		case Condition::lt: return Condition::gt;
+		case Condition::le: return Condition::ge;
+		case Condition::ge: return Condition::le;
+		case Condition::gt: return Condition::lt;
+		default: return op;
+	}
+}
+
 std::string DecisionDiagram::Condition::toString() const{
-	return operand1 + cmpOpToString(operation) + operand2;
+	return getOperand1() + cmpOpToString(operation) + getOperand2();
 }
 
-bool DecisionDiagram::Condition::operator==(const DecisionDiagram::Condition &c2) const{
-	switch(getOperation()){
-		case Condition::lt: return	(operand1 == c2.getOperand1() && operand2 == c2.getOperand2() && c2.getOperation() == Condition::lt) ||
-						(operand1 == c2.getOperand2() && operand1 == c2.getOperand2() && c2.getOperation() == Condition::gt);
-		case Condition::le: return	(operand1 == c2.getOperand1() && operand2 == c2.getOperand2() && c2.getOperation() == Condition::le) ||
-						(operand1 == c2.getOperand2() && operand1 == c2.getOperand2() && c2.getOperation() == Condition::ge);
-		case Condition::eq: return	(c2.getOperation() == Condition::eq) &&
-						((operand1 == c2.getOperand1() && operand2 == c2.getOperand2()) ||
-						(operand2 == c2.getOperand1() && operand1 == c2.getOperand2()));
-		case Condition::ge: return	(operand1 == c2.getOperand1() && operand2 == c2.getOperand2() && c2.getOperation() == Condition::ge) ||
-						(operand1 == c2.getOperand2() && operand1 == c2.getOperand2() && c2.getOperation() == Condition::le);
-		case Condition::gt: return	(operand1 == c2.getOperand1() && operand2 == c2.getOperand2() && c2.getOperation() == Condition::gt) ||
-						(operand1 == c2.getOperand2() && operand1 == c2.getOperand2() && c2.getOperation() == Condition::lt);
-		case Condition::else_: return true;
-		default: assert(false);
+DecisionDiagram::Condition DecisionDiagram::Condition::getCanonical() const{
+	if (operation == Condition::else_ || operand1 < operand2) return *this;
+	if (operand1 == operand2 && operation <= mirrorCmpOp(operation)) return *this;
+	return Condition(operand2, operand1, mirrorCmpOp(operation));
+}
+
+std::size_t DecisionDiagram::Condition::hash() const{
+	// Equivalent conditions have the same canonical form
+	Condition canonical = getCanonical();
+	std::size_t seed = 0;
+	boost::hash_combine(seed, static_cast<int>(canonical.operation));
+	if (operation != Condition::else_){
+		boost::hash_combine(seed, canonical.operand1);
+		boost::hash_combine(seed, canonical.operand2);
 	}
+	return seed;
+}
+
+bool DecisionDiagram::Condition::operator==(const DecisionDiagram::Condition &c2) const{
+	// Else conditions are only equivalent to each other
+	if (operation == Condition::else_ || c2.operation == Condition::else_) return operation == c2.operation;
+
+	// The conditions are equivalent if they coincide either directly or with swapped operands (e.g. "X < 10" and "10 > X")
+	return	(operand1 == c2.operand1 && operand2 == c2.operand2 && c2.operation == operation) ||
+		(operand1 == c2.operand2 && operand2 == c2.operand1 && c2.operation == mirrorCmpOp(operation));
 }
 
 bool DecisionDiagram::Condition::operator!=(const DecisionDiagram::Condition &c2) const{
@@ -309,17 +525,20 @@ bool DecisionDiagram::Condition::operator!=(const DecisionDiagram::Condition &c2
 
 // ------------------------------ Edge ------------------------------
 
-DecisionDiagram::Edge::Edge(Node *f, Node *t, Condition c) : from(f), to(t), condition(c){
+DecisionDiagram::Edge::Edge(Node *f, Node *t, Condition c) : kind(conditional), from(f), to(t), condition(c), inIndex(-1){
+}
+
+DecisionDiagram::Edge::Edge(Node *f, Node *t, Condition c, Kind k) : kind(k), from(f), to(t), condition(c), inIndex(-1){
 }
 
 DecisionDiagram::Edge::~Edge(){
 }
 
-DecisionDiagram::Node* DecisionDiagram::Edge::getFrom(){
+DecisionDiagram::Node* DecisionDiagram::Edge::getFrom() const{
 	return from;
 }
 
-DecisionDiagram::Node* DecisionDiagram::Edge::getTo(){
+DecisionDiagram::Node* DecisionDiagram::Edge::getTo() const{
 	return to;
 }
 
@@ -352,7 +571,7 @@ bool DecisionDiagram::Edge::operator!=(const DecisionDiagram::ElseEdge &e2) cons
 
 // ------------------------------ ElseEdge ------------------------------
 
-DecisionDiagram::ElseEdge::ElseEdge(Node *u, Node *v) : Edge(u, v, Condition(std::string(""), std::string(""), Condition::else_)){
+DecisionDiagram::ElseEdge::ElseEdge(Node *u, Node *v) : Edge(u, v, Condition(std::string(""), std::string(""), Condition::else_), unconditional){
 }
 
 DecisionDiagram::ElseEdge::~ElseEdge(){
@@ -372,72 +591,42 @@ bool DecisionDiagram::ElseEdge::operator==(const DecisionDiagram::ElseEdge &e2)
 }
 
 
+// ------------------------------ Sink ------------------------------
+
+DecisionDiagram::Sink::~Sink(){
+}
+
+void DecisionDiagram::Sink::begin(const DecisionDiagram& dd){
+}
+
+void DecisionDiagram::Sink::end(){
+}
+
+
 // ------------------------------ DecisionDiagram ------------------------------
 
-DecisionDiagram::DecisionDiagram() : root(NULL){
+namespace{
+	// appends the decimal representation of a positive number to a string (without the overhead of a stream)
+	void appendNumber(std::string& str, int number){
+		char digits[16];
+		int length = 0;
+		do{
+			digits[length++] = '0' + number % 10;
+			number /= 10;
+		}while (number > 0);
+		while (length > 0) str += digits[--length];
+	}
+}
+
+DecisionDiagram::DecisionDiagram() : root(NULL), multiParentNodeCount(0), nodePool(sizeof(LeafNode)), edgePool(sizeof(ElseEdge)), nextNodeId(0), topologyValid(false), acyclic(true), statisticsValid(false){
 }
 
-DecisionDiagram::DecisionDiagram(const DecisionDiagram &dd2){
+DecisionDiagram::DecisionDiagram(const DecisionDiagram &dd2) : root(NULL), multiParentNodeCount(0), nodePool(sizeof(LeafNode)), edgePool(sizeof(ElseEdge)), nextNodeId(0), topologyValid(false), acyclic(true), statisticsValid(false){
 	this->operator=(dd2);
 }
 
-DecisionDiagram::DecisionDiagram(AtomSet as){
-
-	// Create list of nodes
-	//    inner nodes
-	AtomSet innernodes;
-	as.matchPredicate(std::string("innernode"), innernodes);
-	for (AtomSet::const_iterator it = innernodes.begin(); it != innernodes.end(); it++){
-		addNode(it->getArguments()[0].getUnquotedString());
-	}
-
-	//    leaf nodes
-	AtomSet leafnodes;
-	as.matchPredicate(std::string("leafnode"), leafnodes);
-	for (AtomSet::const_iterator it = leafnodes.begin(); it != leafnodes.end(); it++){
-		addLeafNode(it->getArguments()[0].getUnquotedString(), it->getArguments()[1].getUnquotedString());
-	}
-
-	// Create list of edges
-	//    conditional edges
-	AtomSet conditionaledges;
-	as.matchPredicate(std::string("conditionaledge"), conditionaledges);
-	for (AtomSet::const_iterator it = conditionaledges.begin(); it != conditionaledges.end(); it++){
-		std::string n1 = it->getArguments()[0].getString();
-		std::string n2 = it->getArguments()[1].getString();
-		Condition::CmpOp cmpop;
-		if (it->getArguments()[3].getUnquotedString() == std::string("<")) cmpop = Condition::lt;
-		if (it->getArguments()[3].getUnquotedString() == std::string("<=")) cmpop = Condition::le;
-		if (it->getArguments()[3].getUnquotedString() == std::string("=")) cmpop = Condition::eq;
-		if (it->getArguments()[3].getUnquotedString() == std::string(">")) cmpop = Condition::gt;
-		if (it->getArguments()[3].getUnquotedString() == std::string(">=")) cmpop = Condition::ge;
-
-		// convert both operators into integer values
-		std::string op1 = it->getArguments()[2].getUnquotedString();
-		std::string op2 = it->getArguments()[4].getUnquotedString();
-		Condition c(op1, op2, cmpop);
-		addEdge(n1, n2, c);
-	}
-
-	//    else edges
-	AtomSet elseedges;
-	as.matchPredicate(std::string("elseedge"), elseedges);
-	for (AtomSet::const_iterator it = elseedges.begin(); it != elseedges.end(); it++){
-		std::string n1 = it->getArguments()[0].getUnquotedString();
-		std::string n2 = it->getArguments()[1].getUnquotedString();
-		addElseEdge(n1, n2);
-	}
-
-	// Root node
-	AtomSet rootnode;
-	as.matchPredicate(std::string("root"), rootnode);
-	root = NULL;
-	for (AtomSet::const_iterator it = rootnode.begin(); it != rootnode.end(); it++){
-		if (root != NULL){
-			throw InvalidDecisionDiagram(std::string("Error: Multiple roots specified (first one with label \"") + root->getLabel() + std::string("\", second one with label \"") + it->getArguments()[0].getUnquotedString() + std::string("\"."));
-		}
-		root = getNodeByLabel(it->getArguments()[0].getUnquotedString());
-	}
+DecisionDiagram::DecisionDiagram(const AtomSet& as) : root(NULL), multiParentNodeCount(0), nodePool(sizeof(LeafNode)), edgePool(sizeof(ElseEdge)), nextNodeId(0), topologyValid(false), acyclic(true), statisticsValid(false){
+	DecisionDiagramBuilder::build(as, *this);
 }
 
 DecisionDiagram::~DecisionDiagram(){
@@ -448,34 +637,61 @@ DecisionDiagram::~DecisionDiagram(){
 
 void DecisionDiagram::clear(){
 
-	// Delete all edges and nodes
+	// Destruct all edges and nodes; their memory is released in bulk afterwards
 	for (std::set<Edge*>::iterator it = edges.begin(); it != edges.end(); it++){
-		delete *it;
+		(*it)->~Edge();
 	}
 	for (std::set<Node*>::iterator it = nodes.begin(); it != nodes.end(); it++){
-		delete *it;
+		(*it)->~Node();
 	}
+	edgePool.releaseAll();
+	nodePool.releaseAll();
 	edges.erase(edges.begin(), edges.end());
 	nodes.erase(nodes.begin(), nodes.end());
+	leafNodes.clear();
+	multiParentNodeCount = 0;
+	labelIndex.clear();
+	labelCounters.clear();
+	pendingLabels.clear();
+	nextNodeId = 0;
+	uniqueTable.clear();
+	sharedNodes.clear();
 	root = NULL;
+	invalidateTopology();
+}
+
+void DecisionDiagram::reserve(std::size_t nodeCount){
+	labelIndex.rehash(static_cast<std::size_t>(nodeCount / labelIndex.max_load_factor()) + 1);
+}
+
+void DecisionDiagram::destroyNode(DecisionDiagram::Node* n){
+	n->~Node();
+	nodePool.deallocate(n);
+}
+
+void DecisionDiagram::destroyEdge(DecisionDiagram::Edge* e){
+	e->~Edge();
+	edgePool.deallocate(e);
 }
 
 DecisionDiagram& DecisionDiagram::operator=(const DecisionDiagram &dd2){
+	if (&dd2 == this) return *this;
 	clear();
 
-	std::set<Node*> dd2nodes = dd2.getNodes();
-	std::set<Edge*> dd2edges = dd2.getEdges();
-
 	// add all nodes of dd2 into dd1
-	std::map<Node*, Node*> nodemapping;
-	for (std::set<Node*>::iterator it = dd2nodes.begin(); it != dd2nodes.end(); it++){
+	boost::unordered_map<Node*, Node*> nodemapping;
+	for (std::set<Node*>::const_iterator it = dd2.nodes.begin(); it != dd2.nodes.end(); it++){
 		// remember the equivalence of *it and the new node in dd2; this can be exploited for performance enhancements during edge insertion
 		nodemapping[*it] = addNode(*it);
 	}
 
-	// insert all edges
-	for (std::set<Edge*>::iterator it = dd2edges.begin(); it != dd2edges.end(); it++){
-		addEdge(nodemapping[(*it)->getFrom()], nodemapping[(*it)->getTo()], (*it)->getCondition());
+	// insert the out-edges of each node (in their original order, which determines the order in which the conditions are tested)
+	for (std::set<Node*>::const_iterator it = dd2.nodes.begin(); it != dd2.nodes.end(); it++){
+		Node* from = nodemapping[*it];
+		EdgeList outEdges = (*it)->getOutEdgeRange();
+		for (EdgeList::iterator e = outEdges.begin(); e != outEdges.end(); e++){
+			addEdge(from, nodemapping[(*e)->getTo()], (*e)->getCondition());
+		}
 	}
 
 	// set root of the new diagram
@@ -484,29 +700,150 @@ DecisionDiagram& DecisionDiagram::operator=(const DecisionDiagram &dd2){
 	return *this;
 }
 
-DecisionDiagram::Node* DecisionDiagram::addNode(std::string label){
-	// Check if the label is unique
+void DecisionDiagram::swap(DecisionDiagram& dd2){
+	if (&dd2 == this) return;
+
+	// Exchange all structures (the nodes and edges stay in their pools, which are exchanged as well)
+	nodes.swap(dd2.nodes);
+	leafNodes.swap(dd2.leafNodes);
+	std::swap(multiParentNodeCount, dd2.multiParentNodeCount);
+	edges.swap(dd2.edges);
+	std::swap(root, dd2.root);
+	labelIndex.swap(dd2.labelIndex);
+	labelCounters.swap(dd2.labelCounters);
+	pendingLabels.swap(dd2.pendingLabels);
+	std::swap(nextNodeId, dd2.nextNodeId);
+	nodePool.swap(dd2.nodePool);
+	edgePool.swap(dd2.edgePool);
+	uniqueTable.swap(dd2.uniqueTable);
+	sharedNodes.swap(dd2.sharedNodes);
+	std::swap(topologyValid, dd2.topologyValid);
+	std::swap(acyclic, dd2.acyclic);
+	topologicalOrder.swap(dd2.topologicalOrder);
+	reachableFromRoot.swap(dd2.reachableFromRoot);
+	std::swap(statisticsValid, dd2.statisticsValid);
+	std::swap(depth, dd2.depth);
+	std::swap(pathCount, dd2.pathCount);
+	std::swap(unfoldedNodeCount, dd2.unfoldedNodeCount);
+	attributeUsage.swap(dd2.attributeUsage);
+
+	// The nodes need to know their new owners (for keeping the label indices up to date)
 	for (std::set<Node*>::iterator it = nodes.begin(); it != nodes.end(); it++){
-		if ((*it)->getLabel() == label) throw InvalidDecisionDiagram(std::string("Tried to add node. Error: The label \"") + label + std::string("\" is not unique."));
+		(*it)->owner = this;
 	}
-	Node *n = new Node(label);
+	for (std::set<Node*>::iterator it = dd2.nodes.begin(); it != dd2.nodes.end(); it++){
+		(*it)->owner = &dd2;
+	}
+}
+
+void DecisionDiagram::moveFrom(DecisionDiagram& dd2){
+	if (&dd2 == this) return;
+	clear();
+	swap(dd2);
+}
+
+DecisionDiagram* DecisionDiagram::clone() const{
+	return new DecisionDiagram(*this);
+}
+
+void DecisionDiagram::registerNode(DecisionDiagram::Node* n, bool fresh){
+	n->owner = this;
+	n->id = nextNodeId++;
 	nodes.insert(n);
+	if (n->isLeaf()) leafNodes.insert(n->asLeaf());
+	invalidateTopology();
+
+	// The labels of fresh nodes are not indexed before they are generated
+	if (fresh){
+		n->labelPending = true;
+		pendingLabels[n->id] = n;
+	}else{
+		labelIndex[n->label] = n;
+	}
+}
+
+DecisionDiagram::Node* DecisionDiagram::insertNode(SymbolTable::Id label, bool fresh){
+	Node *n = new (nodePool.allocate()) Node(label);
+	registerNode(n, fresh);
 	return n;
 }
 
-DecisionDiagram::LeafNode* DecisionDiagram::addLeafNode(std::string label, std::string classification){
-	LeafNode *n = new LeafNode(label, classification);
-	nodes.insert(n);
+DecisionDiagram::LeafNode* DecisionDiagram::insertLeafNode(SymbolTable::Id label, SymbolTable::Id classification, bool fresh){
+	LeafNode *n = new (nodePool.allocate()) LeafNode(label, classification);
+	registerNode(n, fresh);
 	return n;
 }
 
+DecisionDiagram::Edge* DecisionDiagram::insertEdge(DecisionDiagram::Node* from, DecisionDiagram::Node* to, const DecisionDiagram::Condition& c){
+	if (c.getOperation() == Condition::else_) return insertElseEdge(from, to);
+
+	// Create the edge
+	Edge *e = new (edgePool.allocate()) Edge(from, to, c);
+	edges.insert(e);
+	invalidateTopology();
+
+	// Add it to it's inzident nodes
+	from->addEdge(e);
+	to->addEdge(e);
+	if (to->getInEdgesCount() == 2) multiParentNodeCount++;
+
+	return e;
+}
+
+DecisionDiagram::ElseEdge* DecisionDiagram::insertElseEdge(DecisionDiagram::Node* from, DecisionDiagram::Node* to){
+	// Create the edge
+	ElseEdge *e = new (edgePool.allocate()) ElseEdge(from, to);
+	edges.insert(e);
+	invalidateTopology();
+
+	// Add it to it's inzident nodes
+	from->addEdge(e);
+	to->addEdge(e);
+	if (to->getInEdgesCount() == 2) multiParentNodeCount++;
+
+	return e;
+}
+
+DecisionDiagram::Node* DecisionDiagram::addNode(std::string label){
+	SymbolTable::Id l = SymbolTable::intern(label);
+
+	// Check if the label is unique
+	if (labelIndex.find(l) != labelIndex.end()) throw InvalidDecisionDiagram(std::string("Tried to add node. Error: The label \"") + label + std::string("\" is not unique."));
+	return insertNode(l, false);
+}
+
+DecisionDiagram::LeafNode* DecisionDiagram::addLeafNode(std::string label, std::string classification){
+	SymbolTable::Id l = SymbolTable::intern(label);
+
+	// Check if the label is unique
+	if (labelIndex.find(l) != labelIndex.end()) throw InvalidDecisionDiagram(std::string("Tried to add leaf node. Error: The label \"") + label + std::string("\" is not unique."));
+	return insertLeafNode(l, SymbolTable::intern(classification), false);
+}
+
+DecisionDiagram::Node* DecisionDiagram::addFreshNode(std::string baseLabel){
+	return insertNode(SymbolTable::intern(baseLabel), true);
+}
+
+DecisionDiagram::LeafNode* DecisionDiagram::addFreshLeafNode(std::string baseLabel, std::string classification){
+	return insertLeafNode(SymbolTable::intern(baseLabel), SymbolTable::intern(classification), true);
+}
+
+DecisionDiagram::Node* DecisionDiagram::addFreshNode(const DecisionDiagram::Node* original){
+	// the label symbol of a pending node is its base label
+	return insertNode(original->label, true);
+}
+
+DecisionDiagram::LeafNode* DecisionDiagram::addFreshLeafNode(const DecisionDiagram::LeafNode* original){
+	return insertLeafNode(original->label, original->classification, true);
+}
+
 DecisionDiagram::Node* DecisionDiagram::addNode(DecisionDiagram::Node* template_){
-	if (dynamic_cast<LeafNode*>(template_) != NULL){
-		LeafNode *ln = dynamic_cast<LeafNode*>(template_);
-		return addLeafNode(ln->getLabel(), ln->getClassification());
-	}else{
-		return addNode(template_->getLabel());
-	}
+	// Check if the label is unique (the symbols of the template are reused, thus no string needs to be interned)
+	SymbolTable::Id l = template_->getLabelSymbol();
+	if (labelIndex.find(l) != labelIndex.end()) throw InvalidDecisionDiagram(std::string("Tried to add node. Error: The label \"") + template_->getLabel() + std::string("\" is not unique."));
+
+	if (template_->isLeaf())	return insertLeafNode(l, template_->asLeaf()->classification, false);
+	else				return insertNode(l, false);
 }
 
 DecisionDiagram::Edge* DecisionDiagram::addEdge(DecisionDiagram::Node* from, DecisionDiagram::Node* to, DecisionDiagram::Condition c){
@@ -514,32 +851,14 @@ DecisionDiagram::Edge* DecisionDiagram::addEdge(DecisionDiagram::Node* from, Dec
 	if (nodes.find(from) == nodes.end() || nodes.find(to) == nodes.end()){
 		throw InvalidDecisionDiagram(std::string("Tried to add an edge from \"") + from->getLabel() + std::string("\" to \"") + to->getLabel() + std::string("\". Error: Both endpoints of an edge need to be part of the decision diagram before it can be added. ") + (nodes.find(from) == nodes.end() ? from->getLabel() : to->getLabel()) + std::string(" is not a member."));
 	}else{
-		if (c.getOperation() == Condition::else_){
-			// Create the else edge
-			ElseEdge *e = new ElseEdge(from, to);
-			edges.insert(e);
-
-			// Add it to it's inzident nodes
-			from->addEdge(e);
-			to->addEdge(e);
-
-			return e;
-		}else{
-			// Create the edge
-			Edge *e = new Edge(from, to, c);
-			edges.insert(e);
-
-			// Add it to it's inzident nodes
-			from->addEdge(e);
-			to->addEdge(e);
-
-			return e;
-		}
+		// Adding an edge changes the structure of from
+		unshare(from);
+		return insertEdge(from, to, c);
 	}
 }
 
 DecisionDiagram::Edge* DecisionDiagram::addEdge(std::string from, std::string to, DecisionDiagram::Condition c){
-	addEdge(getNodeByLabel(from), getNodeByLabel(to), c);
+	return addEdge(getNodeByLabel(from), getNodeByLabel(to), c);
 }
 
 DecisionDiagram::ElseEdge* DecisionDiagram::addElseEdge(DecisionDiagram::Node* from, DecisionDiagram::Node* to){
@@ -547,28 +866,21 @@ DecisionDiagram::ElseEdge* DecisionDiagram::addElseEdge(DecisionDiagram::Node* f
 	if (nodes.find(from) == nodes.end() || nodes.find(to) == nodes.end()){
 		throw InvalidDecisionDiagram(std::string("Tried to add an edge from \"") + from->getLabel() + std::string("\" to \"") + to->getLabel() + std::string("\". Error: Both endpoints of an edge need to be part of the decision diagram before it can be added. ") + (nodes.find(from) == nodes.end() ? from->getLabel() : to->getLabel()) + std::string(" is not a member."));
 	}else{
-		// Create the edge
-		ElseEdge *e = new ElseEdge(from, to);
-		edges.insert(e);
-
-		// Add it to it's inzident nodes
-		from->addEdge(e);
-		to->addEdge(e);
-
-		return e;
+		// Adding an edge changes the structure of from
+		unshare(from);
+		return insertElseEdge(from, to);
 	}
 }
 
 DecisionDiagram::ElseEdge* DecisionDiagram::addElseEdge(std::string from, std::string to){
-	addElseEdge(getNodeByLabel(from), getNodeByLabel(to));
+	return addElseEdge(getNodeByLabel(from), getNodeByLabel(to));
 }
 
 DecisionDiagram::Edge* DecisionDiagram::addEdge(DecisionDiagram::Edge* template_){
-	if (dynamic_cast<ElseEdge*>(template_) != NULL){
-		ElseEdge *ee = dynamic_cast<ElseEdge*>(template_);
-		return addElseEdge(getNodeByLabel(template_->getFrom()->getLabel()), getNodeByLabel(template_->getTo()->getLabel()));
+	if (template_->isElse()){
+		return addElseEdge(getNodeByLabelSymbol(template_->getFrom()->getLabelSymbol()), getNodeByLabelSymbol(template_->getTo()->getLabelSymbol()));
 	}else{
-		return addEdge(getNodeByLabel(template_->getFrom()->getLabel()), getNodeByLabel(template_->getTo()->getLabel()), template_->getCondition());
+		return addEdge(getNodeByLabelSymbol(template_->getFrom()->getLabelSymbol()), getNodeByLabelSymbol(template_->getTo()->getLabelSymbol()), template_->getCondition());
 	}
 }
 
@@ -591,8 +903,18 @@ void DecisionDiagram::removeNode(DecisionDiagram::Node *n, bool forceRemoveEdges
 		}
 
 		// Remove the node
+		unshare(n);
 		nodes.erase(n);
-		delete n;
+		if (n->isLeaf()) leafNodes.erase(n->asLeaf());
+		invalidateTopology();
+		if (n->labelPending){
+			// The base label of a fresh node is not indexed
+			pendingLabels.erase(n->id);
+		}else{
+			labelIndex.erase(n->label);
+			if (!labelCounters.empty()) labelCounters.clear();
+		}
+		destroyNode(n);
 	}
 }
 
@@ -600,161 +922,366 @@ void DecisionDiagram::removeEdge(DecisionDiagram::Edge* e){
 	// Check if e is part of this decision diagram
 	if (edges.find(e) == edges.end()) throw DecisionDiagram::InvalidDecisionDiagram(std::string("Tried to remove edge \"") + e->toString() + std::string("\". Error: This edge is not a member of the decision diagram."));
 
+	// Removing an edge changes the structure of it's from-node
+	unshare(e->getFrom());
+
 	// Remove the edge from it's inzident nodes
 	e->getFrom()->removeEdge(e);
 	e->getTo()->removeEdge(e);
+	if (e->getTo()->getInEdgesCount() == 1) multiParentNodeCount--;
 
 	// Remove the edge
 	edges.erase(e);
-	delete e;
+	invalidateTopology();
+	destroyEdge(e);
 }
 
 DecisionDiagram::Node* DecisionDiagram::addDecisionDiagram(DecisionDiagram* dd2){
-	// Check for node label uniqueness
-	std::set<Node*> dd2nodes = dd2->getNodes();
-	for (std::set<Node*>::iterator nodeIt = nodes.begin(); nodeIt != nodes.end(); nodeIt++){
-		for (std::set<Node*>::iterator dd2it = dd2nodes.begin(); dd2it != dd2nodes.end(); dd2it++){
-			if ((*nodeIt)->getLabel() == (*dd2it)->getLabel()) throw DecisionDiagram::InvalidDecisionDiagram(std::string("Tried to union decision diagrams. Node label \"") + (*nodeIt)->getLabel() + std::string("\" is not unique."));
-		}
+	// Check for node label uniqueness (with the final labels of fresh nodes)
+	materializeLabels();
+	dd2->materializeLabels();
+	for (std::set<Node*>::const_iterator dd2it = dd2->nodes.begin(); dd2it != dd2->nodes.end(); dd2it++){
+		if (labelIndex.find((*dd2it)->getLabelSymbol()) != labelIndex.end()) throw DecisionDiagram::InvalidDecisionDiagram(std::string("Tried to union decision diagrams. Node label \"") + (*dd2it)->getLabel() + std::string("\" is not unique."));
 	}
 
 	// Merge all nodes and edges
 	Node* root = NULL;
-	std::set<Edge*> dd2edges = dd2->getEdges();
-	for (std::set<Node*>::iterator it = dd2nodes.begin(); it != dd2nodes.end(); it++){
+	for (std::set<Node*>::const_iterator it = dd2->nodes.begin(); it != dd2->nodes.end(); it++){
 		Node* n = addNode(*it);
 		if ((*it) == dd2->getRoot()){
 			root = n;
 		}
 	}
-	for (std::set<Edge*>::iterator it = dd2edges.begin(); it != dd2edges.end(); it++){
-		addEdge(*it);
+	for (std::set<Node*>::const_iterator it = dd2->nodes.begin(); it != dd2->nodes.end(); it++){
+		// the out-edges of each node are added in their original order
+		EdgeList outEdges = (*it)->getOutEdgeRange();
+		for (EdgeList::iterator e = outEdges.begin(); e != outEdges.end(); e++){
+			addEdge(*e);
+		}
 	}
 
 	return root;
 }
 
-DecisionDiagram::Node* DecisionDiagram::partialAddDecisionDiagram(DecisionDiagram *dd2, DecisionDiagram::Node *n){
-	try{
-		DecisionDiagram::Node* root = addNode(n);
+namespace{
+	// a node which is copied by partialAddDecisionDiagram, together with its copy (NULL if it could not be added)
+	struct PartialAddTask{
+		PartialAddTask(DecisionDiagram::Node* n_) : n(n_), copy(NULL){
+		}
+
+		DecisionDiagram::Node* n;
+		DecisionDiagram::Node* copy;
+	};
 
-		// Copy child nodes and the connecting out-edges
-		std::set<Edge*> oedges = n->getOutEdges();
-		for (std::set<Edge*>::iterator it = oedges.begin(); it != oedges.end(); it++){
-			partialAddDecisionDiagram(dd2, (*it)->getTo());
-			addEdge(*it);
+	// copies the nodes top-down and the connecting edges bottom-up
+	class PartialAdd : public DecisionDiagram::Traversal<PartialAddTask, DecisionDiagram::Node*>{
+	private:
+		DecisionDiagram& dd;
+	public:
+		PartialAdd(DecisionDiagram& dd_) : dd(dd_){
 		}
 
-		setRoot(root);
+		virtual void enter(PartialAddTask& t, std::vector<PartialAddTask>& children){
+			try{
+				t.copy = dd.addNode(t.n);
+			}catch(DecisionDiagram::InvalidDecisionDiagram idde){
+				// The node was added before: avoid running into loops
+				return;
+			}
+
+			// Copy child nodes
+			DecisionDiagram::EdgeList oedges = t.n->getOutEdgeRange();
+			for (DecisionDiagram::EdgeList::iterator it = oedges.begin(); it != oedges.end(); it++){
+				children.push_back(PartialAddTask((*it)->getTo()));
+			}
+		}
+
+		virtual DecisionDiagram::Node* leave(const PartialAddTask& t, const std::vector<DecisionDiagram::Node*>& childCopies){
+			if (t.copy == NULL) return NULL;
+
+			// Copy the connecting out-edges
+			DecisionDiagram::EdgeList oedges = t.n->getOutEdgeRange();
+			for (DecisionDiagram::EdgeList::iterator it = oedges.begin(); it != oedges.end(); it++){
+				dd.addEdge(*it);
+			}
+			return t.copy;
+		}
+	};
+}
+
+DecisionDiagram::Node* DecisionDiagram::partialAddDecisionDiagram(DecisionDiagram *dd2, DecisionDiagram::Node *n){
+	try{
+		PartialAdd partialAdd(*this);
+		DecisionDiagram::Node* root = partialAdd.run(PartialAddTask(n));
+		if (root != NULL) setRoot(root);
 		return root;
 	}catch(InvalidDecisionDiagram idde){
-		// Avoid running into loops
-		NULL;
+		return NULL;
 	}
 }
 
+DecisionDiagram::Node* DecisionDiagram::mergeInto(DecisionDiagram& target, RenamePolicy policy) const{
+	std::vector<const Node*> sourceNodes(nodes.begin(), nodes.end());
+	return mergeInto(target, policy, sourceNodes, root);
+}
+
+DecisionDiagram::Node* DecisionDiagram::mergeInto(DecisionDiagram& target, RenamePolicy policy, const Node* start) const{
+	// Check if start is part of this decision diagram
+	if (start == NULL || start->owner != this) throw InvalidDecisionDiagram("Tried to merge a subdiagram. Error: The start node is not part of the decision diagram.");
+
+	// Collect the nodes which are reachable from start (depth-first, children in the order of the out-edges)
+	std::vector<const Node*> sourceNodes;
+	boost::unordered_map<const Node*, bool> visited;
+	std::vector<const Node*> stack(1, start);
+	while (!stack.empty()){
+		const Node* n = stack.back();
+		stack.pop_back();
+		if (visited[n]) continue;
+		visited[n] = true;
+		sourceNodes.push_back(n);
+		EdgeList outEdges = n->getOutEdgeRange();
+		for (int i = (int)outEdges.size() - 1; i >= 0; i--) stack.push_back(outEdges[i]->getTo());
+	}
+	return mergeInto(target, policy, sourceNodes, start);
+}
+
+DecisionDiagram::Node* DecisionDiagram::mergeInto(DecisionDiagram& target, RenamePolicy policy, const std::vector<const Node*>& sourceNodes, const Node* sourceRoot) const{
+	if (policy == keepLabels){
+		// Check for node label uniqueness before target is modified
+		for (std::vector<const Node*>::const_iterator it = sourceNodes.begin(); it != sourceNodes.end(); it++){
+			if (target.labelIndex.find((*it)->getLabelSymbol()) != target.labelIndex.end()) throw InvalidDecisionDiagram(std::string("Tried to merge decision diagrams. Node label \"") + (*it)->getLabel() + std::string("\" is not unique."));
+		}
+	}
+
+	// Copy the nodes; nodes whose labels collide (or are pending) become fresh nodes in target, i.e. they are renamed only when their labels are needed
+	boost::unordered_map<const Node*, Node*> copies;
+	for (std::vector<const Node*>::const_iterator it = sourceNodes.begin(); it != sourceNodes.end(); it++){
+		bool fresh = (*it)->labelPending || target.labelIndex.find((*it)->label) != target.labelIndex.end();
+		if ((*it)->isLeaf())	copies[*it] = target.insertLeafNode((*it)->label, (*it)->asLeaf()->classification, fresh);
+		else			copies[*it] = target.insertNode((*it)->label, fresh);
+	}
+
+	// Copy the out-edges of each node (in their original order); the conditions are already parsed and are taken over as they are
+	for (std::vector<const Node*>::const_iterator it = sourceNodes.begin(); it != sourceNodes.end(); it++){
+		Node* from = copies[*it];
+		EdgeList outEdges = (*it)->getOutEdgeRange();
+		for (EdgeList::iterator e = outEdges.begin(); e != outEdges.end(); e++){
+			Node* to = copies[(*e)->getTo()];
+			if ((*e)->isElse())	target.insertElseEdge(from, to);
+			else			target.insertEdge(from, to, (*e)->getCondition());
+		}
+	}
+
+	return sourceRoot == NULL ? NULL : copies[sourceRoot];
+}
+
 int DecisionDiagram::nodeCount() const{
 	return nodes.size();
 }
 
 int DecisionDiagram::leafCount() const{
-	int lc = 0;
-	for (std::set<Node*>::iterator it = nodes.begin(); it != nodes.end(); it++){
-		// inner or leaf node?
-		Node *n = *it;
-		if (dynamic_cast<LeafNode*>(n) != NULL){
-			lc++;
-		}
-	}
-	return lc;
+	return leafNodes.size();
 }
 
 int DecisionDiagram::edgeCount() const{
 	return edges.size();
 }
 
+bool DecisionDiagram::EdgeSignature::operator<(const DecisionDiagram::EdgeSignature& es2) const{
+	if (operation != es2.operation) return operation < es2.operation;
+	if (operand1 != es2.operand1) return operand1 < es2.operand1;
+	if (operand2 != es2.operand2) return operand2 < es2.operand2;
+	return child < es2.child;
+}
+
+bool DecisionDiagram::EdgeSignature::operator==(const DecisionDiagram::EdgeSignature& es2) const{
+	return operation == es2.operation && operand1 == es2.operand1 && operand2 == es2.operand2 && child == es2.child;
+}
+
+bool DecisionDiagram::NodeSignature::operator==(const DecisionDiagram::NodeSignature& ns2) const{
+	return leaf == ns2.leaf && classification == ns2.classification && edges == ns2.edges;
+}
+
+std::size_t DecisionDiagram::NodeSignatureHash::operator()(const DecisionDiagram::NodeSignature& ns) const{
+	std::size_t seed = 0;
+	boost::hash_combine(seed, ns.leaf);
+	boost::hash_combine(seed, ns.classification);
+	for (std::vector<EdgeSignature>::const_iterator it = ns.edges.begin(); it != ns.edges.end(); it++){
+		boost::hash_combine(seed, static_cast<int>(it->operation));
+		boost::hash_combine(seed, it->operand1);
+		boost::hash_combine(seed, it->operand2);
+		boost::hash_combine(seed, it->child);
+	}
+	return seed;
+}
+
+DecisionDiagram::EdgeSignature DecisionDiagram::getEdgeSignature(const DecisionDiagram::Condition& c, DecisionDiagram::Node* child){
+	EdgeSignature es;
+	es.child = child;
+	if (c.getOperation() == Condition::else_){
+		es.operation = Condition::else_;
+		es.operand1 = SymbolTable::empty;
+		es.operand2 = SymbolTable::empty;
+	}else{
+		// Normalize the orientation of the condition, such that e.g. "X < 10" and "10 > X" have the same signature
+		Condition canonical = c.getCanonical();
+		es.operation = canonical.getOperation();
+		es.operand1 = canonical.getOperand1Symbol();
+		es.operand2 = canonical.getOperand2Symbol();
+	}
+	return es;
+}
+
+DecisionDiagram::Node* DecisionDiagram::lookupShared(const DecisionDiagram::NodeSignature& signature) const{
+	UniqueTable::const_iterator it = uniqueTable.find(signature);
+	return it == uniqueTable.end() ? NULL : it->second;
+}
+
+void DecisionDiagram::registerShared(const DecisionDiagram::NodeSignature& signature, DecisionDiagram::Node* n){
+	// The keys of the unique table are not moved when the table grows, thus the node can refer to it's entry
+	std::pair<UniqueTable::iterator, bool> entry = uniqueTable.insert(UniqueTable::value_type(signature, n));
+	sharedNodes[n] = &entry.first->first;
+}
+
+void DecisionDiagram::unshare(DecisionDiagram::Node* n){
+	if (sharedNodes.empty()) return;
+
+	boost::unordered_map<Node*, const NodeSignature*>::iterator it = sharedNodes.find(n);
+	if (it != sharedNodes.end()){
+		// copy the key since the entry it refers to is removed
+		NodeSignature signature = *it->second;
+		sharedNodes.erase(it);
+		uniqueTable.erase(signature);
+	}
+}
+
+DecisionDiagram::LeafNode* DecisionDiagram::addSharedLeafNode(std::string label, std::string classification){
+	NodeSignature signature;
+	signature.leaf = true;
+	signature.classification = SymbolTable::intern(classification);
+
+	// Reuse the existing leaf node (if any)
+	Node* existing = lookupShared(signature);
+	if (existing != NULL) return static_cast<LeafNode*>(existing);
+
+	LeafNode* n = addFreshLeafNode(label, classification);
+	registerShared(signature, n);
+	return n;
+}
+
+DecisionDiagram::Node* DecisionDiagram::addSharedNode(std::string label, const std::vector<std::pair<DecisionDiagram::Condition, DecisionDiagram::Node*> >& children){
+	NodeSignature signature;
+	signature.leaf = false;
+	signature.classification = SymbolTable::empty;
+	for (std::vector<std::pair<Condition, Node*> >::const_iterator it = children.begin(); it != children.end(); it++){
+		signature.edges.push_back(getEdgeSignature(it->first, it->second));
+	}
+	// The order of the edges is irrelevant
+	std::sort(signature.edges.begin(), signature.edges.end());
+
+	// Reuse the existing node (if any)
+	Node* existing = lookupShared(signature);
+	if (existing != NULL) return existing;
+
+	Node* n = addFreshNode(label);
+	for (std::vector<std::pair<Condition, Node*> >::const_iterator it = children.begin(); it != children.end(); it++){
+		addEdge(n, it->second, it->first);
+	}
+	registerShared(signature, n);
+	return n;
+}
+
 void DecisionDiagram::setRoot(Node* root){
 	// Check if root is part of this decision diagram
 	if (nodes.find(root) == nodes.end()) throw InvalidDecisionDiagram("The given root node is not part of this decision diagram.");
 	this->root = root;
+	invalidateTopology();
+}
+
+void DecisionDiagram::relabelNode(DecisionDiagram::Node* n, std::string label){
+	SymbolTable::Id l = SymbolTable::intern(label);
+	if (n->label == l && !n->labelPending) return;
+
+	// Check if the new label is unique
+	if (labelIndex.find(l) != labelIndex.end()) throw InvalidDecisionDiagram(std::string("Tried to rename node \"") + SymbolTable::lookup(n->label) + std::string("\". Error: The label \"") + label + std::string("\" is not unique."));
+
+	// An explicit label replaces a pending one
+	if (n->labelPending){
+		n->labelPending = false;
+		pendingLabels.erase(n->id);
+	}else{
+		labelIndex.erase(n->label);
+	}
+	labelIndex[l] = n;
+	if (!labelCounters.empty()) labelCounters.clear();
+	n->label = l;
+}
+
+void DecisionDiagram::materializeLabels() const{
+	if (pendingLabels.empty()) return;
+
+	// In the order of creation, such that the result does not depend on which node was asked first
+	std::map<boost::uint32_t, Node*> pending;
+	pending.swap(pendingLabels);
+	for (std::map<boost::uint32_t, Node*>::iterator it = pending.begin(); it != pending.end(); it++){
+		Node* n = it->second;
+		if (labelIndex.find(n->label) != labelIndex.end()) n->label = SymbolTable::intern(getUniqueLabel(SymbolTable::lookup(n->label)));
+		n->labelPending = false;
+		labelIndex[n->label] = n;
+	}
+}
+
+bool DecisionDiagram::containsLabel(const std::string& label) const{
+	materializeLabels();
+
+	// Strings which were never interned cannot be the label of any node
+	SymbolTable::Id l;
+	return SymbolTable::find(label, l) && labelIndex.find(l) != labelIndex.end();
 }
 
 void DecisionDiagram::useUniqueLabels(DecisionDiagram* dd2){
 
-	//    Check all nodes
+	// The final labels of fresh nodes must be known in both diagrams
+	materializeLabels();
+	dd2->materializeLabels();
+
+	// Check all nodes
 	for (std::set<DecisionDiagram::Node*>::iterator nodeIt = nodes.begin(); nodeIt != nodes.end(); nodeIt++){
+		// Labels which do not occur in dd2 are unique already (they were checked for uniqueness within this diagram when the nodes were inserted)
+		if (dd2->labelIndex.find((*nodeIt)->getLabelSymbol()) == dd2->labelIndex.end()) continue;
 		std::string originalname = (*nodeIt)->getLabel();
-		int appendixctr = 0;
-		bool dupfound = true;
-		while (dupfound){
-			dupfound = false;
-			std::stringstream newname;
-
-			// Compare each of them with all nodes of dd2
-			std::set<DecisionDiagram::Node*> dd2nodes = dd2->getNodes();
-			for (std::set<DecisionDiagram::Node*>::iterator dd2it = dd2nodes.begin(); dd2it != dd2nodes.end(); dd2it++){
-				if ((*nodeIt)->getLabel() == (*dd2it)->getLabel()){
-					appendixctr++;
-
-					// rename node
-					newname << originalname << "_" << appendixctr;
-					(*nodeIt)->setLabel(newname.str());
-
-					// recheck for duplicates until a unique name was found
-					dupfound = true;
-					break;
-				}
-			}
 
-			// This condition is just for the sake of performance enhancement
-			//   if dupfound is true, the final result is already clear and another check is unnecessary
-			//   if appendixctr == 0, the node label was not changes so far. In this case it is unique for sure, since labels are already checked for uniqueness when nodes are inserted.
-			if (!dupfound && appendixctr > 0){
-				//   Compare each of them with all other nodes of this decision diagram
-				for (std::set<DecisionDiagram::Node*>::iterator nodeIt2 = nodes.begin(); nodeIt2 != nodes.end(); nodeIt2++){
-					if ((*nodeIt) != (*nodeIt2) && (*nodeIt)->getLabel() == (*nodeIt2)->getLabel()){
-						appendixctr++;
-
-						// rename node
-						newname << originalname << "_" << appendixctr;
-						(*nodeIt)->setLabel(newname.str());
-
-						// recheck for duplicates until a unique name was found
-						dupfound = true;
-						break;
-					}
-				}
-			}
-		}
+		// Append the smallest number such that the label is neither used in dd2 nor in this decision diagram
+		int appendixctr = 0;
+		std::string newname;
+		do{
+			appendixctr++;
+			std::stringstream ss;
+			ss << originalname << "_" << appendixctr;
+			newname = ss.str();
+		}while (dd2->containsLabel(newname) || containsLabel(newname));
+
+		// rename node
+		(*nodeIt)->setLabel(newname);
 	}
 }
 
 std::string DecisionDiagram::getUniqueLabel(std::string proposal) const{
-
-	std::string result = proposal;
-	bool dupfound = true;
-	int appendixctr = 0;
-	while (dupfound){
-		dupfound = false;
-		std::stringstream newname;
-
-		// Compare the proposal with all nodes
-		for (std::set<DecisionDiagram::Node*>::iterator it = nodes.begin(); it != nodes.end(); it++){
-			// Duplicate?
-			if ((*it)->getLabel() == result){
-				appendixctr++;
-
-				// rename node
-				newname << proposal << "_" << appendixctr;
-				result = newname.str();
-
-				// recheck for duplicates until a unique name was found
-				dupfound = true;
-				break;
-			}
-		}
-	}
-
+	if (!containsLabel(proposal)) return proposal;
+
+	// Continue behind the numbers which are known to be in use
+	int& appendixctr = labelCounters[proposal];
+	std::string result;
+	do{
+		// Duplicate: try the next number
+		appendixctr++;
+		result = proposal;
+		result += '_';
+		appendNumber(result, appendixctr);
+	}while (containsLabel(result));
+
+	// The returned label is not in use yet
+	appendixctr--;
 	return result;
 }
 
@@ -763,76 +1290,70 @@ std::set<DecisionDiagram::Node*> DecisionDiagram::getNodes() const{
 }
 
 std::set<DecisionDiagram::LeafNode*> DecisionDiagram::getLeafNodes() const{
-	std::set<DecisionDiagram::LeafNode*> leafs;
-	// For all nodes
-	for (std::set<DecisionDiagram::Node*>::iterator it = nodes.begin(); it != nodes.end(); it++){
-		// Check if this is a leaf
-		if (dynamic_cast<DecisionDiagram::LeafNode*>(*it) != NULL){
-			leafs.insert(dynamic_cast<DecisionDiagram::LeafNode*>(*it));
-		}
-	}
-	return leafs;
+	return leafNodes;
 }
 
 std::set<DecisionDiagram::Edge*> DecisionDiagram::getEdges() const{
 	return edges;
 }
 
+DecisionDiagram::NodeRange DecisionDiagram::getNodeRange() const{
+	return NodeRange(nodes.begin(), nodes.end());
+}
+
+DecisionDiagram::LeafNodeRange DecisionDiagram::getLeafNodeRange() const{
+	return LeafNodeRange(leafNodes.begin(), leafNodes.end());
+}
+
+DecisionDiagram::EdgeRange DecisionDiagram::getEdgeRange() const{
+	return EdgeRange(edges.begin(), edges.end());
+}
+
 DecisionDiagram::Node* DecisionDiagram::getRoot() const{
 	return root;
 }
 
 std::vector<DecisionDiagram::Node*> DecisionDiagram::containsCycles() const{
 
-	// Prepare an associative array; we need to assign one parent node to each node of the decision diagram
-	std::map<DecisionDiagram::Node*, DecisionDiagram::Node*> parents;
-	parents[root] = NULL;
-
-	// The following code performs a depth-first search. This algorithm is logically recursive. However, to avoid the necessity of an additional recursive method, is it implemented
-	// non-recursive using std::stack.
-	// First element each the pair identifies the node, the second one tells if the node is to expand (true) or if expansion has finished (false).
-	std::stack<std::pair<DecisionDiagram::Node*, bool> > stack;
-	stack.push(std::pair<DecisionDiagram::Node*, bool>(root, true));
-
-	// Runtime: O(|E|), where E is the set of edges
-	while (!stack.empty()){
-		// Expand the stack's top level element
-		std::pair<DecisionDiagram::Node*, bool> p = stack.top();
-		stack.pop();
-		DecisionDiagram::Node* expandedNode = p.first;
-		if (p.second){
-			stack.push(std::pair<DecisionDiagram::Node*, bool>(expandedNode, false));
-			// Process all children
-			std::set<DecisionDiagram::Edge*> children = expandedNode->getOutEdges();
-			for (std::set<DecisionDiagram::Edge*>::iterator it = children.begin(); it != children.end(); it++){
-				DecisionDiagram::Node* childNode = (*it)->getTo();
-
-				// Check if a cycle is discovered; in case of a cycle, this child has already a parent tag
-				if (parents.find(childNode) != parents.end() && parents[childNode] != p.first){
-					// Cycle detected
-					// Backtrack the path to extract the cycle
-					std::vector<Node*> cycle;
-					std::vector<Node*> cyclerev;
-					Node* backtrack = expandedNode;
-					cycle.push_back(childNode);
-					while (backtrack != childNode){
-						cycle.push_back(backtrack);
-						backtrack = parents[backtrack];
-					}
-					cycle.push_back(childNode);
-					// Reverse content due to edge direction
-					for (std::vector<Node*>::reverse_iterator it = cycle.rbegin(); it != cycle.rend(); it++) cyclerev.push_back(*it);
-					return cyclerev;
-				}else{
-					// No cycle: Store parent of this child
-					parents[childNode] = expandedNode;
-					stack.push(std::pair<DecisionDiagram::Node*, bool>(childNode, true));
-				}
+	// A topological order of all nodes exists iff the diagram is acyclic
+	updateTopology();
+	if (acyclic) return std::vector<Node*>();
+
+	// Depth-first search with three colors: 0 = unvisited, 1 = on the current path, 2 = finished
+	std::vector<char> color(nodes.size(), 0);
+	std::vector<Node*> parent(nodes.size(), (Node*)NULL);
+
+	// Each stack entry holds a node and the index of the next out-edge to process
+	std::stack<std::pair<Node*, int> > stack;
+	for (std::set<Node*>::const_iterator start = nodes.begin(); start != nodes.end(); start++){
+		if (color[(*start)->topologyIndex] != 0) continue;
+		color[(*start)->topologyIndex] = 1;
+		stack.push(std::pair<Node*, int>(*start, 0));
+
+		// Runtime: O(|V| + |E|)
+		while (!stack.empty()){
+			std::pair<Node*, int>& top = stack.top();
+			Node* n = top.first;
+			if (top.second == n->getOutEdgesCount()){
+				// all children processed
+				color[n->topologyIndex] = 2;
+				stack.pop();
+				continue;
+			}
+			Node* child = n->getChild(top.second++);
+			if (color[child->topologyIndex] == 1){
+				// Cycle detected: backtrack the path to extract it
+				std::vector<Node*> cycle;
+				cycle.push_back(child);
+				for (Node* backtrack = n; backtrack != child; backtrack = parent[backtrack->topologyIndex]) cycle.push_back(backtrack);
+				cycle.push_back(child);
+				// Reverse content due to edge direction
+				return std::vector<Node*>(cycle.rbegin(), cycle.rend());
+			}else if (color[child->topologyIndex] == 0){
+				color[child->topologyIndex] = 1;
+				parent[child->topologyIndex] = n;
+				stack.push(std::pair<Node*, int>(child, 0));
 			}
-		}else{
-			// Node was successfully processed: Remove it's parent tag, since a node can have several parents (because we are working with general acyclic graphs rather than trees).
-			// Multiple parents are only illegal if they occur on one directed path through the graph.
-			parents.erase(expandedNode);
 		}
 	}
 
@@ -841,15 +1362,13 @@ std::vector<DecisionDiagram::Node*> DecisionDiagram::containsCycles() const{
 }
 
 bool DecisionDiagram::isTree() const{
-	// Check for all nodes if they have more than one ingoing edges
-	for (std::set<Node*>::iterator it = nodes.begin(); it != nodes.end(); it++){
-		if ((*it)->getInEdgesCount() > 1) return false;
-	}
-	// No such node was found
-	return true;
+	// No node must have more than one ingoing edge
+	return multiParentNodeCount == 0;
 }
 
 bool DecisionDiagram::operator==(const DecisionDiagram &dd2) const{
+	if (getRoot() == NULL || dd2.getRoot() == NULL) return getRoot() == dd2.getRoot();
+
 	// Just compare the root nodes, then the diagrams are compared recursivly
 	return (*getRoot()) == (*dd2.getRoot());
 }
@@ -860,103 +1379,291 @@ bool DecisionDiagram::operator!=(const DecisionDiagram &dd2) const{
 
 bool DecisionDiagram::containsPath(const Node* from, const Node* to) const{
 	if (from == to) return true;
-	else{
-		// check recursivly if one of from's children has a path to "to"
-		std::set<Edge*> outEdges = from->getOutEdges();
-		for (std::set<Edge*>::iterator it = outEdges.begin(); it != outEdges.end(); it++){
-			if (containsPath((*it)->getTo(), to)) return true;
+
+	// depth-first search which visits each node at most once
+	std::vector<bool> visited(nodes.size(), false);
+	std::stack<const Node*> stack;
+	stack.push(from);
+	visited[getNodeIndex(from)] = true;
+	while (!stack.empty()){
+		const Node* n = stack.top();
+		stack.pop();
+		if (n == to) return true;
+		EdgeList outEdges = n->getOutEdgeRange();
+		for (EdgeList::iterator it = outEdges.begin(); it != outEdges.end(); it++){
+			const Node* child = (*it)->getTo();
+			if (!visited[child->topologyIndex]){
+				visited[child->topologyIndex] = true;
+				stack.push(child);
+			}
 		}
-		// no path found
-		return false;
 	}
+	// no path found
+	return false;
 }
 
-DecisionDiagram::Node* DecisionDiagram::getNodeByLabel(std::string label) const{
-	for (std::set<Node*>::iterator it = nodes.begin(); it != nodes.end(); it++){
-		if ((*it)->getLabel() == label){
-			return *it;
+void DecisionDiagram::invalidateTopology(){
+	topologyValid = false;
+	statisticsValid = false;
+}
+
+void DecisionDiagram::updateTopology() const{
+	if (topologyValid) return;
+
+	// Number the nodes densely
+	int index = 0;
+	for (std::set<Node*>::const_iterator it = nodes.begin(); it != nodes.end(); it++){
+		(*it)->topologyIndex = index++;
+	}
+
+	// Topological order (Kahn's algorithm): a node is appended as soon as all its parents were appended
+	topologicalOrder.clear();
+	std::vector<int> remainingInEdges(nodes.size());
+	for (std::set<Node*>::const_iterator it = nodes.begin(); it != nodes.end(); it++){
+		remainingInEdges[(*it)->topologyIndex] = (*it)->getInEdgesCount();
+		if ((*it)->getInEdgesCount() == 0) topologicalOrder.push_back(*it);
+	}
+	for (unsigned int i = 0; i < topologicalOrder.size(); i++){
+		EdgeList outEdges = topologicalOrder[i]->getOutEdgeRange();
+		for (EdgeList::iterator it = outEdges.begin(); it != outEdges.end(); it++){
+			Node* child = (*it)->getTo();
+			if (--remainingInEdges[child->topologyIndex] == 0) topologicalOrder.push_back(child);
 		}
 	}
-	// Not found: error: no matching function for call to ‘dlvhex::asp::DecisionDiagram::addNode(dlvhex::asp::DecisionDiagram::Node&)’
-	throw InvalidDecisionDiagram(std::string("Tried to retrieve node by label. Error: Node with label \"") + label + std::string("\" does not exist"));
+	// nodes on cycles (and below them) are never appended
+	acyclic = (topologicalOrder.size() == nodes.size());
+
+	// Mark the nodes which are reachable from the root
+	reachableFromRoot.assign(nodes.size(), false);
+	if (root != NULL){
+		std::stack<Node*> stack;
+		stack.push(root);
+		reachableFromRoot[root->topologyIndex] = true;
+		while (!stack.empty()){
+			Node* n = stack.top();
+			stack.pop();
+			EdgeList outEdges = n->getOutEdgeRange();
+			for (EdgeList::iterator it = outEdges.begin(); it != outEdges.end(); it++){
+				Node* child = (*it)->getTo();
+				if (!reachableFromRoot[child->topologyIndex]){
+					reachableFromRoot[child->topologyIndex] = true;
+					stack.push(child);
+				}
+			}
+		}
+	}
+
+	topologyValid = true;
 }
 
-AtomSet DecisionDiagram::toAnswerSet() const{
-	return toAnswerSet(false, 0);
+int DecisionDiagram::getNodeIndex(const Node* n) const{
+	// Check if n is part of this decision diagram
+	if (n == NULL || n->owner != this) throw InvalidDecisionDiagram("Tried to retrieve the index of a node which is not part of this decision diagram.");
+	updateTopology();
+	return n->topologyIndex;
 }
 
-AtomSet DecisionDiagram::toAnswerSet(bool addIndex, int index) const{
-	AtomSet	as;
-	// Create tuples for nodes
+const std::vector<DecisionDiagram::Node*>& DecisionDiagram::getTopologicalOrder() const{
+	updateTopology();
+	if (!acyclic) throw InvalidDecisionDiagram("Tried to retrieve the topological order of the nodes. Error: The decision diagram contains a cycle.");
+	return topologicalOrder;
+}
+
+const std::vector<bool>& DecisionDiagram::getReachableFromRoot() const{
+	updateTopology();
+	return reachableFromRoot;
+}
+
+bool DecisionDiagram::isReachableFromRoot(const Node* n) const{
+	return reachableFromRoot[getNodeIndex(n)];
+}
+
+int DecisionDiagram::collectUnreachable(){
+
+	// Mark: the reachable nodes are known from the topology cache
+	updateTopology();
+	std::vector<Node*> unreachable;
 	for (std::set<Node*>::iterator it = nodes.begin(); it != nodes.end(); it++){
-		// inner or leaf node?
-		Node *n = *it;
-		if (dynamic_cast<LeafNode*>(n) != NULL){
-			// leaf node
-			Tuple args;
-			if (addIndex) args.push_back(Term(index));
-			args.push_back(Term(n->getLabel()));
-			args.push_back(Term(dynamic_cast<struct LeafNode*>(n)->getClassification(), true));
-			as.insert(AtomPtr(new Atom(std::string("leafnode") + (addIndex ? std::string("In") : std::string("")), args)));
-		}else{
-			// inner node
-			Tuple args;
-			if (addIndex) args.push_back(Term(index));
-			args.push_back(Term(n->getLabel()));
-			as.insert(AtomPtr(new Atom(std::string("innernode") + (addIndex ? std::string("In") : std::string("")), args)));
-		}
+		if (!reachableFromRoot[(*it)->topologyIndex]) unreachable.push_back(*it);
 	}
 
-	// Create tuples for edges
-	for (std::set<Edge*>::iterator it = edges.begin(); it != edges.end(); it++){
-		// conditional or else edge?
-		DecisionDiagram::Edge *e = *it;
-		if (dynamic_cast<ElseEdge*>(e) == NULL){
-			// conditional edge
-			Tuple args;
-			if (addIndex) args.push_back(Term(index));
-			args.push_back(Term(e->getFrom()->getLabel()));
-			args.push_back(Term(e->getTo()->getLabel()));
-			args.push_back(Term(e->getCondition().getOperand1(), true));
-			args.push_back(Term(DecisionDiagram::Condition::cmpOpToString(e->getCondition().getOperation()), true));
-			args.push_back(Term(e->getCondition().getOperand2(), true));
-			as.insert(AtomPtr(new Atom(std::string("conditionaledge") + (addIndex ? std::string("In") : std::string("")), args)));
-		}else{
-			// else edge
-			Tuple args;
-			if (addIndex) args.push_back(Term(index));
-			args.push_back(Term(e->getFrom()->getLabel()));
-			args.push_back(Term(e->getTo()->getLabel()));
-			as.insert(AtomPtr(new Atom(std::string("elseedge") + (addIndex ? std::string("In") : std::string("")), args)));
+	// Sweep (edges between two unreachable nodes are removed together with the first of them)
+	for (std::vector<Node*>::iterator it = unreachable.begin(); it != unreachable.end(); it++){
+		removeNode(*it, true);
+	}
+	return unreachable.size();
+}
+
+void DecisionDiagram::updateStatistics() const{
+	if (statisticsValid) return;
+
+	// Attribute usage (all conditional edges)
+	attributeUsage.clear();
+	for (std::set<Edge*>::const_iterator it = edges.begin(); it != edges.end(); it++){
+		if (!(*it)->isElse() && (*it)->getCondition().hasAttribute()) attributeUsage[(*it)->getCondition().getAttributeSymbol()]++;
+	}
+
+	// Depth and path counts: propagate from the root in topological order (only defined for acyclic diagrams)
+	updateTopology();
+	depth = 0;
+	pathCount = 0;
+	unfoldedNodeCount = 0;
+	if (root != NULL && acyclic){
+		const std::vector<Node*>& order = topologicalOrder;
+		std::vector<int> nodeDepth(nodes.size(), 0);
+		std::vector<double> pathsToNode(nodes.size(), 0);
+		pathsToNode[root->topologyIndex] = 1;
+		for (std::vector<Node*>::const_iterator it = order.begin(); it != order.end(); it++){
+			int index = (*it)->topologyIndex;
+			if (!reachableFromRoot[index]) continue;
+			depth = std::max(depth, nodeDepth[index]);
+			unfoldedNodeCount += pathsToNode[index];
+			if ((*it)->isLeaf()) pathCount += pathsToNode[index];
+
+			EdgeList outEdges = (*it)->getOutEdgeRange();
+			for (EdgeList::iterator e = outEdges.begin(); e != outEdges.end(); e++){
+				int child = (*e)->getTo()->topologyIndex;
+				nodeDepth[child] = std::max(nodeDepth[child], nodeDepth[index] + 1);
+				pathsToNode[child] += pathsToNode[index];
+			}
 		}
 	}
 
-	// Root node
-	if (root != NULL){
-		Tuple arg;
-		if (addIndex) arg.push_back(Term(index));
-		arg.push_back(Term(root->getLabel()));
-		as.insert(AtomPtr(new Atom(std::string("root") + (addIndex ? std::string("In") : std::string("")), arg)));
+	statisticsValid = true;
+}
+
+int DecisionDiagram::getDepth() const{
+	updateStatistics();
+	if (!acyclic) throw InvalidDecisionDiagram("Tried to compute path statistics. Error: The decision diagram contains a cycle.");
+	return depth;
+}
+
+double DecisionDiagram::getPathCount() const{
+	updateStatistics();
+	if (!acyclic) throw InvalidDecisionDiagram("Tried to compute path statistics. Error: The decision diagram contains a cycle.");
+	return pathCount;
+}
+
+double DecisionDiagram::getUnfoldedNodeCount() const{
+	updateStatistics();
+	if (!acyclic) throw InvalidDecisionDiagram("Tried to compute path statistics. Error: The decision diagram contains a cycle.");
+	return unfoldedNodeCount;
+}
+
+const DecisionDiagram::AttributeUsage& DecisionDiagram::getAttributeUsage() const{
+	updateStatistics();
+	return attributeUsage;
+}
+
+int DecisionDiagram::getAttributeUsage(SymbolTable::Id attribute) const{
+	updateStatistics();
+	AttributeUsage::const_iterator it = attributeUsage.find(attribute);
+	return it == attributeUsage.end() ? 0 : it->second;
+}
+
+DecisionDiagram::Node* DecisionDiagram::getNodeByLabel(std::string label) const{
+	materializeLabels();
+	SymbolTable::Id l;
+	if (SymbolTable::find(label, l)){
+		LabelIndex::const_iterator it = labelIndex.find(l);
+		if (it != labelIndex.end()){
+			return it->second;
+		}
 	}
-	return as;
+	// Not found
+	throw InvalidDecisionDiagram(std::string("Tried to retrieve node by label. Error: Node with label \"") + label + std::string("\" does not exist"));
 }
 
-std::string DecisionDiagram::toString() const{
+DecisionDiagram::Node* DecisionDiagram::getNodeByLabelSymbol(SymbolTable::Id label) const{
+	materializeLabels();
+	LabelIndex::const_iterator it = labelIndex.find(label);
+	if (it != labelIndex.end()){
+		return it->second;
+	}
+	// Not found
+	throw InvalidDecisionDiagram(std::string("Tried to retrieve node by label. Error: Node with label \"") + SymbolTable::lookup(label) + std::string("\" does not exist"));
+}
 
-	// Create a list of nodes
-	std::stringstream output;
-	bool first = true;
-	output << "Nodes: ";
-	for (std::set<Node*>::iterator it = nodes.begin(); it != nodes.end(); it++){
-		output << (first ? "" : ", ") << (*it)->toString();
-		first = false;
+namespace{
+	// orders nodes by their labels (used for the nodes which are not reachable from the root)
+	bool labelLess(const DecisionDiagram::Node* n1, const DecisionDiagram::Node* n2){
+		return n1->getLabel() < n2->getLabel();
 	}
+}
 
-	// Create list of edges
-	output << std::endl;
-	output << "Edges: " << std::endl;
-	for (std::set<Edge*>::iterator it = edges.begin(); it != edges.end(); it++){
-		output << "     " << (*it)->toString() << std::endl;
+void DecisionDiagram::emit(Sink& sink) const{
+	sink.begin(*this);
+
+	// Start nodes of the walk: the root, then all nodes which are not reachable from it
+	updateTopology();
+	std::vector<Node*> start;
+	if (root != NULL) start.push_back(root);
+	std::vector<Node*> unreachable;
+	for (std::set<Node*>::const_iterator it = nodes.begin(); it != nodes.end(); it++){
+		if (!reachableFromRoot[(*it)->topologyIndex]) unreachable.push_back(*it);
+	}
+	std::sort(unreachable.begin(), unreachable.end(), labelLess);
+	start.insert(start.end(), unreachable.begin(), unreachable.end());
+
+	// Depth-first walk with an explicit stack (children are pushed in reverse order such that they are visited in the order of the out-edges)
+	std::vector<bool> visited(nodes.size(), false);
+	std::vector<Node*> stack;
+	for (std::vector<Node*>::iterator sit = start.begin(); sit != start.end(); sit++){
+		stack.push_back(*sit);
+		while (!stack.empty()){
+			Node* n = stack.back();
+			stack.pop_back();
+			if (visited[n->topologyIndex]) continue;
+			visited[n->topologyIndex] = true;
+
+			if (n->isLeaf()) sink.leafNode(n->asLeaf());
+			else sink.innerNode(n);
+
+			EdgeList outEdges = n->getOutEdgeRange();
+			for (EdgeList::iterator it = outEdges.begin(); it != outEdges.end(); it++){
+				if ((*it)->isElse()) sink.elseEdge(*it);
+				else sink.conditionalEdge(*it);
+			}
+			for (int i = (int)outEdges.size() - 1; i >= 0; i--){
+				Node* child = outEdges[i]->getTo();
+				if (!visited[child->topologyIndex]) stack.push_back(child);
+			}
+		}
 	}
+
+	if (root != NULL) sink.rootNode(root);
+	sink.end();
+}
+
+AtomSet DecisionDiagram::toAnswerSet() const{
+	AtomSet as;
+	AtomSetSink sink(as);
+	emit(sink);
+	return as;
+}
+
+AtomSet DecisionDiagram::toAnswerSet(bool addIndex, int index) const{
+	if (!addIndex) return toAnswerSet();
+	AtomSet as;
+	AtomSetSink sink(as, index);
+	emit(sink);
+	return as;
+}
+
+std::string DecisionDiagram::toString() const{
+	std::stringstream output;
+	TextSink sink(output);
+	emit(sink);
 	return output.str();
 }
+
+void DecisionDiagram::save(std::ostream& out) const{
+	std::vector<const DecisionDiagram*> diagrams(1, this);
+	DecisionDiagramFile::write(out, diagrams);
+}
+
+void DecisionDiagram::load(const std::string& filename){
+	DecisionDiagramFile file(filename);
+	if (file.diagramCount() == 0) throw InvalidDecisionDiagram(std::string("Error: File \"") + filename + std::string("\" does not contain a decision diagram."));
+	file.toDecisionDiagram(0, *this);
+}
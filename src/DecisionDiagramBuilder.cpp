@@ -0,0 +1,71 @@
+#include <DecisionDiagramBuilder.h>
+
+#include <sstream>
+
+using namespace dlvhex::dd::util;
+
+DecisionDiagramBuilder::PendingEdge::PendingEdge(SymbolTable::Id from_, SymbolTable::Id to_, const DecisionDiagram::Condition& condition_) : from(from_), to(to_), condition(condition_){
+}
+
+void DecisionDiagramBuilder::checkArity(const Atom& atom, unsigned int arity){
+	// additional arguments are tolerated (and ignored)
+	if (atom.getArity() < arity){
+		std::stringstream msg;
+		msg << "Error: Atom with predicate \"" << atom.getPredicate().getString() << "\" has " << atom.getArity() << " arguments, but at least " << arity << " were expected.";
+		throw DecisionDiagram::InvalidDecisionDiagram(msg.str());
+	}
+}
+
+void DecisionDiagramBuilder::build(const AtomSet& as, DecisionDiagram& dd){
+
+	DecisionDiagram result;
+	result.reserve(as.size());
+
+	// conditional edges are inserted before else edges (such that the order of the out-edges of each node is independent of the atom order)
+	std::vector<PendingEdge> conditionalEdges;
+	std::vector<PendingEdge> elseEdges;
+	SymbolTable::Id rootLabel = SymbolTable::empty;
+	bool rootFound = false;
+
+	// Visit all atoms once
+	for (AtomSet::const_iterator it = as.begin(); it != as.end(); it++){
+		const std::string& predicate = it->getPredicate().getString();
+		const Tuple& args = it->getArguments();
+
+		if (predicate == "innernode"){
+			checkArity(*it, 1);
+			result.addNode(args[0].getUnquotedString());
+		}else if (predicate == "leafnode"){
+			checkArity(*it, 2);
+			result.addLeafNode(args[0].getUnquotedString(), args[1].getUnquotedString());
+		}else if (predicate == "conditionaledge"){
+			checkArity(*it, 5);
+			// the comparison operator is converted only once (unknown operators are reported)
+			DecisionDiagram::Condition c(args[2].getUnquotedString(), args[4].getUnquotedString(), DecisionDiagram::Condition::stringToCmpOp(args[3].getUnquotedString()));
+			conditionalEdges.push_back(PendingEdge(SymbolTable::intern(args[0].getUnquotedString()), SymbolTable::intern(args[1].getUnquotedString()), c));
+		}else if (predicate == "elseedge"){
+			checkArity(*it, 2);
+			elseEdges.push_back(PendingEdge(SymbolTable::intern(args[0].getUnquotedString()), SymbolTable::intern(args[1].getUnquotedString()), DecisionDiagram::Condition(SymbolTable::empty, SymbolTable::empty, DecisionDiagram::Condition::else_)));
+		}else if (predicate == "root"){
+			checkArity(*it, 1);
+			SymbolTable::Id label = SymbolTable::intern(args[0].getUnquotedString());
+			if (rootFound){
+				throw DecisionDiagram::InvalidDecisionDiagram(std::string("Error: Multiple roots specified (first one with label \"") + SymbolTable::lookup(rootLabel) + std::string("\", second one with label \"") + SymbolTable::lookup(label) + std::string("\"."));
+			}
+			rootLabel = label;
+			rootFound = true;
+		}
+	}
+
+	// All nodes are known now: resolve the endpoints of the edges through the label index
+	for (std::vector<PendingEdge>::iterator it = conditionalEdges.begin(); it != conditionalEdges.end(); it++){
+		result.addEdge(result.getNodeByLabelSymbol(it->from), result.getNodeByLabelSymbol(it->to), it->condition);
+	}
+	for (std::vector<PendingEdge>::iterator it = elseEdges.begin(); it != elseEdges.end(); it++){
+		result.addElseEdge(result.getNodeByLabelSymbol(it->from), result.getNodeByLabelSymbol(it->to));
+	}
+	if (rootFound) result.setRoot(result.getNodeByLabelSymbol(rootLabel));
+
+	// The input is valid: take over the diagram
+	dd.moveFrom(result);
+}
@@ -0,0 +1,345 @@
+#include <DecisionDiagramFile.h>
+#include <CompactDecisionDiagram.h>
+
+#include <boost/unordered_map.hpp>
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <sstream>
+
+using namespace dlvhex::dd::util;
+
+const boost::uint32_t DecisionDiagramFile::none;
+const boost::uint32_t DecisionDiagramFile::version;
+
+namespace{
+	const char magicNumber[4] = { 'D', 'D', 'B', 'F' };
+	const boost::uint32_t byteOrderMark = 0x01020304;
+
+	boost::uint64_t align(boost::uint64_t offset){
+		return (offset + 7) & ~(boost::uint64_t)7;
+	}
+
+	// Checks if a section of count elements of a certain size starting at offset is within a file of a certain size
+	bool validSection(boost::uint64_t offset, boost::uint64_t count, boost::uint64_t elementSize, std::size_t size){
+		return offset % 8 == 0 && offset <= size && count <= (size - offset) / elementSize;
+	}
+
+	// Collects the strings of all diagrams (each string is stored once)
+	class StringTableBuilder{
+	private:
+		boost::unordered_map<SymbolTable::Id, boost::uint32_t> ids;
+	public:
+		std::vector<boost::uint32_t> offsets;
+		std::string data;
+
+		StringTableBuilder(){
+			offsets.push_back(0);
+		}
+
+		boost::uint32_t add(SymbolTable::Id s){
+			boost::unordered_map<SymbolTable::Id, boost::uint32_t>::iterator it = ids.find(s);
+			if (it != ids.end()) return it->second;
+			boost::uint32_t id = offsets.size() - 1;
+			ids[s] = id;
+			data += SymbolTable::lookup(s);
+			data += '\0';
+			offsets.push_back(data.size());
+			return id;
+		}
+	};
+
+	// Interns the strings of a file on demand (each string at most once)
+	class SymbolCache{
+	private:
+		const DecisionDiagramFile& file;
+		std::vector<SymbolTable::Id> symbols;
+		std::vector<bool> interned;
+	public:
+		SymbolCache(const DecisionDiagramFile& file_) : file(file_), symbols(file_.stringCount(), SymbolTable::empty), interned(file_.stringCount(), false){
+		}
+
+		SymbolTable::Id get(DecisionDiagramFile::StringId s){
+			if (!interned[s]){
+				symbols[s] = SymbolTable::intern(file.getString(s));
+				interned[s] = true;
+			}
+			return symbols[s];
+		}
+	};
+
+	void writePadding(std::ostream& out, boost::uint64_t& position, boost::uint64_t offset){
+		while (position < offset){
+			out.put('\0');
+			position++;
+		}
+	}
+
+	template<class T> void writeSection(std::ostream& out, boost::uint64_t& position, boost::uint64_t offset, const T* elements, std::size_t count){
+		writePadding(out, position, offset);
+		if (count > 0) out.write(reinterpret_cast<const char*>(elements), count * sizeof(T));
+		position += count * sizeof(T);
+	}
+}
+
+DecisionDiagramFile::DecisionDiagramFile(const std::string& filename) : data(NULL), size(0), mapping(NULL){
+	int fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd == -1) throw DecisionDiagram::InvalidDecisionDiagram(std::string("Error: Could not open file \"") + filename + std::string("\"."));
+	struct stat st;
+	if (fstat(fd, &st) == -1 || st.st_size < (off_t)sizeof(Header)){
+		::close(fd);
+		throw DecisionDiagram::InvalidDecisionDiagram(std::string("Error: File \"") + filename + std::string("\" is not a binary decision diagram file."));
+	}
+	size = st.st_size;
+	mapping = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (mapping == MAP_FAILED){
+		mapping = NULL;
+		throw DecisionDiagram::InvalidDecisionDiagram(std::string("Error: Could not map file \"") + filename + std::string("\" into memory."));
+	}
+	data = static_cast<const char*>(mapping);
+
+	try{
+		open();
+	}catch(...){
+		munmap(mapping, size);
+		throw;
+	}
+}
+
+DecisionDiagramFile::DecisionDiagramFile(const char* data_, std::size_t size_) : data(data_), size(size_), mapping(NULL){
+	open();
+}
+
+DecisionDiagramFile::~DecisionDiagramFile(){
+	if (mapping != NULL) munmap(mapping, size);
+}
+
+void DecisionDiagramFile::open(){
+	// Header
+	if (size < sizeof(Header) || reinterpret_cast<std::size_t>(data) % 8 != 0) throw DecisionDiagram::InvalidDecisionDiagram("Error: The data is not a binary decision diagram file (or is not aligned).");
+	header = reinterpret_cast<const Header*>(data);
+	if (memcmp(header->magic, magicNumber, sizeof(magicNumber)) != 0) throw DecisionDiagram::InvalidDecisionDiagram("Error: The data is not a binary decision diagram file.");
+	if (header->byteOrder != byteOrderMark) throw DecisionDiagram::InvalidDecisionDiagram("Error: The binary decision diagram file was written on a machine with a different byte order.");
+	if (header->version != version){
+		std::stringstream msg;
+		msg << "Error: Version " << header->version << " of the binary decision diagram format is not supported (expected version " << version << ").";
+		throw DecisionDiagram::InvalidDecisionDiagram(msg.str());
+	}
+
+	// Sections
+	if (!validSection(header->diagramsOffset, header->diagramCount, sizeof(DiagramRecord), size) ||
+	    !validSection(header->stringOffsetsOffset, (boost::uint64_t)header->stringCount + 1, sizeof(boost::uint32_t), size) ||
+	    !validSection(header->stringDataOffset, header->stringDataSize, 1, size) ||
+	    !validSection(header->nodesOffset, header->nodeCount, sizeof(NodeRecord), size) ||
+	    !validSection(header->edgesOffset, header->edgeCount, sizeof(EdgeRecord), size)){
+		throw DecisionDiagram::InvalidDecisionDiagram("Error: The binary decision diagram file is truncated or corrupt.");
+	}
+	diagrams = reinterpret_cast<const DiagramRecord*>(data + header->diagramsOffset);
+	stringOffsets = reinterpret_cast<const boost::uint32_t*>(data + header->stringOffsetsOffset);
+	stringData = data + header->stringDataOffset;
+	nodes = reinterpret_cast<const NodeRecord*>(data + header->nodesOffset);
+	edges = reinterpret_cast<const EdgeRecord*>(data + header->edgesOffset);
+
+	// Contents (checked once, such that the accessors can read the tables without checks)
+	const DecisionDiagram::InvalidDecisionDiagram corrupt("Error: The binary decision diagram file is corrupt.");
+	if (stringOffsets[0] != 0 || stringOffsets[header->stringCount] != header->stringDataSize) throw corrupt;
+	for (boost::uint32_t s = 0; s < header->stringCount; s++){
+		// the offsets are increasing and each string is zero-terminated
+		if (stringOffsets[s] >= stringOffsets[s + 1] || stringOffsets[s + 1] > header->stringDataSize || stringData[stringOffsets[s + 1] - 1] != '\0') throw corrupt;
+	}
+	for (boost::uint32_t d = 0; d < header->diagramCount; d++){
+		const DiagramRecord& r = diagrams[d];
+		if ((boost::uint64_t)r.firstNode + r.nodeCount > header->nodeCount || (boost::uint64_t)r.firstEdge + r.edgeCount > header->edgeCount) throw corrupt;
+		if (r.root != none && r.root >= r.nodeCount) throw corrupt;
+		for (NodeId n = 0; n < r.nodeCount; n++){
+			const NodeRecord& nr = nodes[r.firstNode + n];
+			if (nr.label >= header->stringCount || (nr.classification != none && nr.classification >= header->stringCount)) throw corrupt;
+			if ((boost::uint64_t)nr.firstEdge + nr.outDegree > r.edgeCount) throw corrupt;
+		}
+		for (EdgeId e = 0; e < r.edgeCount; e++){
+			const EdgeRecord& er = edges[r.firstEdge + e];
+			if (er.to >= r.nodeCount || er.operand1 >= header->stringCount || er.operand2 >= header->stringCount || er.operation > DecisionDiagram::Condition::else_) throw corrupt;
+		}
+	}
+}
+
+void DecisionDiagramFile::write(std::ostream& out, const std::vector<const DecisionDiagram*>& diagramList){
+	std::vector<DiagramRecord> diagramRecords;
+	std::vector<NodeRecord> nodeRecords;
+	std::vector<EdgeRecord> edgeRecords;
+	StringTableBuilder strings;
+
+	for (std::vector<const DecisionDiagram*>::const_iterator it = diagramList.begin(); it != diagramList.end(); it++){
+		// The snapshot numbers the nodes and stores the edges in CSR format, which is exactly the layout of the file
+		CompactDecisionDiagram cdd(**it);
+
+		DiagramRecord dr;
+		dr.firstNode = nodeRecords.size();
+		dr.nodeCount = cdd.nodeCount();
+		dr.firstEdge = edgeRecords.size();
+		dr.edgeCount = cdd.edgeCount();
+		dr.root = cdd.getRoot();
+		dr.reserved = 0;
+		diagramRecords.push_back(dr);
+
+		for (CompactDecisionDiagram::NodeId n = 0; n < (CompactDecisionDiagram::NodeId)cdd.nodeCount(); n++){
+			NodeRecord nr;
+			nr.label = strings.add(cdd.getLabelSymbol(n));
+			nr.classification = cdd.isLeaf(n) ? strings.add(cdd.getClassificationSymbol(n)) : none;
+			nr.firstEdge = cdd.getOutEdgesBegin(n);
+			nr.outDegree = cdd.getOutDegree(n);
+			nodeRecords.push_back(nr);
+		}
+		for (CompactDecisionDiagram::EdgeId e = 0; e < (CompactDecisionDiagram::EdgeId)cdd.edgeCount(); e++){
+			DecisionDiagram::Condition c = cdd.getCondition(e);
+			EdgeRecord er;
+			er.to = cdd.getTo(e);
+			er.operand1 = strings.add(c.getOperand1Symbol());
+			er.operand2 = strings.add(c.getOperand2Symbol());
+			er.operation = c.getOperation();
+			er.flags = (c.hasAttribute() ? hasAttributeFlag : 0) | (c.hasCmpValue() ? hasCmpValueFlag : 0) | (c.isAttributeLeft() ? attributeLeftFlag : 0);
+			er.reserved = 0;
+			er.cmpValue = c.getCmpValue();
+			edgeRecords.push_back(er);
+		}
+	}
+
+	// Header
+	Header h;
+	memset(&h, 0, sizeof(Header));
+	memcpy(h.magic, magicNumber, sizeof(magicNumber));
+	h.version = version;
+	h.byteOrder = byteOrderMark;
+	h.diagramCount = diagramRecords.size();
+	h.stringCount = strings.offsets.size() - 1;
+	h.nodeCount = nodeRecords.size();
+	h.edgeCount = edgeRecords.size();
+	h.stringDataSize = strings.data.size();
+	h.diagramsOffset = align(sizeof(Header));
+	h.stringOffsetsOffset = align(h.diagramsOffset + diagramRecords.size() * sizeof(DiagramRecord));
+	h.stringDataOffset = align(h.stringOffsetsOffset + strings.offsets.size() * sizeof(boost::uint32_t));
+	h.nodesOffset = align(h.stringDataOffset + strings.data.size());
+	h.edgesOffset = align(h.nodesOffset + nodeRecords.size() * sizeof(NodeRecord));
+
+	boost::uint64_t position = 0;
+	writeSection(out, position, 0, &h, 1);
+	writeSection(out, position, h.diagramsOffset, diagramRecords.empty() ? NULL : &diagramRecords[0], diagramRecords.size());
+	writeSection(out, position, h.stringOffsetsOffset, &strings.offsets[0], strings.offsets.size());
+	writeSection(out, position, h.stringDataOffset, strings.data.data(), strings.data.size());
+	writeSection(out, position, h.nodesOffset, nodeRecords.empty() ? NULL : &nodeRecords[0], nodeRecords.size());
+	writeSection(out, position, h.edgesOffset, edgeRecords.empty() ? NULL : &edgeRecords[0], edgeRecords.size());
+}
+
+const DecisionDiagramFile::NodeRecord& DecisionDiagramFile::node(int d, NodeId n) const{
+	return nodes[diagrams[d].firstNode + n];
+}
+
+const DecisionDiagramFile::EdgeRecord& DecisionDiagramFile::edge(int d, EdgeId e) const{
+	return edges[diagrams[d].firstEdge + e];
+}
+
+int DecisionDiagramFile::diagramCount() const{
+	return header->diagramCount;
+}
+
+int DecisionDiagramFile::stringCount() const{
+	return header->stringCount;
+}
+
+const char* DecisionDiagramFile::getString(StringId s) const{
+	return stringData + stringOffsets[s];
+}
+
+int DecisionDiagramFile::nodeCount(int d) const{
+	return diagrams[d].nodeCount;
+}
+
+int DecisionDiagramFile::edgeCount(int d) const{
+	return diagrams[d].edgeCount;
+}
+
+DecisionDiagramFile::NodeId DecisionDiagramFile::getRoot(int d) const{
+	return diagrams[d].root;
+}
+
+DecisionDiagramFile::StringId DecisionDiagramFile::getLabel(int d, NodeId n) const{
+	return node(d, n).label;
+}
+
+bool DecisionDiagramFile::isLeaf(int d, NodeId n) const{
+	return node(d, n).classification != none;
+}
+
+DecisionDiagramFile::StringId DecisionDiagramFile::getClassification(int d, NodeId n) const{
+	return node(d, n).classification;
+}
+
+DecisionDiagramFile::EdgeId DecisionDiagramFile::getOutEdgesBegin(int d, NodeId n) const{
+	return node(d, n).firstEdge;
+}
+
+DecisionDiagramFile::EdgeId DecisionDiagramFile::getOutEdgesEnd(int d, NodeId n) const{
+	return node(d, n).firstEdge + node(d, n).outDegree;
+}
+
+DecisionDiagramFile::NodeId DecisionDiagramFile::getTo(int d, EdgeId e) const{
+	return edge(d, e).to;
+}
+
+DecisionDiagram::Condition::CmpOp DecisionDiagramFile::getOperation(int d, EdgeId e) const{
+	return static_cast<DecisionDiagram::Condition::CmpOp>(edge(d, e).operation);
+}
+
+DecisionDiagramFile::StringId DecisionDiagramFile::getOperand1(int d, EdgeId e) const{
+	return edge(d, e).operand1;
+}
+
+DecisionDiagramFile::StringId DecisionDiagramFile::getOperand2(int d, EdgeId e) const{
+	return edge(d, e).operand2;
+}
+
+bool DecisionDiagramFile::hasAttribute(int d, EdgeId e) const{
+	return (edge(d, e).flags & hasAttributeFlag) != 0;
+}
+
+bool DecisionDiagramFile::hasCmpValue(int d, EdgeId e) const{
+	return (edge(d, e).flags & hasCmpValueFlag) != 0;
+}
+
+bool DecisionDiagramFile::isAttributeLeft(int d, EdgeId e) const{
+	return (edge(d, e).flags & attributeLeftFlag) != 0;
+}
+
+double DecisionDiagramFile::getCmpValue(int d, EdgeId e) const{
+	return edge(d, e).cmpValue;
+}
+
+void DecisionDiagramFile::toDecisionDiagram(int d, DecisionDiagram& dd) const{
+	dd.clear();
+	dd.reserve(nodeCount(d));
+
+	SymbolCache symbols(*this);
+
+	std::vector<DecisionDiagram::Node*> ddNodes;
+	ddNodes.reserve(nodeCount(d));
+	for (NodeId n = 0; n < (NodeId)nodeCount(d); n++){
+		const std::string& label = SymbolTable::lookup(symbols.get(getLabel(d, n)));
+		if (isLeaf(d, n))	ddNodes.push_back(dd.addLeafNode(label, SymbolTable::lookup(symbols.get(getClassification(d, n)))));
+		else			ddNodes.push_back(dd.addNode(label));
+	}
+	for (NodeId n = 0; n < (NodeId)nodeCount(d); n++){
+		for (EdgeId e = getOutEdgesBegin(d, n); e != getOutEdgesEnd(d, n); e++){
+			if (getOperation(d, e) == DecisionDiagram::Condition::else_){
+				dd.addElseEdge(ddNodes[n], ddNodes[getTo(d, e)]);
+			}else{
+				dd.addEdge(ddNodes[n], ddNodes[getTo(d, e)], DecisionDiagram::Condition(symbols.get(getOperand1(d, e)), symbols.get(getOperand2(d, e)), getOperation(d, e)));
+			}
+		}
+	}
+	if (getRoot(d) != none) dd.setRoot(ddNodes[getRoot(d)]);
+}
@@ -0,0 +1,175 @@
+#include <DecisionDiagramSinks.h>
+
+using namespace dlvhex::dd::util;
+
+
+// ------------------------------ AtomSetSink ------------------------------
+
+AtomSetSink::AtomSetSink(AtomSet& as_) : as(as_), addIndex(false), index(0){
+	initPredicates();
+}
+
+AtomSetSink::AtomSetSink(AtomSet& as_, int index_) : as(as_), addIndex(true), index(index_){
+	initPredicates();
+}
+
+void AtomSetSink::initPredicates(){
+	std::string suffix = addIndex ? std::string("In") : std::string("");
+	innerNodePredicate = std::string("innernode") + suffix;
+	leafNodePredicate = std::string("leafnode") + suffix;
+	conditionalEdgePredicate = std::string("conditionaledge") + suffix;
+	elseEdgePredicate = std::string("elseedge") + suffix;
+	rootPredicate = std::string("root") + suffix;
+}
+
+Tuple AtomSetSink::newTuple() const{
+	Tuple args;
+	if (addIndex) args.push_back(Term(index));
+	return args;
+}
+
+void AtomSetSink::innerNode(const DecisionDiagram::Node* n){
+	Tuple args = newTuple();
+	args.push_back(Term(n->getLabel()));
+	as.insert(AtomPtr(new Atom(innerNodePredicate, args)));
+}
+
+void AtomSetSink::leafNode(const DecisionDiagram::LeafNode* n){
+	Tuple args = newTuple();
+	args.push_back(Term(n->getLabel()));
+	args.push_back(Term(n->getClassification(), true));
+	as.insert(AtomPtr(new Atom(leafNodePredicate, args)));
+}
+
+void AtomSetSink::conditionalEdge(const DecisionDiagram::Edge* e){
+	const DecisionDiagram::Condition& c = e->getCondition();
+	Tuple args = newTuple();
+	args.push_back(Term(e->getFrom()->getLabel()));
+	args.push_back(Term(e->getTo()->getLabel()));
+	args.push_back(Term(c.getOperand1(), true));
+	args.push_back(Term(DecisionDiagram::Condition::cmpOpToString(c.getOperation()), true));
+	args.push_back(Term(c.getOperand2(), true));
+	as.insert(AtomPtr(new Atom(conditionalEdgePredicate, args)));
+}
+
+void AtomSetSink::elseEdge(const DecisionDiagram::Edge* e){
+	Tuple args = newTuple();
+	args.push_back(Term(e->getFrom()->getLabel()));
+	args.push_back(Term(e->getTo()->getLabel()));
+	as.insert(AtomPtr(new Atom(elseEdgePredicate, args)));
+}
+
+void AtomSetSink::rootNode(const DecisionDiagram::Node* n){
+	Tuple args = newTuple();
+	args.push_back(Term(n->getLabel()));
+	as.insert(AtomPtr(new Atom(rootPredicate, args)));
+}
+
+
+// ------------------------------ DlvFactSink ------------------------------
+
+DlvFactSink::DlvFactSink(std::ostream& out_) : out(out_){
+}
+
+void DlvFactSink::innerNode(const DecisionDiagram::Node* n){
+	out << "innernode(" << n->getLabel() << ")." << std::endl;
+}
+
+void DlvFactSink::leafNode(const DecisionDiagram::LeafNode* n){
+	out << "leafnode(" << n->getLabel() << ",\"" << n->getClassification() << "\")." << std::endl;
+}
+
+void DlvFactSink::conditionalEdge(const DecisionDiagram::Edge* e){
+	const DecisionDiagram::Condition& c = e->getCondition();
+	out << "conditionaledge(" << e->getFrom()->getLabel() << "," << e->getTo()->getLabel() << ",\"" << c.getOperand1() << "\",\"" << DecisionDiagram::Condition::cmpOpToString(c.getOperation()) << "\",\"" << c.getOperand2() << "\")." << std::endl;
+}
+
+void DlvFactSink::elseEdge(const DecisionDiagram::Edge* e){
+	out << "elseedge(" << e->getFrom()->getLabel() << "," << e->getTo()->getLabel() << ")." << std::endl;
+}
+
+void DlvFactSink::rootNode(const DecisionDiagram::Node* n){
+	out << "root(" << n->getLabel() << ")." << std::endl;
+}
+
+
+// ------------------------------ DotSink ------------------------------
+
+namespace{
+	// extract a reasonable label for a node (the part before the first underscore)
+	std::string shortLabel(const DecisionDiagram::Node* n){
+		const std::string& label = n->getLabel();
+		std::string::size_type pos = label.find_first_of("_");
+		return pos == std::string::npos ? label : label.substr(0, pos);
+	}
+}
+
+DotSink::DotSink(std::ostream& out_) : out(out_){
+}
+
+void DotSink::begin(const DecisionDiagram& dd){
+	out << "digraph {" << std::endl;
+}
+
+void DotSink::innerNode(const DecisionDiagram::Node* n){
+	out << "     " << n->getLabel() << " [label=\"" << shortLabel(n) << "\"];" << std::endl;
+}
+
+void DotSink::leafNode(const DecisionDiagram::LeafNode* n){
+	out << "     " << n->getLabel() << " [label=\"" << shortLabel(n) << " [" << n->getClassification() << "]\"];" << std::endl;
+}
+
+void DotSink::conditionalEdge(const DecisionDiagram::Edge* e){
+	out << "     " << e->getFrom()->getLabel() << " -> " << e->getTo()->getLabel() << " [label=\"" << e->getCondition().toString() << "\"]" << ";" << std::endl;
+}
+
+void DotSink::elseEdge(const DecisionDiagram::Edge* e){
+	out << "     " << e->getFrom()->getLabel() << " -> " << e->getTo()->getLabel() << " [label=\"else\"];" << std::endl;
+}
+
+void DotSink::rootNode(const DecisionDiagram::Node* n){
+	// dot has no notion of a root (the root is the node without ingoing edges)
+}
+
+void DotSink::end(){
+	out << "}" << std::endl;
+}
+
+
+// ------------------------------ TextSink ------------------------------
+
+TextSink::TextSink(std::ostream& out_) : out(out_), first(true){
+}
+
+void TextSink::begin(const DecisionDiagram& dd){
+	edgeList.str("");
+	first = true;
+	out << "Nodes: ";
+}
+
+void TextSink::innerNode(const DecisionDiagram::Node* n){
+	out << (first ? "" : ", ") << n->toString();
+	first = false;
+}
+
+void TextSink::leafNode(const DecisionDiagram::LeafNode* n){
+	out << (first ? "" : ", ") << n->toString();
+	first = false;
+}
+
+void TextSink::conditionalEdge(const DecisionDiagram::Edge* e){
+	edgeList << "     " << e->toString() << std::endl;
+}
+
+void TextSink::elseEdge(const DecisionDiagram::Edge* e){
+	edgeList << "     " << e->toString() << std::endl;
+}
+
+void TextSink::rootNode(const DecisionDiagram::Node* n){
+}
+
+void TextSink::end(){
+	out << std::endl;
+	out << "Edges: " << std::endl;
+	out << edgeList.str();
+}
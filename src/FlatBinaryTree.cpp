@@ -0,0 +1,289 @@
+#include <FlatBinaryTree.h>
+
+#include <boost/unordered_map.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <math.h>
+#include <set>
+#include <sstream>
+
+// The AVX2 kernel is compiled with function-specific target options, such that the rest of the plugin does not require AVX2
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define DD_FLATBINARYTREE_AVX2
+#include <immintrin.h>
+#endif
+
+using namespace dlvhex::dd::util;
+
+namespace{
+	// Raw view on the arrays of a flattened tree (passed to the kernels)
+	struct Layout{
+		const boost::int32_t* attributes;
+		const double* lower;
+		const double* upper;
+		const boost::int32_t* children;
+		const SymbolTable::Id* classifications;
+		int depth;
+		int stride;
+	};
+
+	// Translates a normalized condition "value op threshold" into the closed interval of satisfying values
+	void toInterval(DecisionDiagram::Condition::CmpOp op, double threshold, double& lower, double& upper){
+		const double inf = std::numeric_limits<double>::infinity();
+		lower = -inf;
+		upper = inf;
+		switch (op){
+			case DecisionDiagram::Condition::lt: upper = nextafter(threshold, -inf); break;
+			case DecisionDiagram::Condition::le: upper = threshold; break;
+			case DecisionDiagram::Condition::eq: lower = threshold; upper = threshold; break;
+			case DecisionDiagram::Condition::ge: lower = threshold; break;
+			case DecisionDiagram::Condition::gt: lower = nextafter(threshold, inf); break;
+			default: break;
+		}
+		// there is no number below -inf or above inf
+		if ((op == DecisionDiagram::Condition::lt && threshold == -inf) || (op == DecisionDiagram::Condition::gt && threshold == inf)){
+			lower = inf;
+			upper = -inf;
+		}
+	}
+
+	void classifyScalar(const Layout& t, const double* rows, int rowCount, SymbolTable::Id* result){
+		for (int r = 0; r < rowCount; r++){
+			const double* row = rows + (std::size_t)r * t.stride;
+			boost::int32_t n = 0;
+			// leaf nodes point to themselves
+			while (t.children[2 * n] != n){
+				double v = row[t.attributes[n]];
+				n = t.children[2 * n + (v >= t.lower[n] && v <= t.upper[n] ? 0 : 1)];
+			}
+			result[r] = t.classifications[n];
+		}
+	}
+
+#ifdef DD_FLATBINARYTREE_AVX2
+	// Moves two groups of 4 rows down the tree in lockstep and returns the number of rows which were classified (a multiple of 8)
+	__attribute__((target("avx2"))) int classifyAvx2(const Layout& t, const double* rows, int rowCount, SymbolTable::Id* result){
+		const __m128i rowOffsets = _mm_setr_epi32(0, t.stride, 2 * t.stride, 3 * t.stride);
+		const __m128i one = _mm_set1_epi32(1);
+		// selects the lower halves of 64-bit masks
+		const __m256i packMask = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+		const int* attributes = reinterpret_cast<const int*>(t.attributes);
+		const int* children = reinterpret_cast<const int*>(t.children);
+		boost::int32_t leaves[8];
+
+		int r = 0;
+		for (; r + 8 <= rowCount; r += 8){
+			const double* block1 = rows + (std::size_t)r * t.stride;
+			const double* block2 = block1 + 4 * t.stride;
+			__m128i n1 = _mm_setzero_si128();
+			__m128i n2 = _mm_setzero_si128();
+			for (int d = 0; d < t.depth; d++){
+				__m256d v1 = _mm256_i32gather_pd(block1, _mm_add_epi32(rowOffsets, _mm_i32gather_epi32(attributes, n1, 4)), 8);
+				__m256d v2 = _mm256_i32gather_pd(block2, _mm_add_epi32(rowOffsets, _mm_i32gather_epi32(attributes, n2, 4)), 8);
+				__m256d c1 = _mm256_and_pd(_mm256_cmp_pd(v1, _mm256_i32gather_pd(t.lower, n1, 8), _CMP_GE_OQ), _mm256_cmp_pd(v1, _mm256_i32gather_pd(t.upper, n1, 8), _CMP_LE_OQ));
+				__m256d c2 = _mm256_and_pd(_mm256_cmp_pd(v2, _mm256_i32gather_pd(t.lower, n2, 8), _CMP_GE_OQ), _mm256_cmp_pd(v2, _mm256_i32gather_pd(t.upper, n2, 8), _CMP_LE_OQ));
+				__m128i m1 = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(_mm256_castpd_si256(c1), packMask));
+				__m128i m2 = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(_mm256_castpd_si256(c2), packMask));
+				// the mask is -1 for satisfied conditions, thus 2 * n + 1 + mask selects the child
+				n1 = _mm_i32gather_epi32(children, _mm_add_epi32(_mm_add_epi32(n1, n1), _mm_add_epi32(one, m1)), 4);
+				n2 = _mm_i32gather_epi32(children, _mm_add_epi32(_mm_add_epi32(n2, n2), _mm_add_epi32(one, m2)), 4);
+			}
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(leaves), n1);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(leaves + 4), n2);
+			for (int i = 0; i < 8; i++){
+				result[r + i] = t.classifications[leaves[i]];
+			}
+		}
+		return r;
+	}
+#endif
+}
+
+FlatBinaryTree::FlatBinaryTree(const DecisionDiagram& dd) : depth(0){
+	if (dd.getRoot() == NULL) throw DecisionDiagram::InvalidDecisionDiagram("Tried to flatten a binary decision diagram. Error: The diagram has no root.");
+
+	// Compute the height of all nodes bottom-up (throws if the diagram contains cycles)
+	const std::vector<DecisionDiagram::Node*>& topologicalOrder = dd.getTopologicalOrder();
+	std::vector<int> height(topologicalOrder.size(), 0);
+	for (std::vector<DecisionDiagram::Node*>::const_reverse_iterator it = topologicalOrder.rbegin(); it != topologicalOrder.rend(); it++){
+		int& h = height[dd.getNodeIndex(*it)];
+		DecisionDiagram::EdgeList outEdges = (*it)->getOutEdgeRange();
+		for (DecisionDiagram::EdgeList::iterator e = outEdges.begin(); e != outEdges.end(); e++){
+			h = std::max(h, height[dd.getNodeIndex((*e)->getTo())] + 1);
+		}
+	}
+	depth = height[dd.getNodeIndex(dd.getRoot())];
+
+	// Number the reachable nodes level-wise and check that they are binary
+	std::vector<const DecisionDiagram::Node*> order;
+	std::vector<int> position(topologicalOrder.size(), -1);
+	std::vector<const DecisionDiagram::Edge*> conditionalEdges, elseEdges;
+	std::set<std::string> attributeNames;
+	order.push_back(dd.getRoot());
+	position[dd.getNodeIndex(dd.getRoot())] = 0;
+	for (unsigned int i = 0; i < order.size(); i++){
+		const DecisionDiagram::Node* n = order[i];
+		const DecisionDiagram::Edge* conditionalEdge = NULL;
+		const DecisionDiagram::Edge* elseEdge = NULL;
+		if (!n->isLeaf()){
+			DecisionDiagram::EdgeList outEdges = n->getOutEdgeRange();
+			for (DecisionDiagram::EdgeList::iterator it = outEdges.begin(); it != outEdges.end(); it++){
+				if ((*it)->isElse()) elseEdge = *it;
+				else conditionalEdge = *it;
+			}
+			if (outEdges.size() != 2 || conditionalEdge == NULL || elseEdge == NULL || !conditionalEdge->getCondition().hasAttribute() || !conditionalEdge->getCondition().hasCmpValue()){
+				std::stringstream msg;
+				msg << "Tried to flatten a binary decision diagram. Error: Node \"" << n->getLabel() << "\" does not have exactly one outgoing edge with a numeric condition and one else edge.";
+				throw DecisionDiagram::InvalidDecisionDiagram(msg.str());
+			}
+			attributeNames.insert(conditionalEdge->getCondition().getAttribute());
+
+			// Enqueue the children (the child of the condition first)
+			const DecisionDiagram::Node* c[] = { conditionalEdge->getTo(), elseEdge->getTo() };
+			for (int j = 0; j < 2; j++){
+				int& p = position[dd.getNodeIndex(c[j])];
+				if (p == -1){
+					p = order.size();
+					order.push_back(c[j]);
+				}
+			}
+		}
+		conditionalEdges.push_back(conditionalEdge);
+		elseEdges.push_back(elseEdge);
+	}
+
+	// The attributes are numbered lexically
+	boost::unordered_map<SymbolTable::Id, boost::int32_t> attributeIndex;
+	for (std::set<std::string>::iterator it = attributeNames.begin(); it != attributeNames.end(); it++){
+		SymbolTable::Id a = SymbolTable::intern(*it);
+		attributeIndex[a] = attributes.size();
+		attributes.push_back(a);
+	}
+
+	// Fill the arrays
+	nodeAttributes.resize(order.size(), 0);
+	lower.resize(order.size(), 0.0);
+	upper.resize(order.size(), 0.0);
+	children.resize(2 * order.size());
+	classifications.resize(order.size(), SymbolTable::empty);
+	for (unsigned int i = 0; i < order.size(); i++){
+		if (order[i]->isLeaf()){
+			classifications[i] = order[i]->asLeaf()->getClassificationSymbol();
+			children[2 * i] = i;
+			children[2 * i + 1] = i;
+		}else{
+			const DecisionDiagram::Condition& c = conditionalEdges[i]->getCondition();
+			nodeAttributes[i] = attributeIndex[c.getAttributeSymbol()];
+			toInterval(c.getNormalizedOperation(), c.getCmpValue(), lower[i], upper[i]);
+			children[2 * i] = position[dd.getNodeIndex(conditionalEdges[i]->getTo())];
+			children[2 * i + 1] = position[dd.getNodeIndex(elseEdges[i]->getTo())];
+		}
+	}
+}
+
+int FlatBinaryTree::nodeCount() const{
+	return classifications.size();
+}
+
+int FlatBinaryTree::getDepth() const{
+	return depth;
+}
+
+int FlatBinaryTree::getAttributeCount() const{
+	return attributes.size();
+}
+
+const std::string& FlatBinaryTree::getAttribute(int index) const{
+	return SymbolTable::lookup(attributes[index]);
+}
+
+int FlatBinaryTree::getAttributeIndex(const std::string& attribute) const{
+	SymbolTable::Id a;
+	if (SymbolTable::find(attribute, a)){
+		std::vector<SymbolTable::Id>::const_iterator it = std::find(attributes.begin(), attributes.end(), a);
+		if (it != attributes.end()) return it - attributes.begin();
+	}
+	return -1;
+}
+
+bool FlatBinaryTree::isSupported(Kernel kernel){
+	switch (kernel){
+		case scalar:
+			return true;
+		case avx2:
+#ifdef DD_FLATBINARYTREE_AVX2
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("avx2");
+#else
+			return false;
+#endif
+		default:
+			return false;
+	}
+}
+
+FlatBinaryTree::Kernel FlatBinaryTree::getDefaultKernel(){
+	static const Kernel defaultKernel = isSupported(avx2) ? avx2 : scalar;
+	return defaultKernel;
+}
+
+void FlatBinaryTree::classify(const double* rows, int rowCount, SymbolTable::Id* result) const{
+	classify(rows, rowCount, result, getDefaultKernel());
+}
+
+void FlatBinaryTree::classify(const double* rows, int rowCount, SymbolTable::Id* result, Kernel kernel) const{
+	if (!isSupported(kernel)) throw DecisionDiagram::InvalidDecisionDiagram("Tried to classify data rows. Error: The requested kernel is not supported on this machine.");
+
+	Layout t;
+	t.attributes = &nodeAttributes[0];
+	t.lower = &lower[0];
+	t.upper = &upper[0];
+	t.children = &children[0];
+	t.classifications = &classifications[0];
+	t.depth = depth;
+	t.stride = attributes.size();
+
+	int done = 0;
+#ifdef DD_FLATBINARYTREE_AVX2
+	if (kernel == avx2) done = classifyAvx2(t, rows, rowCount, result);
+#endif
+	// remaining rows
+	classifyScalar(t, rows + (std::size_t)done * t.stride, rowCount - done, result + done);
+}
+
+void FlatBinaryTree::classify(const BatchClassifier::Batch& batch, std::vector<SymbolTable::Id>& result) const{
+	result.resize(batch.getRowCount());
+	if (batch.getRowCount() == 0) return;
+
+	// Look up the columns
+	std::vector<const std::vector<double>*> numericColumns(attributes.size());
+	std::vector<const std::vector<BatchClassifier::Batch::ValueId>*> symbolicColumns(attributes.size());
+	for (unsigned int j = 0; j < attributes.size(); j++){
+		numericColumns[j] = batch.getNumericColumn(attributes[j]);
+		symbolicColumns[j] = batch.getSymbolicColumn(attributes[j]);
+		if (numericColumns[j] == NULL && symbolicColumns[j] == NULL) throw BatchClassifier::InvalidBatch(std::string("The batch does not contain a column for attribute \"") + SymbolTable::lookup(attributes[j]) + std::string("\"."));
+	}
+
+	// Transpose and classify block-wise (such that the block stays in the cache)
+	const int blockSize = 1024;
+	const int stride = attributes.size();
+	const double nan = std::numeric_limits<double>::quiet_NaN();
+	std::vector<double> block((std::size_t)blockSize * stride + 1);
+	for (int begin = 0; begin < batch.getRowCount(); begin += blockSize){
+		int rowCount = std::min(blockSize, batch.getRowCount() - begin);
+		for (int j = 0; j < stride; j++){
+			if (numericColumns[j] != NULL){
+				const double* column = &(*numericColumns[j])[begin];
+				for (int i = 0; i < rowCount; i++) block[i * stride + j] = column[i];
+			}else{
+				const BatchClassifier::Batch::ValueId* column = &(*symbolicColumns[j])[begin];
+				for (int i = 0; i < rowCount; i++){
+					const BatchClassifier::Batch::Value& v = batch.getValue(column[i]);
+					block[i * stride + j] = v.numeric ? v.number : nan;
+				}
+			}
+		}
+		classify(&block[0], rowCount, &result[begin]);
+	}
+}
@@ -0,0 +1,131 @@
+#include <DecisionDiagram.h>
+#include <BatchClassifier.h>
+#include <FlatBinaryTree.h>
+
+#include <stdlib.h>
+#include <time.h>
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace dlvhex::dd::util;
+using namespace std;
+
+// Benchmark for the FlatBinaryTree kernels.
+// Builds a random binary decision diagram of a given depth over the 20 features computed by DNAFeatureExtractor (f1 to f20) and classifies random feature rows with each kernel.
+// In order to keep deep diagrams small, each level has at most 4096 nodes (subdiagrams are shared); every path has the same length, thus each row takes exactly depth steps.
+
+const int featureCount = 20;
+const int maxLevelWidth = 4096;
+
+string feature(int i){
+	stringstream ss;
+	ss << "f" << (i + 1);
+	return ss.str();
+}
+
+double random01(){
+	return rand() / (RAND_MAX + 1.0);
+}
+
+void buildDiagram(DecisionDiagram& dd, int depth){
+	const char* ops[] = { "<", "<=", ">", ">=" };
+	vector<DecisionDiagram::Node*> level, nextLevel;
+
+	// Leaf nodes
+	for (int i = 0; i < min(1 << min(depth, 30), maxLevelWidth); i++){
+		stringstream label, classification;
+		label << "leaf_" << i;
+		classification << "c" << (i % 4);
+		level.push_back(dd.addLeafNode(label.str(), classification.str()));
+	}
+
+	// Inner nodes, bottom-up
+	for (int l = depth - 1; l >= 0; l--){
+		nextLevel.clear();
+		for (int i = 0; i < min(1 << min(l, 30), maxLevelWidth); i++){
+			stringstream label, threshold;
+			label << "n" << l << "_" << i;
+			threshold << random01();
+			DecisionDiagram::Node* n = dd.addNode(label.str());
+			dd.addEdge(n, level[rand() % level.size()], DecisionDiagram::Condition(feature(rand() % featureCount), threshold.str(), ops[rand() % 4]));
+			dd.addElseEdge(n, level[rand() % level.size()]);
+			nextLevel.push_back(n);
+		}
+		level.swap(nextLevel);
+	}
+	dd.setRoot(level[0]);
+}
+
+double seconds(clock_t start){
+	return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+int main(int argc, char* argv[]){
+	int depth = argc > 1 ? atoi(argv[1]) : 16;
+	int rowCount = argc > 2 ? atoi(argv[2]) : 1000000;
+	if (depth < 0 || rowCount <= 0){
+		cerr << "Usage: " << argv[0] << " [depth [rows]]" << endl;
+		return 1;
+	}
+
+	srand(42);
+	DecisionDiagram dd;
+	buildDiagram(dd, depth);
+	FlatBinaryTree tree(dd);
+	cout << "Diagram: " << tree.nodeCount() << " nodes, depth " << tree.getDepth() << ", " << tree.getAttributeCount() << " attributes" << endl;
+
+	// Random feature rows (row-major in the attribute order of the tree)
+	int stride = tree.getAttributeCount();
+	vector<double> rows((size_t)rowCount * stride + 1);
+	for (size_t i = 0; i + 1 < rows.size(); i++) rows[i] = random01();
+
+	// Run each kernel repeatedly for at least one second
+	FlatBinaryTree::Kernel kernels[] = { FlatBinaryTree::scalar, FlatBinaryTree::avx2 };
+	const char* kernelNames[] = { "scalar", "avx2" };
+	vector<SymbolTable::Id> reference;
+	bool mismatch = false;
+	for (int k = 0; k < 2; k++){
+		if (!FlatBinaryTree::isSupported(kernels[k])){
+			cout << kernelNames[k] << ": not supported on this machine" << endl;
+			continue;
+		}
+		vector<SymbolTable::Id> result(rowCount);
+		tree.classify(&rows[0], rowCount, &result[0], kernels[k]);
+		int passes = 0;
+		clock_t start = clock();
+		do{
+			tree.classify(&rows[0], rowCount, &result[0], kernels[k]);
+			passes++;
+		}while (seconds(start) < 1.0);
+		double t = seconds(start) / passes;
+		cout << kernelNames[k] << ": " << (t * 1000) << " ms per pass, " << (rowCount / t / 1e6) << "M rows/s, " << ((double)rowCount * tree.getDepth() / t / 1e6) << "M row-node steps/s" << endl;
+
+		if (reference.empty()) reference = result;
+		else if (result != reference){
+			cout << kernelNames[k] << ": results differ from " << kernelNames[0] << endl;
+			mismatch = true;
+		}
+	}
+
+	// Cross-check with the generic classifier
+	int checkCount = min(rowCount, 100000);
+	BatchClassifier::Batch batch(checkCount);
+	for (int j = 0; j < stride; j++){
+		vector<double> column(checkCount);
+		for (int i = 0; i < checkCount; i++) column[i] = rows[(size_t)i * stride + j];
+		batch.addColumn(tree.getAttribute(j), column);
+	}
+	vector<SymbolTable::Id> expected, result;
+	BatchClassifier(dd).classify(batch, expected);
+	tree.classify(batch, result);
+	if (result != expected || !equal(expected.begin(), expected.end(), reference.begin())){
+		cout << "Results differ from BatchClassifier" << endl;
+		mismatch = true;
+	}
+
+	return mismatch ? 1 : 0;
+}
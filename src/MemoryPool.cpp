@@ -0,0 +1,83 @@
+#include <MemoryPool.h>
+
+#include <algorithm>
+#include <new>
+
+using namespace dlvhex::dd::util;
+
+namespace{
+	// slots are aligned such that any of the stored object types (pointers, doubles) can be placed into them
+	const std::size_t alignment = 2 * sizeof(void*) > sizeof(double) ? 2 * sizeof(void*) : sizeof(double);
+
+	// the first chunk is small (many diagrams are tiny), subsequent chunks grow geometrically up to a maximum
+	const std::size_t initialChunkSlots = 32;
+	const std::size_t maximumChunkSlots = 4096;
+}
+
+MemoryPool::MemoryPool(std::size_t objectSize) : chunkSlots(initialChunkSlots), next(NULL), end(NULL), freeList(NULL), liveCount(0){
+	// each slot must be able to hold the free list link
+	if (objectSize < sizeof(void*)) objectSize = sizeof(void*);
+	slotSize = (objectSize + alignment - 1) / alignment * alignment;
+}
+
+MemoryPool::~MemoryPool(){
+	releaseAll();
+}
+
+void MemoryPool::allocateChunk(){
+	char* chunk = static_cast<char*>(::operator new(slotSize * chunkSlots));
+	chunks.push_back(chunk);
+	next = chunk;
+	end = chunk + slotSize * chunkSlots;
+	if (chunkSlots < maximumChunkSlots) chunkSlots *= 2;
+}
+
+void* MemoryPool::allocate(){
+	// reuse freed slots first
+	if (freeList != NULL){
+		void* p = freeList;
+		freeList = *static_cast<void**>(freeList);
+		liveCount++;
+		return p;
+	}
+
+	// take the next slot of the current chunk (allocateChunk may throw std::bad_alloc, thus the slot is counted afterwards)
+	if (next == end) allocateChunk();
+	void* p = next;
+	next += slotSize;
+	liveCount++;
+	return p;
+}
+
+void MemoryPool::deallocate(void* p){
+	if (p == NULL) return;
+	*static_cast<void**>(p) = freeList;
+	freeList = p;
+	liveCount--;
+}
+
+void MemoryPool::releaseAll(){
+	for (std::vector<char*>::iterator it = chunks.begin(); it != chunks.end(); it++){
+		::operator delete(*it);
+	}
+	chunks.clear();
+	chunkSlots = initialChunkSlots;
+	next = NULL;
+	end = NULL;
+	freeList = NULL;
+	liveCount = 0;
+}
+
+void MemoryPool::swap(MemoryPool& pool2){
+	std::swap(slotSize, pool2.slotSize);
+	std::swap(chunkSlots, pool2.chunkSlots);
+	chunks.swap(pool2.chunks);
+	std::swap(next, pool2.next);
+	std::swap(end, pool2.end);
+	std::swap(freeList, pool2.freeList);
+	std::swap(liveCount, pool2.liveCount);
+}
+
+std::size_t MemoryPool::size() const{
+	return liveCount;
+}
@@ -1,4 +1,5 @@
 #include <OpASP.h>
+#include <SymbolTable.h>
 
 #include <dlvhex/AggregateAtom.h>
 #include <dlvhex/DLVProcess.h>
@@ -123,6 +124,7 @@ void OpASP::parseParameters(OperatorArguments& parameters, int& maxint, dlvhex::
 }
 
 HexAnswer OpASP::apply(bool debug, int arity, std::vector<HexAnswer*>& arguments, OperatorArguments& parameters) throw (OperatorException){
+	SymbolTable::Scope symbols;
 
 	// create a subprogram that computes the user defined ASP code
 	dlvhex::Program program;
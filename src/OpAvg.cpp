@@ -1,7 +1,10 @@
 #include <OpAvg.h>
 #include <DecisionDiagram.h>
+#include <SymbolTable.h>
+#include <CompactDecisionDiagram.h>
 #include <StringHelper.h>
 
+#include <algorithm>
 #include <sstream>
 #include <set>
 
@@ -33,178 +36,185 @@ std::set<std::string> OpAvg::getRecognizedParameters(){
 
 // retrieves the condition tested in a node; in strict sense, conditions are assigned to edges and not to nodes. but if we have only one conditional edge that origins in a certain node,
 // we can also consider the condition to be assigned to that node
-DecisionDiagram::Condition OpAvg::getCondition(DecisionDiagram::Node* node){
+CompactDecisionDiagram::EdgeId OpAvg::getConditionalEdge(const CompactDecisionDiagram& dd, CompactDecisionDiagram::NodeId node){
 	// Search for the requested condition in the outgoing edges of this node
-	DecisionDiagram::Condition c("", "", DecisionDiagram::Condition::else_);
-	bool cFound = false;
-	std::set<DecisionDiagram::Edge*> oedges = node->getOutEdges();
-	for (std::set<DecisionDiagram::Edge*>::iterator it = oedges.begin(); it != oedges.end(); it++){
-		DecisionDiagram::Condition condition = (*it)->getCondition();
-		if (condition.getOperation() != DecisionDiagram::Condition::else_){
-			if (cFound){
+	CompactDecisionDiagram::EdgeId c = CompactDecisionDiagram::none;
+	for (CompactDecisionDiagram::EdgeId e = dd.getOutEdgesBegin(node); e != dd.getOutEdgesEnd(node); e++){
+		if (dd.getOperation(e) != DecisionDiagram::Condition::else_){
+			if (c != CompactDecisionDiagram::none){
 				std::stringstream msg;
-				msg << "Node \"" << node->getLabel() << "\" has more than one outgoing conditional edge, but average expects the input diagrams to be binary with exactly one else edge";
+				msg << "Node \"" << dd.getLabel(node) << "\" has more than one outgoing conditional edge, but average expects the input diagrams to be binary with exactly one else edge";
 				throw IOperator::OperatorException(msg.str());
 			}
-			c = condition;
-			cFound = true;
+			c = e;
 		}
 	}
-	if (!cFound){
+	if (c == CompactDecisionDiagram::none){
 		std::stringstream msg;
-		msg << "Node \"" << node->getLabel() << "\" has no outgoing conditional edge";
+		msg << "Node \"" << dd.getLabel(node) << "\" has no outgoing conditional edge";
 		throw IOperator::OperatorException(msg.str());
 	}
 	return c;
 }
 
 // merges two leaf nodes
-DecisionDiagram::Node* OpAvg::averageLeafs(DecisionDiagram& result, DecisionDiagram* dd1, DecisionDiagram::LeafNode* leaf1, DecisionDiagram* dd2, DecisionDiagram::LeafNode* leaf2){
+DecisionDiagram::Node* OpAvg::averageLeafs(DecisionDiagram& result, const CompactDecisionDiagram& dd1, CompactDecisionDiagram::NodeId leaf1, const CompactDecisionDiagram& dd2, CompactDecisionDiagram::NodeId leaf2){
 	// Check if they coincide
-	if (leaf1->getClassification() == leaf2->getClassification()){
+	if (dd1.getClassificationSymbol(leaf1) == dd2.getClassificationSymbol(leaf2)){
 		// Yes: Add the same classification to the final result
-		return result.addLeafNode(result.getUniqueLabel(leaf1->getLabel()), leaf1->getClassification());
+		return result.addFreshLeafNode(dd1.getLabel(leaf1), dd1.getClassification(leaf1));
 	}else{
 		// No: Classifications are contradictory
-		return result.addLeafNode(result.getUniqueLabel(leaf1->getLabel()), std::string("unknown"));
+		return result.addFreshLeafNode(dd1.getLabel(leaf1), std::string("unknown"));
 	}
 }
 
-// merges two inner nodes
-DecisionDiagram::Node* OpAvg::averageInner(DecisionDiagram& result, DecisionDiagram* dd1, DecisionDiagram::Node* inner1, DecisionDiagram* dd2, DecisionDiagram::Node* inner2){
-	// No: Both are inner nodes
-
-	DecisionDiagram::Condition c1 = getCondition(inner1);
-	DecisionDiagram::Condition c2 = getCondition(inner2);
-
-	// Check if n1 and n2 both query the same variable
-	if (c1.getOperand1() == c2.getOperand1()){
-		// Average
-
-		// Both nodes request the same variable
-
-		// Merge the sub-trees. The else-sides and the conditional edges are merged accordingly.
-		std::set<DecisionDiagram::Edge*> n1edges = inner1->getOutEdges();
-		std::set<DecisionDiagram::Edge*> n2edges = inner2->getOutEdges();
-		DecisionDiagram::Node* else_subtree_1;
-		DecisionDiagram::Node* conditional_subtree_1;
-		DecisionDiagram::Node* else_subtree_2;
-		DecisionDiagram::Node* conditional_subtree_2;
-		for (std::set<DecisionDiagram::Edge*>::iterator it = n1edges.begin(); it != n1edges.end(); it++)
-			if ((*it)->getCondition().getOperation() == DecisionDiagram::Condition::else_)	else_subtree_1 = (*it)->getTo();
-			else										conditional_subtree_1 = (*it)->getTo();
-		for (std::set<DecisionDiagram::Edge*>::iterator it = n2edges.begin(); it != n2edges.end(); it++)
-			if ((*it)->getCondition().getOperation() == DecisionDiagram::Condition::else_)	else_subtree_2 = (*it)->getTo();
-			else										conditional_subtree_2 = (*it)->getTo();
-
-		// merge the conditional and the else subtree independently
-		DecisionDiagram::Node* else_subtree = average(result, dd1, else_subtree_1, dd2, else_subtree_2);
-		DecisionDiagram::Node* conditional_subtree = average(result, dd1, conditional_subtree_1, dd2, conditional_subtree_2);
-
-		// Now the conditions must be merged
-		double o1 = StringHelper::atof(StringHelper::unquote(c1.getOperand2()).c_str());
-		double o2 = StringHelper::atof(StringHelper::unquote(c2.getOperand2()).c_str());
-		double o3 = (o1 + o2) / 2;
-		DecisionDiagram::Condition merged_condition = DecisionDiagram::Condition(c1.getOperand1(), StringHelper::toString(o3), c1.getOperation());
-
-		// If both second operands are numbers and the condition operators are equal, we just take the average
-		DecisionDiagram::Node* root = result.addNode(result.getUniqueLabel(inner1->getLabel()));
+namespace{
+	// a pair of nodes which are merged by average; the fields root and swapped are filled when the pair is entered
+	struct Task{
+		Task(const CompactDecisionDiagram* dd1_, CompactDecisionDiagram::NodeId n1_, const CompactDecisionDiagram* dd2_, CompactDecisionDiagram::NodeId n2_) : dd1(dd1_), n1(n1_), dd2(dd2_), n2(n2_), root(NULL){
+		}
 
-		// Finally, connect the root with it's subtrees
-		result.addEdge(root, conditional_subtree, merged_condition);
-		result.addElseEdge(root, else_subtree);
+		const CompactDecisionDiagram* dd1;
+		CompactDecisionDiagram::NodeId n1;
+		const CompactDecisionDiagram* dd2;
+		CompactDecisionDiagram::NodeId n2;
+		DecisionDiagram::Node* root;		// if the children of n1 are merged with n2 (rather than pairwise with the children of n2): the copy of n1, which was inserted before the children
+	};
+}
 
-		return root;
-	}else{
-		// No: Since the input decision diagrams (trees) can savely assumed to be ordered,
-		// we know for sure that the lexically smaller one of the compared attributes does not occur in the other decision diagram
-		// Just merge each child of the decision node with the lexically smaller attribute with the other decision diagram. The larger one may occurs somewhere below.
-
-		// Example:
-		//
-		//    [A]               [B]
-		//   /   \             /   \
-		// ...   ...         ...   ...
-		//  I     II
-		//
-		// We know, that A is never requested in the right decision diagram. Since B is already requested, and the diagram is ordered, there is no chance to request A below.
-		// So we savely merge the right decision diagram with the children of the left diagram (I and II), since B can occur there.
-
-		DecisionDiagram* smallerDD;
-		DecisionDiagram* largerDD;
-		DecisionDiagram::Node* smallerN;
-		DecisionDiagram::Node* largerN;
-		if (c1.getOperand1().compare(c2.getOperand1()) < 0){	// c1 is lexically smaller than c2
-			smallerDD = dd1;
-			smallerN = inner1;
-			largerDD = dd2;
-			largerN = inner2;
-		}else{							// c2 is lexically smaller than c1
-			smallerDD = dd2;
-			smallerN = inner2;
-			largerDD = dd1;
-			largerN = inner1;
-		}
+// merges the diagrams top-down; the children of a pair of nodes are merged before the edges to them are inserted
+class OpAvg::Averaging : public DecisionDiagram::Traversal<Task, DecisionDiagram::Node*>{
+private:
+	OpAvg& op;
+	DecisionDiagram& result;
+public:
+	Averaging(OpAvg& op_, DecisionDiagram& result_) : op(op_), result(result_){
+	}
 
-		// Insert the smaller node into the final result
-		DecisionDiagram::Node* root = result.addNode(result.getUniqueLabel(smallerN->getLabel()));
+	virtual void enter(Task& t, std::vector<Task>& children){
+
+		// Check if one or both of the currently processed nodes is a leaf
+		if (t.dd1->isLeaf(t.n1) && t.dd2->isLeaf(t.n2)){
+			// Yes: Both are leafs (see leave)
+			return;
+		}else if (t.dd1->isLeaf(t.n1) || t.dd2->isLeaf(t.n2)){
+			// Yes: One is leaf, one is non-leaf
+			// Let n1 be the non-leaf
+			if (t.dd1->isLeaf(t.n1)){
+				std::swap(t.dd1, t.dd2);
+				std::swap(t.n1, t.n2);
+			}
 
-		// Merge the larger one with all children of the smaller node
-		std::set<DecisionDiagram::Edge*> smaller_oedges = smallerN->getOutEdges();
-		for (std::set<DecisionDiagram::Edge*>::iterator it = smaller_oedges.begin(); it != smaller_oedges.end(); it++){
-			DecisionDiagram::Node* subdiagramRoot = average(result, smallerDD, (*it)->getTo(), largerDD, largerN);
+			// Insert the non-leaf node into the final result
+			t.root = result.addFreshNode(t.dd1->getLabel(t.n1));
 
-			// Connect the currently inserted node with the sub-diagram
-			result.addEdge(root, subdiagramRoot, (*it)->getCondition());
+			// Further pass the request to all children of the non-leaf
+			for (CompactDecisionDiagram::EdgeId e = t.dd1->getOutEdgesBegin(t.n1); e != t.dd1->getOutEdgesEnd(t.n1); e++){
+				children.push_back(Task(t.dd1, t.dd1->getTo(e), t.dd2, t.n2));
+			}
+			return;
 		}
 
-		return root;
-	}
-}
-
-// merges an inner with a leaf node
-DecisionDiagram::Node* OpAvg::averageInnerLeaf(DecisionDiagram& result, DecisionDiagram* innerdiag, DecisionDiagram::Node* inner, DecisionDiagram* leafdiag, DecisionDiagram::LeafNode* leaf){
-	// Insert the non-leaf node into the final result
-	DecisionDiagram::Node* root = result.addNode(result.getUniqueLabel(inner->getLabel()));
+		// No: Both are inner nodes
+		DecisionDiagram::Condition c1 = t.dd1->getCondition(op.getConditionalEdge(*t.dd1, t.n1));
+		DecisionDiagram::Condition c2 = t.dd2->getCondition(op.getConditionalEdge(*t.dd2, t.n2));
+
+		// Check if n1 and n2 both query the same variable
+		if (c1.getAttributeSymbol() == c2.getAttributeSymbol()){
+			// Average
+
+			// Both nodes request the same variable
+
+			// Merge the sub-trees. The else-sides and the conditional edges are merged accordingly.
+			CompactDecisionDiagram::NodeId else_subtree_1;
+			CompactDecisionDiagram::NodeId conditional_subtree_1;
+			CompactDecisionDiagram::NodeId else_subtree_2;
+			CompactDecisionDiagram::NodeId conditional_subtree_2;
+			for (CompactDecisionDiagram::EdgeId e = t.dd1->getOutEdgesBegin(t.n1); e != t.dd1->getOutEdgesEnd(t.n1); e++)
+				if (t.dd1->getOperation(e) == DecisionDiagram::Condition::else_)	else_subtree_1 = t.dd1->getTo(e);
+				else									conditional_subtree_1 = t.dd1->getTo(e);
+			for (CompactDecisionDiagram::EdgeId e = t.dd2->getOutEdgesBegin(t.n2); e != t.dd2->getOutEdgesEnd(t.n2); e++)
+				if (t.dd2->getOperation(e) == DecisionDiagram::Condition::else_)	else_subtree_2 = t.dd2->getTo(e);
+				else									conditional_subtree_2 = t.dd2->getTo(e);
+
+			// merge the conditional and the else subtree independently (the conditions are merged in leave)
+			children.push_back(Task(t.dd1, else_subtree_1, t.dd2, else_subtree_2));
+			children.push_back(Task(t.dd1, conditional_subtree_1, t.dd2, conditional_subtree_2));
+		}else{
+			// No: Since the input decision diagrams (trees) can savely assumed to be ordered,
+			// we know for sure that the lexically smaller one of the compared attributes does not occur in the other decision diagram
+			// Just merge each child of the decision node with the lexically smaller attribute with the other decision diagram. The larger one may occurs somewhere below.
+
+			// Example:
+			//
+			//    [A]               [B]
+			//   /   \             /   \
+			// ...   ...         ...   ...
+			//  I     II
+			//
+			// We know, that A is never requested in the right decision diagram. Since B is already requested, and the diagram is ordered, there is no chance to request A below.
+			// So we savely merge the right decision diagram with the children of the left diagram (I and II), since B can occur there.
+
+			// Let n1 be the node with the lexically smaller attribute
+			if (c1.getAttribute().compare(c2.getAttribute()) > 0){
+				std::swap(t.dd1, t.dd2);
+				std::swap(t.n1, t.n2);
+			}
 
-	// Further pass the request to all children of the non-leaf
-	std::set<DecisionDiagram::Edge*> oedges = inner->getOutEdges();
-	for (std::set<DecisionDiagram::Edge*>::iterator it = oedges.begin(); it != oedges.end(); it++){
-		DecisionDiagram::Node* subdiagramRoot = average(result, innerdiag, (*it)->getTo(), leafdiag, leaf);
+			// Insert the smaller node into the final result
+			t.root = result.addFreshNode(t.dd1->getLabel(t.n1));
 
-		// Connect the currently inserted node with the sub-diagram
-		result.addEdge(root, subdiagramRoot, (*it)->getCondition());
+			// Merge the larger one with all children of the smaller node
+			for (CompactDecisionDiagram::EdgeId e = t.dd1->getOutEdgesBegin(t.n1); e != t.dd1->getOutEdgesEnd(t.n1); e++){
+				children.push_back(Task(t.dd1, t.dd1->getTo(e), t.dd2, t.n2));
+			}
+		}
 	}
 
-	return root;
-}
-
-DecisionDiagram::Node* OpAvg::average(DecisionDiagram& result, DecisionDiagram* dd1, DecisionDiagram::Node* n1, DecisionDiagram* dd2, DecisionDiagram::Node* n2){
+	virtual DecisionDiagram::Node* leave(const Task& t, const std::vector<DecisionDiagram::Node*>& subdiagramRoots){
 
-	// Check if one or both of the currently processed nodes is a leaf
-	if (dynamic_cast<DecisionDiagram::LeafNode*>(n1) != NULL && dynamic_cast<DecisionDiagram::LeafNode*>(n2) != NULL){
-		// Yes: Both are leafs
+		if (t.dd1->isLeaf(t.n1) && t.dd2->isLeaf(t.n2)){
+			return op.averageLeafs(result, *t.dd1, t.n1, *t.dd2, t.n2);
+		}else if (t.root != NULL){
+			// Connect the inserted node with the sub-diagrams
+			CompactDecisionDiagram::EdgeId e = t.dd1->getOutEdgesBegin(t.n1);
+			for (std::size_t i = 0; i < subdiagramRoots.size(); i++, e++){
+				result.addEdge(t.root, subdiagramRoots[i], t.dd1->getCondition(e));
+			}
+			return t.root;
+		}
 
-		DecisionDiagram::LeafNode* leaf1 = dynamic_cast<DecisionDiagram::LeafNode*>(n1);
-		DecisionDiagram::LeafNode* leaf2 = dynamic_cast<DecisionDiagram::LeafNode*>(n2);
+		// Both nodes request the same variable: the conditions must be merged now (the thresholds were already parsed when the conditions were constructed)
+		DecisionDiagram::Condition c1 = t.dd1->getCondition(op.getConditionalEdge(*t.dd1, t.n1));
+		DecisionDiagram::Condition c2 = t.dd2->getCondition(op.getConditionalEdge(*t.dd2, t.n2));
+		if (!c1.hasCmpValue() || !c2.hasCmpValue()){
+			std::stringstream msg;
+			msg << "Condition \"" << (c1.hasCmpValue() ? c2 : c1).toString() << "\" does not compare with a numeric value";
+			throw IOperator::OperatorException(msg.str());
+		}
+		double o3 = (c1.getCmpValue() + c2.getCmpValue()) / 2;
+		DecisionDiagram::Condition merged_condition = DecisionDiagram::Condition(c1.getAttribute(), StringHelper::toString(o3), c1.getNormalizedOperation());
 
-		return averageLeafs(result, dd1, leaf1, dd2, leaf2);
-	}else if (dynamic_cast<DecisionDiagram::LeafNode*>(n1) != NULL || dynamic_cast<DecisionDiagram::LeafNode*>(n2) != NULL){
-		// Yes: One is leaf, one is non-leaf
+		// If both second operands are numbers and the condition operators are equal, we just take the average
+		DecisionDiagram::Node* root = result.addFreshNode(t.dd1->getLabel(t.n1));
 
-		DecisionDiagram::Node* nonleaf = (dynamic_cast<DecisionDiagram::LeafNode*>(n1) != NULL ? n2 : n1);
-		DecisionDiagram* nonleafdiag = (dynamic_cast<DecisionDiagram::LeafNode*>(n1) != NULL ? dd2 : dd1);
-		DecisionDiagram::LeafNode* leaf = dynamic_cast<DecisionDiagram::LeafNode*>(nonleaf == n1 ? n2 : n1);
-		DecisionDiagram* leafdiag = nonleafdiag == dd1 ? dd2 : dd1;
+		// Finally, connect the root with it's subtrees
+		result.addEdge(root, subdiagramRoots[1], merged_condition);
+		result.addElseEdge(root, subdiagramRoots[0]);
 
-		return averageInnerLeaf(result, nonleafdiag, nonleaf, leafdiag, leaf);
-	}else{
-		// both are inner nodes
-		return averageInner(result, dd1, n1, dd2, n2);
+		return root;
 	}
+};
+
+DecisionDiagram::Node* OpAvg::average(DecisionDiagram& result, const CompactDecisionDiagram& dd1, CompactDecisionDiagram::NodeId n1, const CompactDecisionDiagram& dd2, CompactDecisionDiagram::NodeId n2){
+	Averaging averaging(*this, result);
+	return averaging.run(Task(&dd1, n1, &dd2, n2));
 }
 
 HexAnswer OpAvg::apply(int arity, std::vector<HexAnswer*>& answers, OperatorArguments& parameters) throw (OperatorException){
+	SymbolTable::Scope symbols;
+
 	try{
 		// Check arity
 		if (arity != 2){
@@ -218,9 +228,11 @@ HexAnswer OpAvg::apply(int arity, std::vector<HexAnswer*>& answers, OperatorArgu
 			throw IOperator::OperatorException(msg.str());
 		}
 
-		// Construct input decision diagrams
-		DecisionDiagram dd1((*answers[0])[0]);
-		DecisionDiagram dd2((*answers[1])[0]);
+		// Construct input decision diagrams; they are only read, so compact snapshots are sufficient
+		DecisionDiagram input1((*answers[0])[0]);
+		DecisionDiagram input2((*answers[1])[0]);
+		CompactDecisionDiagram dd1(input1);
+		CompactDecisionDiagram dd2(input2);
 
 		// check if inputs are trees
 		if (!dd1.isTree() || !dd2.isTree()){
@@ -229,7 +241,7 @@ HexAnswer OpAvg::apply(int arity, std::vector<HexAnswer*>& answers, OperatorArgu
 
 		// Merge the diagrams
 		DecisionDiagram result;
-		average(result, &dd1, dd1.getRoot(), &dd2, dd2.getRoot());
+		average(result, dd1, dd1.getRoot(), dd2, dd2.getRoot());
 
 		// Convert the final decision diagram into a hex answer
 		HexAnswer answer;
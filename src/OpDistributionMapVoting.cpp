@@ -1,5 +1,6 @@
 #include <OpDistributionMapVoting.h>
 #include <DecisionDiagram.h>
+#include <SymbolTable.h>
 
 #include <StringHelper.h>
 
@@ -41,64 +42,80 @@ std::set<std::string> OpDistributionMapVoting::getRecognizedParameters(){
 	return list;
 }
 
-void OpDistributionMapVoting::insert(DecisionDiagram& input, DecisionDiagram& output){
+void OpDistributionMapVoting::insert(DecisionDiagram& input, DecisionDiagram& output, VoteTable& votes){
 
-	// Merge the decision diagrams
-	// Extract all leaf nodes of dd1
-	std::set<DecisionDiagram::LeafNode*> outputLeafs = output.getLeafNodes();
-
-	// Make a copy of ddInput for each leaf node
-	for (std::set<DecisionDiagram::LeafNode*>::iterator formerLeafIt = outputLeafs.begin(); formerLeafIt != outputLeafs.end(); formerLeafIt++){
-		Votes* formerVotes = dynamic_cast<Votes*>((*formerLeafIt)->getData());
+	// The distribution maps of the input leafs are converted into vectors once (copies of the same leaf have the same classification)
+	std::map<SymbolTable::Id, int*> distributions;
 
-		// Make a copy of the input diagram
-		DecisionDiagram inputCopy(input);
+	// Merge the decision diagrams
+	// Leaf nodes of dd1 with equal votes share one copy of ddInput (see OpMajorityVoting::insert)
+	std::vector<std::vector<DecisionDiagram::LeafNode*> > groups;
+	groupByVotes(output, votes, groups);
 
-		// Rename nodes if necessary
-		inputCopy.useUniqueLabels(&output);
+	for (std::vector<std::vector<DecisionDiagram::LeafNode*> >::iterator groupIt = groups.begin(); groupIt != groups.end(); groupIt++){
+		const int* formerVotes = votes.getVotes(groupIt->front());
 
-		// Add it to the output diagram
-		DecisionDiagram::Node* ddInputRoot = output.addDecisionDiagram(&inputCopy);
+		// Add a copy of the input diagram to the output diagram (nodes are renamed if necessary)
+		DecisionDiagram::Node* ddInputRoot = input.mergeInto(output, DecisionDiagram::renameColliding);
 
 		// Adjust the votings structure
 		//	First, add an entry for each new leaf node
-		std::set<DecisionDiagram::LeafNode*> newoutputLeafs = output.getLeafNodes();
-		for (std::set<DecisionDiagram::LeafNode*>::iterator newLeafIt = newoutputLeafs.begin(); newLeafIt != newoutputLeafs.end(); newLeafIt++){
+		//	The new entry for a certain classification is equal to the sum of the former entries (classes which are absent in the former leaf are ignored);
+		//	new leafs with the same classification share their entry
+		std::map<SymbolTable::Id, int*> newVotes;
+		DecisionDiagram::LeafNodeRange newoutputLeafs = output.getLeafNodeRange();
+		for (DecisionDiagram::LeafNodeRange::iterator newLeafIt = newoutputLeafs.begin(); newLeafIt != newoutputLeafs.end(); newLeafIt++){
 			// Check if this is a new leaf node
-			if ((*newLeafIt)->getData() == NULL){
-				try{
-					// The new entry for a certain classification is equal to the sum of the former entries
-					Votings uv = StringHelper::extractDistribution((*newLeafIt)->getClassification());
-					Votes* newVotes = new Votes();
-					newVotes->v = formerVotes->v;
-					for (Votings::iterator vIt = newVotes->v.begin(); vIt != newVotes->v.end();  vIt++){
-						newVotes->v[vIt->first] +=uv[vIt->first]; 
+			if (votes.getVotes(*newLeafIt) == NULL){
+				SymbolTable::Id c = (*newLeafIt)->getClassificationSymbol();
+				std::map<SymbolTable::Id, int*>::iterator nvIt = newVotes.find(c);
+				if (nvIt == newVotes.end()){
+					std::map<SymbolTable::Id, int*>::iterator dIt = distributions.find(c);
+					if (dIt == distributions.end()){
+						try{
+							dIt = distributions.insert(std::pair<SymbolTable::Id, int*>(c, toVotes(votes, (*newLeafIt)->getClassification()))).first;
+						}catch(StringHelper::NotContainedException nce){
+							throw OperatorException(std::string("Leaf node with label \"") + (*newLeafIt)->getClassification() + std::string("\" does not contain a distribution map"));
+						}
+					}
+					int* v = votes.copyVotes(formerVotes);
+					const int* uv = dIt->second;
+					for (VoteTable::ClassId cid = 0; cid < votes.getWidth(); cid++){
+						if (v[cid] != VoteTable::absent && uv[cid] != VoteTable::absent) v[cid] += uv[cid];
 					}
-					(*newLeafIt)->setData(newVotes);
-				}catch(StringHelper::NotContainedException nce){
-					throw OperatorException(std::string("Leaf node with label \"") + (*newLeafIt)->getClassification() + std::string("\" does not contain a distribution map"));
+					nvIt = newVotes.insert(std::pair<SymbolTable::Id, int*>(c, v)).first;
 				}
+				votes.attach(*newLeafIt, nvIt->second);
 			}
 		}
+		for (std::map<SymbolTable::Id, int*>::iterator nvIt = newVotes.begin(); nvIt != newVotes.end(); nvIt++){
+			votes.release(nvIt->second);
+		}
 
-		//	Remove the votings for the former leaf node
-		delete formerVotes;
-
-		// Redirect all in-edges to the former leaf node to the root element of ddInput
-		std::set<DecisionDiagram::Edge*> inEdges = (*formerLeafIt)->getInEdges();
-		for (std::set<DecisionDiagram::Edge*>::iterator inIt = inEdges.begin(); inIt != inEdges.end(); inIt++){
-			// Insert a new edge
-			output.addEdge((*inIt)->getFrom(), ddInputRoot, (*inIt)->getCondition());
-			// Remove the old edge
-			output.removeEdge(*inIt);
+		// Replace the former leaf nodes by the copy
+		for (std::vector<DecisionDiagram::LeafNode*>::iterator formerLeafIt = groupIt->begin(); formerLeafIt != groupIt->end(); formerLeafIt++){
+			replaceLeaf(output, votes, *formerLeafIt, ddInputRoot);
 		}
+	}
+
+	// The distribution maps are no longer needed
+	for (std::map<SymbolTable::Id, int*>::iterator dIt = distributions.begin(); dIt != distributions.end(); dIt++){
+		votes.release(dIt->second);
+	}
+}
 
-		// Remove the former leaf node
-		output.removeNode(*formerLeafIt);
+int* OpDistributionMapVoting::toVotes(VoteTable& votes, const std::string& classification){
+	std::map<std::string, int> distribution = StringHelper::extractDistribution(classification);
+	int* v = votes.newVotes();
+	for (std::map<std::string, int>::iterator it = distribution.begin(); it != distribution.end(); it++){
+		VoteTable::ClassId c = votes.getClassId(it->first);
+		if (c != -1) v[c] = it->second;
 	}
+	return v;
 }
 
 HexAnswer OpDistributionMapVoting::apply(int arity, std::vector<HexAnswer*>& arguments, OperatorArguments& parameters) throw (OperatorException){
+	SymbolTable::Scope symbols;
 
 	// Process parameters
 	eps = 1.0f;
@@ -123,11 +140,6 @@ HexAnswer OpDistributionMapVoting::apply(int arity, std::vector<HexAnswer*>& arg
 			}
 		}
 
-		// Prepare a data structure for votings:
-		// 	Each leaf node needs a set of string/int pairs. The string is a classification and the integer value the number of training examples that ended in this leaf node and
-		//	voted for this class
-		std::map<DecisionDiagram::LeafNode*, Votings> votings;
-
 		// Construct both decision diagrams
 		DecisionDiagram diag1((*arguments[0])[0]);
 		DecisionDiagram diag2((*arguments[1])[0]);
@@ -135,109 +147,93 @@ HexAnswer OpDistributionMapVoting::apply(int arity, std::vector<HexAnswer*>& arg
 			throw IOperator::OperatorException("All input diagrams are expected to be trees.");
 		}
 
-		// Initialize the votings structure
-		std::set<DecisionDiagram::LeafNode*> leafs = diag1.getLeafNodes();
-		for (std::set<DecisionDiagram::LeafNode*>::iterator it = leafs.begin(); it != leafs.end(); it++){
+		// Prepare a data structure for votings:
+		// 	Each leaf node needs a set of string/int pairs. The string is a classification and the integer value the number of training examples that ended in this leaf node and
+		//	voted for this class. Only classes which occur in the distribution maps of the first diagram can ever receive votes.
+		std::set<std::string> classes;
+		DecisionDiagram::LeafNodeRange leafs = diag1.getLeafNodeRange();
+		for (DecisionDiagram::LeafNodeRange::iterator it = leafs.begin(); it != leafs.end(); it++){
 			try{
-				Votes* v = new Votes();
-				v->v = StringHelper::extractDistribution((*it)->getClassification());
-				(*it)->setData(v);
+				std::map<std::string, int> distribution = StringHelper::extractDistribution((*it)->getClassification());
+				for (std::map<std::string, int>::iterator dIt = distribution.begin(); dIt != distribution.end(); dIt++){
+					classes.insert(dIt->first);
+				}
 			}catch(StringHelper::NotContainedException nce){
 				throw OperatorException(std::string("Leaf node with label \"") + (*it)->getClassification() + std::string("\" does not contain a distribution map"));
 			}
 		}
+		VoteTable votes(classes);
 
-		// Insert the second decision diagram into the first one
-		insert(diag2, diag1);
-
-		// Set all class labels of the final diagram to empty "" (=not yet computed)
-		std::set<DecisionDiagram::LeafNode*> outputLeafs = diag1.getLeafNodes();
-		for (std::set<DecisionDiagram::LeafNode*>::iterator leafIt = outputLeafs.begin(); leafIt != outputLeafs.end(); leafIt++){
-			(*leafIt)->setClassification("");
+		// Initialize the votings structure
+		for (DecisionDiagram::LeafNodeRange::iterator it = leafs.begin(); it != leafs.end(); it++){
+			int* v = toVotes(votes, (*it)->getClassification());
+			votes.attach(*it, v);
+			votes.release(v);
 		}
 
-		// Now extract the final diagrams, respecting the eps value
-		std::vector<DecisionDiagram> result = extractDiagrams(eps, diag1);
-/*
-		// Finally, for all remaining leaf nodes, take the classification with the highest number of votes
-		std::set<DecisionDiagram::LeafNode*> outputLeafs = diag1.getLeafNodes();
-		for (std::set<DecisionDiagram::LeafNode*>::iterator leafIt = outputLeafs.begin(); leafIt != outputLeafs.end(); leafIt++){
-			int highestVotes = 0;
-			std::string highestVotedClass("unknown");
+		// Insert the second decision diagram into the first one
+		insert(diag2, diag1, votes);
 
-			// search for the highest voted classification
-			Votes* votes = dynamic_cast<Votes*>((*leafIt)->getData());
-			for (Votings::iterator vIt = votes->v.begin(); vIt != votes->v.end(); vIt++){
-				if ((*vIt).second > highestVotes || ((*vIt).second == highestVotes && (*vIt).first.compare(highestVotedClass) < 0)){
-					highestVotes = (*vIt).second;
-					highestVotedClass = (*vIt).first;
-				}
-			}
+		// The classifications of the leaf nodes are chosen independently, thus shared subdiagrams are copied once per path (the copies share their votes)
+		unfoldShared(diag1, votes);
 
-			// Take the highest voted classification as the final one
-			(*leafIt)->setClassification(highestVotedClass + StringHelper::encodeDistributionMap(votes->v));
-			delete votes;
+		// Set all class labels of the final diagram to empty "" (=not yet computed)
+		DecisionDiagram::LeafNodeRange outputLeafs = diag1.getLeafNodeRange();
+		for (DecisionDiagram::LeafNodeRange::iterator leafIt = outputLeafs.begin(); leafIt != outputLeafs.end(); leafIt++){
+			(*leafIt)->setClassification("");
 		}
-*/
 
-		// Convert the final decision diagrams into hex answers
+		// Now extract the final diagrams, respecting the eps value (they are directly converted into hex answers)
 		HexAnswer answer;
-		for (std::vector<DecisionDiagram>::iterator it = result.begin(); it != result.end(); ++it){
-			answer.push_back(it->toAnswerSet());
-		}
+		extractDiagrams(eps, diag1, votes, answer);
+
 		return answer;
 	}catch(DecisionDiagram::InvalidDecisionDiagram idde){
 		throw IOperator::OperatorException(std::string("InvalidDecisionDiagram: ") + idde.getMessage());
 	}
 }
-//#include <iostream>
-std::vector<DecisionDiagram> OpDistributionMapVoting::extractDiagrams(float eps, DecisionDiagram& diag){
-
-	std::vector<DecisionDiagram> result;
+// the diagram is modified in place (backtracking); each final variant is converted into an answer set, thus no copies of the diagram are needed
+void OpDistributionMapVoting::extractDiagrams(float eps, DecisionDiagram& diag, VoteTable& votes, HexAnswer& result){
 
 	// Go through all leaf nodes
-//int d = 0;
 	std::set<DecisionDiagram::LeafNode*> leafs = diag.getLeafNodes();
 	for (std::set<DecisionDiagram::LeafNode*>::iterator leafIt = leafs.begin(); leafIt != leafs.end(); leafIt++){
-//d++;
 		// make sure that this terminates: go to the first unprocessed leaf node
 		if ((*leafIt)->getClassification() == std::string("")){
 			int highestVotes = 0;
 			std::string highestVotedClass("unknown");
 
-			// search for the highest voted classification
-			Votes* votes = dynamic_cast<Votes*>((*leafIt)->getData());
-			for (Votings::iterator vIt = votes->v.begin(); vIt != votes->v.end(); vIt++){
-				if ((*vIt).second > highestVotes || ((*vIt).second == highestVotes && (*vIt).first.compare(highestVotedClass) < 0)){
-					highestVotes = (*vIt).second;
-					highestVotedClass = (*vIt).first;
+			// search for the highest voted classification (the class ids are ordered lexically)
+			const int* v = votes.getVotes(*leafIt);
+			std::map<std::string, int> distribution;
+			for (VoteTable::ClassId c = 0; c < votes.getWidth(); c++){
+				if (v[c] == VoteTable::absent) continue;
+				if (v[c] > highestVotes || (v[c] == highestVotes && votes.getClassName(c).compare(highestVotedClass) < 0)){
+					highestVotes = v[c];
+					highestVotedClass = votes.getClassName(c);
 				}
+				distribution[votes.getClassName(c)] = v[c];
 			}
+			std::string encodedDistribution = StringHelper::encodeDistributionMap(distribution);
 
 			// for each class label with >= eps * highestVotes create a copy of the diagram
-//std::cout << votes->v.size() <<  " " ;
-			for (Votings::iterator vIt = votes->v.begin(); vIt != votes->v.end(); vIt++){
-				if ((*vIt).second > (int)((float)highestVotes * eps) || ((*vIt).second == highestVotes && eps == 1.0f)){
-//std::cout << "+";
-//for (int j = 0; j < d; j++) std::cout << "     ";
-//std::cout << "Try " << (*vIt).first << std::endl;
-					(*leafIt)->setClassification((*vIt).first + StringHelper::encodeDistributionMap(votes->v));
+			for (VoteTable::ClassId c = 0; c < votes.getWidth(); c++){
+				if (v[c] == VoteTable::absent) continue;
+				if (v[c] > (int)((float)highestVotes * eps) || (v[c] == highestVotes && eps == 1.0f)){
+					(*leafIt)->setClassification(votes.getClassName(c) + encodedDistribution);
 
 					// Recursively compute the outcome for the other leaf nodes
-					std::vector<DecisionDiagram> subresult = extractDiagrams(eps, diag);
-					result.insert(result.end(), subresult.begin(), subresult.end());
-//std::cout << "#" << subresult.size() << " " ;
+					extractDiagrams(eps, diag, votes, result);
 				}
 			}
 			// Backtrack: Restore "unprocessedness" of the current leaf node
 			(*leafIt)->setClassification("");
 
 			// finally we have processed all leaf nodes
-			return result;
+			return;
 		}
 	}
 
 	// no more unprocessed diagrams -> done
-	result.push_back(diag);
-	return result;
+	result.push_back(diag.toAnswerSet());
 }
@@ -1,8 +1,12 @@
 #include <OpMajorityVoting.h>
 #include <DecisionDiagram.h>
+#include <SymbolTable.h>
+#include <DecisionDiagramBuilder.h>
 
+#include <map>
 #include <sstream>
 #include <set>
+#include <vector>
 
 using namespace dlvhex::dd::util;
 using namespace dlvhex::dd::plugin;
@@ -31,62 +35,137 @@ std::set<std::string> OpMajorityVoting::getRecognizedParameters(){
 	return list;
 }
 
-void OpMajorityVoting::insert(DecisionDiagram& input, DecisionDiagram& output){
+void OpMajorityVoting::collectClasses(const DecisionDiagram& dd, std::set<std::string>& classes){
+	DecisionDiagram::LeafNodeRange leafs = dd.getLeafNodeRange();
+	for (DecisionDiagram::LeafNodeRange::iterator it = leafs.begin(); it != leafs.end(); it++){
+		classes.insert((*it)->getClassification());
+	}
+}
 
-	// Merge the decision diagrams
-	// Extract all leaf nodes of the intermediate result
-	std::set<DecisionDiagram::LeafNode*> outputLeafs = output.getLeafNodes();
+// groups the leaf nodes of the intermediate result by their votes (the groups are ordered by their first member)
+void OpMajorityVoting::groupByVotes(const DecisionDiagram& output, const VoteTable& votes, std::vector<std::vector<DecisionDiagram::LeafNode*> >& groups){
+	std::map<std::vector<int>, int> groupIndex;
+	DecisionDiagram::LeafNodeRange leafs = output.getLeafNodeRange();
+	for (DecisionDiagram::LeafNodeRange::iterator it = leafs.begin(); it != leafs.end(); it++){
+		const int* v = votes.getVotes(*it);
+		std::map<std::vector<int>, int>::iterator gIt = groupIndex.insert(std::pair<std::vector<int>, int>(std::vector<int>(v, v + votes.getWidth()), groups.size())).first;
+		if (gIt->second == (int)groups.size()) groups.push_back(std::vector<DecisionDiagram::LeafNode*>());
+		groups[gIt->second].push_back(*it);
+	}
+}
+
+// replaces a leaf node of the intermediate result by a subdiagram, i.e. all in-edges of the leaf node are redirected to the root of the subdiagram
+void OpMajorityVoting::replaceLeaf(DecisionDiagram& output, VoteTable& votes, DecisionDiagram::LeafNode* leaf, DecisionDiagram::Node* subdiagram){
+
+	// Remove the votings for the former leaf node
+	votes.detach(leaf);
+
+	// Redirect all in-edges (explicit snapshot since the edges are removed in the loop)
+	std::set<DecisionDiagram::Edge*> inEdges = leaf->getInEdges();
+	for (std::set<DecisionDiagram::Edge*>::iterator inIt = inEdges.begin(); inIt != inEdges.end(); inIt++){
+		// Insert a new edge
+		if ((*inIt)->isElse()){
+			output.addElseEdge((*inIt)->getFrom(), subdiagram);
+		}else{
+			output.addEdge((*inIt)->getFrom(), subdiagram, (*inIt)->getCondition());
+		}
+		// Remove the old edge
+		output.removeEdge(*inIt);
+	}
 
-	// Make a copy of the new input diagram for each leaf node
-	for (std::set<DecisionDiagram::LeafNode*>::iterator formerLeafIt = outputLeafs.begin(); formerLeafIt != outputLeafs.end(); formerLeafIt++){
-		Votes* formerVotes = dynamic_cast<Votes*>((*formerLeafIt)->getData());
+	// Remove the former leaf node
+	output.removeNode(leaf);
+}
+
+// copies each node which is reachable on several paths once per additional in-edge, such that the diagram becomes a tree again (copy-on-write);
+// copies of leaf nodes share the votes of the original
+void OpMajorityVoting::unfoldShared(DecisionDiagram& dd, VoteTable& votes){
+
+	// The copies of a node only have one in-edge, but they add in-edges to the children of the node, which come later in topological order (explicit snapshot since nodes are added)
+	std::vector<DecisionDiagram::Node*> order = dd.getTopologicalOrder();
+	for (std::vector<DecisionDiagram::Node*>::iterator it = order.begin(); it != order.end(); it++){
+		if ((*it)->getInEdgesCount() <= 1) continue;
 
-		// Make a copy of the input diagram
-		DecisionDiagram inputCopy(input);
+		// The first in-edge keeps the original (explicit snapshot since the edges are removed in the loop)
+		std::set<DecisionDiagram::Edge*> inEdges = (*it)->getInEdges();
+		std::set<DecisionDiagram::Edge*>::iterator inIt = inEdges.begin();
+		for (inIt++; inIt != inEdges.end(); inIt++){
+			DecisionDiagram::Node* copy;
+			DecisionDiagram::LeafNode* leaf = (*it)->asLeaf();
+			if (leaf != NULL){
+				DecisionDiagram::LeafNode* leafCopy = dd.addFreshLeafNode(leaf);
+				votes.share(leafCopy, leaf);
+				copy = leafCopy;
+			}else{
+				copy = dd.addFreshNode(*it);
+				DecisionDiagram::EdgeList outEdges = (*it)->getOutEdgeRange();
+				for (DecisionDiagram::EdgeList::iterator outIt = outEdges.begin(); outIt != outEdges.end(); outIt++){
+					if ((*outIt)->isElse()){
+						dd.addElseEdge(copy, (*outIt)->getTo());
+					}else{
+						dd.addEdge(copy, (*outIt)->getTo(), (*outIt)->getCondition());
+					}
+				}
+			}
 
-		// Rename nodes if necessary
-		inputCopy.useUniqueLabels(&output);
+			// Redirect the in-edge to the copy
+			if ((*inIt)->isElse()){
+				dd.addElseEdge((*inIt)->getFrom(), copy);
+			}else{
+				dd.addEdge((*inIt)->getFrom(), copy, (*inIt)->getCondition());
+			}
+			dd.removeEdge(*inIt);
+		}
+	}
+}
 
-		// Add it to the output diagram
-		DecisionDiagram::Node* ddInputRoot = output.addDecisionDiagram(&inputCopy);
+void OpMajorityVoting::insert(DecisionDiagram& input, DecisionDiagram& output, VoteTable& votes){
+
+	// Merge the decision diagrams
+	// Leaf nodes of the intermediate result with equal votes share one copy of the input diagram, since the leafs of the copy receive equal votes as well;
+	// the input is only copied once per distinct votes, and the output is a diagram with shared subdiagrams (see unfoldShared)
+	std::vector<std::vector<DecisionDiagram::LeafNode*> > groups;
+	groupByVotes(output, votes, groups);
+
+	for (std::vector<std::vector<DecisionDiagram::LeafNode*> >::iterator groupIt = groups.begin(); groupIt != groups.end(); groupIt++){
+		const int* formerVotes = votes.getVotes(groupIt->front());
+
+		// Add a copy of the input diagram to the output diagram (nodes are renamed if necessary)
+		DecisionDiagram::Node* ddInputRoot = input.mergeInto(output, DecisionDiagram::renameColliding);
 
 		// Adjust the votings structure
 		//	First, add an entry for each new leaf node
-		std::set<DecisionDiagram::LeafNode*> newoutputLeafs = output.getLeafNodes();
-		for (std::set<DecisionDiagram::LeafNode*>::iterator newLeafIt = newoutputLeafs.begin(); newLeafIt != newoutputLeafs.end(); newLeafIt++){
+		//	The new entry is equal to the entry of the former leafs, except that the counter for the classification of the new leaf is incremented by 1;
+		//	new leafs with the same classification share their entry
+		std::map<SymbolTable::Id, int*> newVotes;
+		DecisionDiagram::LeafNodeRange newoutputLeafs = output.getLeafNodeRange();
+		for (DecisionDiagram::LeafNodeRange::iterator newLeafIt = newoutputLeafs.begin(); newLeafIt != newoutputLeafs.end(); newLeafIt++){
 			// Check if this is a new leaf node
-			if ((*newLeafIt)->getData() == NULL){
-				// The new entry is equal to the entry of the former leaf, except that the counter for the classification of the new leaf is incremented by 1
-				Votes* newVotes = new Votes();
-				newVotes->v = formerVotes->v;
-				if (newVotes->v.find((*newLeafIt)->getClassification()) == newVotes->v.end()){
-					newVotes->v[(*newLeafIt)->getClassification()] = 1;
-				}else{
-					newVotes->v[(*newLeafIt)->getClassification()]++;
+			if (votes.getVotes(*newLeafIt) == NULL){
+				SymbolTable::Id c = (*newLeafIt)->getClassificationSymbol();
+				std::map<SymbolTable::Id, int*>::iterator nvIt = newVotes.find(c);
+				if (nvIt == newVotes.end()){
+					int* v = votes.copyVotes(formerVotes);
+					VoteTable::ClassId cid = votes.getClassId(c);
+					v[cid] = (v[cid] == VoteTable::absent ? 1 : v[cid] + 1);
+					nvIt = newVotes.insert(std::pair<SymbolTable::Id, int*>(c, v)).first;
 				}
-				(*newLeafIt)->setData(newVotes);
+				votes.attach(*newLeafIt, nvIt->second);
 			}
 		}
-
-		//	Remove the votings for the former leaf node
-		delete formerVotes;
-
-		// Redirect all in-edges to the former leaf node to the root element of ddInput
-		std::set<DecisionDiagram::Edge*> inEdges = (*formerLeafIt)->getInEdges();
-		for (std::set<DecisionDiagram::Edge*>::iterator inIt = inEdges.begin(); inIt != inEdges.end(); inIt++){
-			// Insert a new edge
-			output.addEdge((*inIt)->getFrom(), ddInputRoot, (*inIt)->getCondition());
-			// Remove the old edge
-			output.removeEdge(*inIt);
+		for (std::map<SymbolTable::Id, int*>::iterator nvIt = newVotes.begin(); nvIt != newVotes.end(); nvIt++){
+			votes.release(nvIt->second);
 		}
 
-		// Remove the former leaf node
-		output.removeNode(*formerLeafIt);
-
+		// Replace the former leaf nodes by the copy
+		for (std::vector<DecisionDiagram::LeafNode*>::iterator formerLeafIt = groupIt->begin(); formerLeafIt != groupIt->end(); formerLeafIt++){
+			replaceLeaf(output, votes, *formerLeafIt, ddInputRoot);
+		}
 	}
 }
 
 HexAnswer OpMajorityVoting::apply(int arity, std::vector<HexAnswer*>& arguments, OperatorArguments& parameters) throw (OperatorException){
+	SymbolTable::Scope symbols;
 
 	try{
 		// Check arity
@@ -109,43 +188,65 @@ HexAnswer OpMajorityVoting::apply(int arity, std::vector<HexAnswer*>& arguments,
 			throw IOperator::OperatorException("All input diagrams are expected to be trees.");
 		}
 
-		// Initialize the votings structure for the leafs of the startup diagram
-		std::set<DecisionDiagram::LeafNode*> leafs = output.getLeafNodes();
-		for (std::set<DecisionDiagram::LeafNode*>::iterator it = leafs.begin(); it != leafs.end(); it++){
-			Votes* votings = new Votes();
-			votings->v[(*it)->getClassification()] = 1;
-			(*it)->setData(votings);
-		}
-
-		// Insert all input decision diagrams
+		// Construct all other input diagrams (the classes of all diagrams must be known before the votings structure can be built)
+		std::vector<DecisionDiagram> inputs(arity - 1);
 		for (int answer = 1; answer < arity; answer++){
-			DecisionDiagram ddInput((*arguments[answer])[0]);
-			if (!ddInput.isTree()){
+			DecisionDiagramBuilder::build((*arguments[answer])[0], inputs[answer - 1]);
+			if (!inputs[answer - 1].isTree()){
 				throw IOperator::OperatorException("All input diagrams are expected to be trees.");
 			}
-			insert(ddInput, output);
+		}
+		std::set<std::string> classes;
+		collectClasses(output, classes);
+		for (std::vector<DecisionDiagram>::iterator it = inputs.begin(); it != inputs.end(); it++){
+			collectClasses(*it, classes);
+		}
+		VoteTable votes(classes);
+
+		// Initialize the votings structure for the leafs of the startup diagram (leafs with the same classification share their entry)
+		std::map<SymbolTable::Id, int*> initialVotes;
+		DecisionDiagram::LeafNodeRange leafs = output.getLeafNodeRange();
+		for (DecisionDiagram::LeafNodeRange::iterator it = leafs.begin(); it != leafs.end(); it++){
+			SymbolTable::Id c = (*it)->getClassificationSymbol();
+			if (initialVotes.find(c) == initialVotes.end()){
+				int* v = votes.newVotes();
+				v[votes.getClassId(c)] = 1;
+				initialVotes[c] = v;
+			}
+			votes.attach(*it, initialVotes[c]);
+		}
+		for (std::map<SymbolTable::Id, int*>::iterator it = initialVotes.begin(); it != initialVotes.end(); it++){
+			votes.release(it->second);
+		}
+
+		// Insert all input decision diagrams
+		for (std::vector<DecisionDiagram>::iterator it = inputs.begin(); it != inputs.end(); it++){
+			insert(*it, output, votes);
 		}
 
 		// Finally, for all remaining leaf nodes, take the classification with the highest votes
-		std::set<DecisionDiagram::LeafNode*> outputLeafs = output.getLeafNodes();
-		for (std::set<DecisionDiagram::LeafNode*>::iterator leafIt = outputLeafs.begin(); leafIt != outputLeafs.end(); leafIt++){
+		DecisionDiagram::LeafNodeRange outputLeafs = output.getLeafNodeRange();
+		for (DecisionDiagram::LeafNodeRange::iterator leafIt = outputLeafs.begin(); leafIt != outputLeafs.end(); leafIt++){
 			int highestVotes = 0;
 			std::string highestVotedClass("unknown");
 
-			// search for the highest voted classification
-			Votes* votes = dynamic_cast<Votes*>((*leafIt)->getData());
-			for (Votings::iterator vIt = votes->v.begin(); vIt != votes->v.end(); vIt++){
-				if ((*vIt).second > highestVotes || ((*vIt).second == highestVotes && (*vIt).first.compare(highestVotedClass) < 0)){
-					highestVotes = (*vIt).second;
-					highestVotedClass = (*vIt).first;
+			// search for the highest voted classification (the class ids are ordered lexically)
+			const int* v = votes.getVotes(*leafIt);
+			for (VoteTable::ClassId c = 0; c < votes.getWidth(); c++){
+				if (v[c] == VoteTable::absent) continue;
+				if (v[c] > highestVotes || (v[c] == highestVotes && votes.getClassName(c).compare(highestVotedClass) < 0)){
+					highestVotes = v[c];
+					highestVotedClass = votes.getClassName(c);
 				}
 			}
-			delete (*leafIt)->getData();
 
 			// Take the highest voted classification as the final one
 			(*leafIt)->setClassification(highestVotedClass);
 		}
 
+		// The result is a tree like the input diagrams: shared subdiagrams are copied once per path
+		unfoldShared(output, votes);
+
 		// Convert the final decision diagram into a hex answer
 		HexAnswer answer;
 		answer.push_back(output.toAnswerSet());
@@ -1,5 +1,6 @@
 #include <OpOrderBinaryDecisionTree.h>
 #include <DecisionDiagram.h>
+#include <SymbolTable.h>
 
 #include <sstream>
 #include <set>
@@ -42,7 +43,7 @@ std::string OpOrderBinaryDecisionTree::getCompareAttribute(DecisionDiagram::Node
 				msg << "Node \"" << node->getLabel() << "\" has more than one outgoing conditional edge";
 				throw IOperator::OperatorException(msg.str());
 			}
-			attr = condition.getOperand1();
+			attr = condition.getAttribute();
 			attrFound = true;
 		}
 	}
@@ -54,121 +55,167 @@ std::string OpOrderBinaryDecisionTree::getCompareAttribute(DecisionDiagram::Node
 	return attr;
 }
 
-// sinks a given node until it is smaller than each of it's children (similat to Heap sort)
-DecisionDiagram::Node* OpOrderBinaryDecisionTree::sink(DecisionDiagram& dd, DecisionDiagram::Node* root){
-	// We only work with binary decision trees
-	if (root->getOutEdgesCount() != 2){
-		std::stringstream msg;
-		msg << "Error: Decision tree is not binary. Node \"" << root->getLabel() << "\" has " << root->getOutEdgesCount() << " outgoing edges.";
-		throw IOperator::OperatorException(msg.str());
-	}
-
-	// Check if root needs to be exchanged with one of it's children
-	std::set<DecisionDiagram::Edge*> iedges = root->getInEdges();
-	std::set<DecisionDiagram::Edge*> oedges = root->getOutEdges();
-	int childNr = 0;
-	int echildNr;
-	DecisionDiagram::Node* exchangechild = NULL;
-	for (std::set<DecisionDiagram::Edge*>::iterator it = oedges.begin(); it != oedges.end(); it++){
-		// Assumption: child is already ordered!
-		DecisionDiagram::Node* child = (*it)->getTo();
-
-		if (dynamic_cast<DecisionDiagram::LeafNode*>(child) == NULL && getCompareAttribute(root).compare(getCompareAttribute(child)) > 0 &&	// Exchange inner nodes only
-			(exchangechild == NULL || getCompareAttribute(child).compare(getCompareAttribute(exchangechild)) < 0)){				// Exchange with the smallest child
-			exchangechild = child;
-			echildNr = childNr;
+namespace{
+	// a node which is processed by sink or order; the fields are filled when the node is entered and used when it is left
+	struct Task{
+		Task(DecisionDiagram::Node* node_) : node(node_), newroot(NULL){
 		}
-		childNr++;
-	}
 
-	if (exchangechild != NULL){
-		// Root needs to be exchanged with this child
-
-		//              root                               echild
-		//        (c1)/      \(c2)       ===>       (c3)/          \(c4)
-		//        sibling    echild                 root            root-copy
-		//              (c3)/     \(c4)        (c1)/    \(c2)  (c1)/         \(c2)
-		//          resttree1    resttree2   sibling resttree1  sibling-copy  resttree2
-
-		// First, use human readable names for the nodes of interest
-		DecisionDiagram::Node* newroot = exchangechild;
-		DecisionDiagram::Node* sibling1root = root->getChild(1 - echildNr);				// Take the other child (echild's sibling)
-		DecisionDiagram::Condition siblingcondition = root->getOutEdge(1 - echildNr)->getCondition();	// c1
-		DecisionDiagram::Condition currentchildcondition = root->getOutEdge(echildNr)->getCondition();	// c2
-		DecisionDiagram siblingCopy;									// Copy the sub-tree since we need it twice (see figure)
-		siblingCopy.partialAddDecisionDiagram(&dd, sibling1root);
-		siblingCopy.useUniqueLabels(&dd);
-
-		DecisionDiagram::Node* sibling2root = dd.addDecisionDiagram(&siblingCopy);
-		DecisionDiagram::Node* newrootSuccessor1 = root;						// The old root is a successor (child) of the new root
-		DecisionDiagram::Node* newrootSuccessor2 = dd.addNode(dd.getUniqueLabel(root->getLabel()));	// We need the old root node twice
-		DecisionDiagram::Node* resttree1root = newroot->getChild(0);					// root of resttree1
-		DecisionDiagram::Condition resttree1condition = newroot->getOutEdge(0)->getCondition();		// c3
-		DecisionDiagram::Node* resttree2root = newroot->getChild(1);					// root of resttree2
-		DecisionDiagram::Condition resttree2condition = newroot->getOutEdge(1)->getCondition();		// c4
-
-		// Cut out all edges from the old root to it's successors
-		for (std::set<DecisionDiagram::Edge*>::iterator e = oedges.begin(); e != oedges.end(); e++) dd.removeEdge(*e);
-		// Also cut ingoing edges
-		for (std::set<DecisionDiagram::Edge*>::iterator e = iedges.begin(); e != iedges.end(); e++) dd.removeEdge(*e);
-		// Cut out all edges from the child which becomes the new root root to it's successors
-		std::set<DecisionDiagram::Edge*> newrootOutEdges = newroot->getOutEdges();
-		for (std::set<DecisionDiagram::Edge*>::iterator e = newrootOutEdges.begin(); e != newrootOutEdges.end(); e++) dd.removeEdge(*e);
-
-		// Create new connections
-		dd.addEdge(newrootSuccessor1, sibling1root, siblingcondition);					// root to sibling
-		dd.addEdge(newrootSuccessor1, resttree1root, currentchildcondition);				// root to resttree1
-		dd.addEdge(newrootSuccessor2, sibling2root, siblingcondition);					// root-copy to sibling-copy
-		dd.addEdge(newrootSuccessor2, resttree2root, currentchildcondition);				// root-copy to resttree2
-
-		// Sink the new root successors since sinking might goes on further
-		DecisionDiagram::Node* subtree1root = sink(dd, newrootSuccessor1);				// subtree1root can be equal to newrootSuccessor1, but might be different
-		DecisionDiagram::Node* subtree2root = sink(dd, newrootSuccessor2);				// subtree2root can be equal to newrootSuccessor2, but might be different
-
-		// Redirect the edges to the new subtree roots (since they might have changed)
-		dd.addEdge(newroot, subtree1root, resttree1condition);
-		dd.addEdge(newroot, subtree2root, resttree2condition);
-
-		return newroot;
-	}else{
-		return root;
-	}
+		DecisionDiagram::Node* node;
+		DecisionDiagram::Node* newroot;				// sink: the child which was exchanged with node (if any)
+		std::vector<DecisionDiagram::Condition> conditions;	// the conditions of the edges to the children, which are restored when the children are processed
+	};
 }
 
-// orders a diagram
-DecisionDiagram::Node* OpOrderBinaryDecisionTree::order(DecisionDiagram& dd, DecisionDiagram::Node* root){
+// sinks a node and, recursively, its copies (see sink)
+class OpOrderBinaryDecisionTree::Sinking : public DecisionDiagram::Traversal<Task, DecisionDiagram::Node*>{
+private:
+	OpOrderBinaryDecisionTree& op;
+	DecisionDiagram& dd;
+public:
+	Sinking(OpOrderBinaryDecisionTree& op_, DecisionDiagram& dd_) : op(op_), dd(dd_){
+	}
 
-	// First of all order the sub-trees (if root is a leaf, it is already sorted)
-	// The overall algorithm is very similar to heap sort, even if the sinking procedure (especially redirecting the pointers between the nodes)
-	// is more complicated in this case, since we must deal with conditional and unconditional edges and need to duplicate sub-trees in certain cases.
-	if (dynamic_cast<DecisionDiagram::LeafNode*>(root) == NULL){
+	virtual void enter(Task& task, std::vector<Task>& children){
+		DecisionDiagram::Node* root = task.node;
 
-		// root is an inner node
+		// We only work with binary decision trees
+		if (root->getOutEdgesCount() != 2){
+			std::stringstream msg;
+			msg << "Error: Decision tree is not binary. Node \"" << root->getLabel() << "\" has " << root->getOutEdgesCount() << " outgoing edges.";
+			throw IOperator::OperatorException(msg.str());
+		}
 
+		// Check if root needs to be exchanged with one of it's children
+		std::set<DecisionDiagram::Edge*> iedges = root->getInEdges();
 		std::set<DecisionDiagram::Edge*> oedges = root->getOutEdges();
-		for (std::set<DecisionDiagram::Edge*>::iterator it = oedges.begin(); it != oedges.end(); it++){
-			DecisionDiagram::Node* child = (*it)->getTo();
+		int echildNr;
+		DecisionDiagram::Node* exchangechild = NULL;
+		for (int childNr = 0; childNr < root->getChildCount(); childNr++){
+			// Assumption: child is already ordered!
+			DecisionDiagram::Node* child = root->getChild(childNr);
+
+			if (!child->isLeaf() && op.getCompareAttribute(root).compare(op.getCompareAttribute(child)) > 0 &&	// Exchange inner nodes only
+				(exchangechild == NULL || op.getCompareAttribute(child).compare(op.getCompareAttribute(exchangechild)) < 0)){		// Exchange with the smallest child
+				exchangechild = child;
+				echildNr = childNr;
+			}
+		}
 
-			// redirect the edges to the new subtree roots (since they might have changed): remove old edge first, but remember it's condition
-			DecisionDiagram::Condition condition = (*it)->getCondition();
-			dd.removeEdge(*it);
+		if (exchangechild != NULL){
+			// Root needs to be exchanged with this child
+
+			//              root                               echild
+			//        (c1)/      \(c2)       ===>       (c3)/          \(c4)
+			//        sibling    echild                 root            root-copy
+			//              (c3)/     \(c4)        (c1)/    \(c2)  (c1)/         \(c2)
+			//          resttree1    resttree2   sibling resttree1  sibling-copy  resttree2
+
+			// First, use human readable names for the nodes of interest
+			DecisionDiagram::Node* newroot = exchangechild;
+			DecisionDiagram::Node* sibling1root = root->getChild(1 - echildNr);				// Take the other child (echild's sibling)
+			DecisionDiagram::Condition siblingcondition = root->getOutEdge(1 - echildNr)->getCondition();	// c1
+			DecisionDiagram::Condition currentchildcondition = root->getOutEdge(echildNr)->getCondition();	// c2
+			DecisionDiagram::Node* sibling2root = dd.mergeInto(dd, DecisionDiagram::renameColliding, sibling1root);	// Copy the sub-tree since we need it twice (see figure)
+			DecisionDiagram::Node* newrootSuccessor1 = root;						// The old root is a successor (child) of the new root
+			DecisionDiagram::Node* newrootSuccessor2 = dd.addFreshNode(root);	// We need the old root node twice
+			DecisionDiagram::Node* resttree1root = newroot->getChild(0);					// root of resttree1
+			DecisionDiagram::Condition resttree1condition = newroot->getOutEdge(0)->getCondition();		// c3
+			DecisionDiagram::Node* resttree2root = newroot->getChild(1);					// root of resttree2
+			DecisionDiagram::Condition resttree2condition = newroot->getOutEdge(1)->getCondition();		// c4
+
+			// Cut out all edges from the old root to it's successors
+			for (std::set<DecisionDiagram::Edge*>::iterator e = oedges.begin(); e != oedges.end(); e++) dd.removeEdge(*e);
+			// Also cut ingoing edges
+			for (std::set<DecisionDiagram::Edge*>::iterator e = iedges.begin(); e != iedges.end(); e++) dd.removeEdge(*e);
+			// Cut out all edges from the child which becomes the new root root to it's successors
+			std::set<DecisionDiagram::Edge*> newrootOutEdges = newroot->getOutEdges();
+			for (std::set<DecisionDiagram::Edge*>::iterator e = newrootOutEdges.begin(); e != newrootOutEdges.end(); e++) dd.removeEdge(*e);
+
+			// Create new connections
+			dd.addEdge(newrootSuccessor1, sibling1root, siblingcondition);					// root to sibling
+			dd.addEdge(newrootSuccessor1, resttree1root, currentchildcondition);				// root to resttree1
+			dd.addEdge(newrootSuccessor2, sibling2root, siblingcondition);					// root-copy to sibling-copy
+			dd.addEdge(newrootSuccessor2, resttree2root, currentchildcondition);				// root-copy to resttree2
+
+			// Sink the new root successors since sinking might goes on further
+			children.push_back(Task(newrootSuccessor1));
+			children.push_back(Task(newrootSuccessor2));
+
+			// The edges from the new root are restored when the new root successors are sunk
+			task.newroot = newroot;
+			task.conditions.push_back(resttree1condition);
+			task.conditions.push_back(resttree2condition);
+		}
+	}
+
+	virtual DecisionDiagram::Node* leave(const Task& task, const std::vector<DecisionDiagram::Node*>& subtreeroots){
+		if (task.newroot != NULL){
+			// Redirect the edges to the new subtree roots (since they might have changed)
+			dd.addEdge(task.newroot, subtreeroots[0], task.conditions[0]);
+			dd.addEdge(task.newroot, subtreeroots[1], task.conditions[1]);
+			return task.newroot;
+		}else{
+			return task.node;
+		}
+	}
+};
+
+// orders the subtrees bottom-up (see order)
+class OpOrderBinaryDecisionTree::Ordering : public DecisionDiagram::Traversal<Task, DecisionDiagram::Node*>{
+private:
+	OpOrderBinaryDecisionTree& op;
+	DecisionDiagram& dd;
+public:
+	Ordering(OpOrderBinaryDecisionTree& op_, DecisionDiagram& dd_) : op(op_), dd(dd_){
+	}
+
+	virtual void enter(Task& task, std::vector<Task>& children){
+		// First of all order the sub-trees (if root is a leaf, it is already sorted)
+		if (!task.node->isLeaf()){
+			std::set<DecisionDiagram::Edge*> oedges = task.node->getOutEdges();
+			for (std::set<DecisionDiagram::Edge*>::iterator it = oedges.begin(); it != oedges.end(); it++){
+				children.push_back(Task((*it)->getTo()));
+
+				// the edges are redirected to the new subtree roots (since they might have changed): remove old edge first, but remember it's condition
+				task.conditions.push_back((*it)->getCondition());
+				dd.removeEdge(*it);
+			}
+		}
+	}
 
-			// order the subtree
-			DecisionDiagram::Node* subtreeroot = order(dd, child);
+	virtual DecisionDiagram::Node* leave(const Task& task, const std::vector<DecisionDiagram::Node*>& subtreeroots){
+		if (task.node->isLeaf()){
+			// is already ordered
+			return task.node;
+		}
 
-			// restore the edge
-			dd.addEdge(root, subtreeroot, condition);
+		// restore the edges
+		for (std::size_t i = 0; i < subtreeroots.size(); i++){
+			dd.addEdge(task.node, subtreeroots[i], task.conditions[i]);
 		}
 
 		// Now sink the current root node and return the new root
-		return sink(dd, root);
-	}else{
-		// is already ordered
-		return root;
+		return op.sink(dd, task.node);
 	}
+};
+
+// sinks a given node until it is smaller than each of it's children (similat to Heap sort)
+DecisionDiagram::Node* OpOrderBinaryDecisionTree::sink(DecisionDiagram& dd, DecisionDiagram::Node* root){
+	Sinking sinking(*this, dd);
+	return sinking.run(Task(root));
+}
+
+// orders a diagram
+// The overall algorithm is very similar to heap sort, even if the sinking procedure (especially redirecting the pointers between the nodes)
+// is more complicated in this case, since we must deal with conditional and unconditional edges and need to duplicate sub-trees in certain cases.
+DecisionDiagram::Node* OpOrderBinaryDecisionTree::order(DecisionDiagram& dd, DecisionDiagram::Node* root){
+	Ordering ordering(*this, dd);
+	return ordering.run(Task(root));
 }
 
 HexAnswer OpOrderBinaryDecisionTree::apply(int arity, std::vector<HexAnswer*>& answers, OperatorArguments& parameters) throw (OperatorException){
+	SymbolTable::Scope symbols;
 
 	try{
 		// Check arity
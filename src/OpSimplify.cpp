@@ -1,5 +1,6 @@
 #include <OpSimplify.h>
 #include <DecisionDiagram.h>
+#include <SymbolTable.h>
 
 #include <sstream>
 #include <set>
@@ -29,145 +30,138 @@ std::set<std::string> OpSimplify::getRecognizedParameters(){
 	return list;
 }
 
-// removes the connective component that "n" is part of
-// this method has a built-in security check: it won't remove components that are reachable from the root
-void OpSimplify::removeConnectiveComponent(DecisionDiagram& dd, DecisionDiagram::Node* n){
-	// check if n is reachible from the root
-	if (dd.containsPath(dd.getRoot(), n)) return;
+namespace{
+	// reduces subgraphs bottom-up (see OpSimplify::reduceSubgraph); each node is processed once, even if it is reachable on several paths
+	class Reduction : public DecisionDiagram::MemoizedTraversal<DecisionDiagram::Node*, DecisionDiagram::Node*>{
+	private:
+		DecisionDiagram& dd;
+	public:
+		Reduction(DecisionDiagram& dd_) : dd(dd_){
+		}
 
-	std::set<DecisionDiagram::Edge*> outEdges = n->getOutEdges();
-	std::set<DecisionDiagram::Edge*> inEdges = n->getInEdges();
+		virtual void enter(DecisionDiagram::Node*& n, std::vector<DecisionDiagram::Node*>& children){
+			// reduce all subgraphs first
+			std::set<DecisionDiagram::Edge*> outedges = n->getOutEdges();
+			for (std::set<DecisionDiagram::Edge*>::iterator outEdgeIt = outedges.begin(); outEdgeIt != outedges.end(); outEdgeIt++){
+				children.push_back((*outEdgeIt)->getTo());
+			}
+		}
 
-	std::vector<DecisionDiagram::Node*> neighbors;
+		virtual DecisionDiagram::Node* leave(DecisionDiagram::Node* const& n, const std::vector<DecisionDiagram::Node*>& newSubroots){
+			// leafs can never be reduced (since they are already minimal)
+			if (n->isLeaf()) return n;
+
+			// redirect the edges to the reduced subgraphs (explicit snapshot since edges are redirected in the loop; the out-edges of n were not changed while its children were processed)
+			std::set<DecisionDiagram::Edge*> outedges = n->getOutEdges();
+			int i = 0;
+			for (std::set<DecisionDiagram::Edge*>::iterator outEdgeIt = outedges.begin(); outEdgeIt != outedges.end(); outEdgeIt++, i++){
+				// changed?
+				if (newSubroots[i] != (*outEdgeIt)->getTo()){
+					// redirect the inedge from n to newSubroot (the former to-node might become unreachable; such nodes are collected afterwards)
+					dd.addEdge(n, newSubroots[i], (*outEdgeIt)->getCondition());
+					dd.removeEdge(*outEdgeIt);
+				}
+			}
 
-	// remove all neighbor nodes
-	//	out-edges
-	for (std::set<DecisionDiagram::Edge*>::iterator it = outEdges.begin(); it != outEdges.end(); it++){
-		DecisionDiagram::Node* neighbor = (*it)->getTo();
-		// first remove the edge to the neighbor (to avoid infinite recursion)
-		dd.removeEdge(*it);
-		neighbors.push_back(neighbor);
-	}
-	//	in-edges
-	for (std::set<DecisionDiagram::Edge*>::iterator it = inEdges.begin(); it != inEdges.end(); it++){
-		DecisionDiagram::Node* neighbor = (*it)->getFrom();
-		// first remove the edge to the neighbor (to avoid infinite recursion)
-		dd.removeEdge(*it);
-		neighbors.push_back(neighbor);
-	}
+			// check if all out-edges of n lead to the same node
+			DecisionDiagram::EdgeList currentOutedges = n->getOutEdgeRange();
+			DecisionDiagram::Node* commonSubgraph = n;
+			for (DecisionDiagram::EdgeList::iterator outEdgeIt = currentOutedges.begin(); outEdgeIt != currentOutedges.end(); outEdgeIt++){
+				DecisionDiagram::Node* sn = (*outEdgeIt)->getTo();
+				if (outEdgeIt == currentOutedges.begin()){
+					commonSubgraph = sn;
+				}else if(*sn != *commonSubgraph){
+					// at least two different subgraphs were found: cannot reduce
+					return n;
+				}
+			}
+			// all classifications are equal: the node can be reduced
+			return commonSubgraph;
+		}
+	};
+
+	// copies subdiagrams bottom-up using hash-consing (see OpSimplify::share); each node is copied once, even if it is reachable on several paths
+	class Sharing : public DecisionDiagram::MemoizedTraversal<DecisionDiagram::Node*, DecisionDiagram::Node*>{
+	private:
+		DecisionDiagram& result;
+	public:
+		Sharing(DecisionDiagram& result_) : result(result_){
+		}
 
-	// now remove the neighbor connective components recursivly
-	for (std::vector<DecisionDiagram::Node*>::iterator it = neighbors.begin(); it != neighbors.end(); it++){
-		removeConnectiveComponent(dd, *it);
-	}
+		virtual void enter(DecisionDiagram::Node*& n, std::vector<DecisionDiagram::Node*>& children){
+			// the children are shared first
+			DecisionDiagram::EdgeList outedges = n->getOutEdgeRange();
+			for (DecisionDiagram::EdgeList::iterator outEdgeIt = outedges.begin(); outEdgeIt != outedges.end(); outEdgeIt++){
+				children.push_back((*outEdgeIt)->getTo());
+			}
+		}
 
-	// remove the node itself
-	try{
-		dd.removeNode(n);
-	}catch(DecisionDiagram::InvalidDecisionDiagram idd){
-		// can be thrown in case that a node is entered twice due to two nodes with a common ancestor or successor
-	}
+		virtual DecisionDiagram::Node* leave(DecisionDiagram::Node* const& n, const std::vector<DecisionDiagram::Node*>& childCopies){
+			DecisionDiagram::LeafNode* leaf = n->asLeaf();
+			if (leaf){
+				return result.addSharedLeafNode(leaf->getLabel(), leaf->getClassification());
+			}
+
+			std::vector<std::pair<DecisionDiagram::Condition, DecisionDiagram::Node*> > children;
+			bool commonChild = true;
+			DecisionDiagram::EdgeList outedges = n->getOutEdgeRange();
+			for (std::size_t i = 0; i < outedges.size(); i++){
+				children.push_back(std::pair<DecisionDiagram::Condition, DecisionDiagram::Node*>(outedges[i]->getCondition(), childCopies[i]));
+				if (childCopies[i] != childCopies[0]) commonChild = false;
+			}
+
+			// equivalent subdiagrams are represented by the same node now: if all branches lead to it, the condition is unnecessary
+			if (!children.empty() && commonChild){
+				return children.front().second;
+			}else{
+				return result.addSharedNode(n->getLabel(), children);
+			}
+		}
+	};
 }
 
 // reduces the subgraph with root "n" to a single leaf node if this is possible, i.e. if all branches lead to the same final classification
 // the return value will be a pointer to the new root node (a leaf node), or "n" itself if the subgraph could not be reduced
 DecisionDiagram::Node* OpSimplify::reduceSubgraph(DecisionDiagram& dd, DecisionDiagram::Node* n){
+	Reduction reduction(dd);
+	return reduction.run(n);
+}
 
-	// leafs can never be reduced (since they are already minimal)
-	if (dynamic_cast<DecisionDiagram::LeafNode*>(n)){
-		return n;
-	}else{
-		// reduce all subgraphs recursively
-		std::set<DecisionDiagram::Edge*> outedges = n->getOutEdges();
-		for (std::set<DecisionDiagram::Edge*>::iterator outEdgeIt = outedges.begin(); outEdgeIt != outedges.end(); outEdgeIt++){
-			DecisionDiagram::Node* newSubroot = reduceSubgraph(dd, (*outEdgeIt)->getTo());
-
-			// changed?
-			if (newSubroot != (*outEdgeIt)->getTo()){
-
-				// remember the former to-node of this edge
-				DecisionDiagram::Node* removeComponent = (*outEdgeIt)->getTo();
+// copies the subdiagram with root "n" bottom-up into "result", such that structurally equal subdiagrams are represented by the same (shared) node
+// the return value is the canonical copy of "n"
+DecisionDiagram::Node* OpSimplify::share(DecisionDiagram& result, DecisionDiagram::Node* n){
+	Sharing sharing(result);
+	return sharing.run(n);
+}
 
-				// redirect the inedge from n to newSubroot
-				dd.addEdge(n, newSubroot, (*outEdgeIt)->getCondition());
-				dd.removeEdge(*outEdgeIt);
+// applies two simplification strategies. First, unnecessary branches are removed (if all edges lead to the same node). Second, equivalent subdiagrams are fused.
+// the diagram is simplified in place
+void OpSimplify::simplify(DecisionDiagram& dd){
 
-				// if this edge was part of the last path from the root to this connective component (i.e. the edge's to-node is now unreachible), it can be removed
-				if (!dd.containsPath(dd.getRoot(), removeComponent)){
-					removeConnectiveComponent(dd, removeComponent);
-				}
-			}
-		}
+	if (dd.getRoot() == NULL) return;
 
-		// check if all out-edges of n lead to the same node
-		outedges = n->getOutEdges();
-		DecisionDiagram::Node* commonSubgraph;
-		for (std::set<DecisionDiagram::Edge*>::iterator outEdgeIt = outedges.begin(); outEdgeIt != outedges.end(); outEdgeIt++){
-			DecisionDiagram::Node* sn = (*outEdgeIt)->getTo();
-			if (outEdgeIt == outedges.begin()){
-				commonSubgraph = sn;
-			}else if(*sn != *commonSubgraph){
-				// at least two different subgraphs were found: cannot reduce
-				return n;
-			}
-		}
-		// all classifications are equal: the node can be reduced
-		return commonSubgraph;
+	// -------------------- strategy 1: remove unnecessary conditions  --------------------
+	// conditions are unnecessary if all branches lead to the same final classification
+	DecisionDiagram::Node* oldRoot = dd.getRoot();
+	DecisionDiagram::Node* newRoot = reduceSubgraph(dd, oldRoot);
+	if (newRoot != oldRoot){
+		dd.setRoot(newRoot);
 	}
-}
-
-// applies two simplification strategies. First, unnecessary branches are removed (if all edges lead to the same node). Second, equivalent subdiagrams are fused. Both strategies are
-// applied alternating as long as changes occur.
-DecisionDiagram OpSimplify::simplify(DecisionDiagram dd){
-
-	bool restart = true;
-	while (restart){
-		restart = false;
-
-		// -------------------- strategy 1: remove unnecessary conditions  --------------------
-		// conditions are unnecessary if all branches lead to the same final classification
-		DecisionDiagram::Node* oldRoot = dd.getRoot();
-		DecisionDiagram::Node* newRoot = reduceSubgraph(dd, oldRoot);
-		if (newRoot != oldRoot){
-			dd.setRoot(newRoot);
-			removeConnectiveComponent(dd, oldRoot);
-		}
+	// remove all parts of the diagram which became unreachable in a single mark-and-sweep pass
+	dd.collectUnreachable();
 
-		// -------------------- strategy 2: combine equivalent subdiagrams --------------------
-		std::set<DecisionDiagram::Node*> nodes = dd.getNodes();
-		// for each node of the diagram, check if there is another node that is equal to it
-		for (std::set<DecisionDiagram::Node*>::iterator it1 = nodes.begin(); it1 != nodes.end() && !restart; it1++){
-			for (std::set<DecisionDiagram::Node*>::iterator it2 = nodes.begin(); it2 != nodes.end() && !restart; it2++){
-
-				// iterators must point to different nodes that are semantically equivalent
-				if ((*it1) != (*it2) && (**it1) == (**it2)){
-					// replace one of the nodes (*it1) by the other one (*it2), that is, redirect all in-edges into *it2 to *it2
-					std::set<DecisionDiagram::Edge*> inedges = (*it1)->getInEdges();
-					for (std::set<DecisionDiagram::Edge*>::iterator inEdgeIt = inedges.begin(); inEdgeIt != inedges.end(); inEdgeIt++){
-						// remember the former to-node of this edge
-						DecisionDiagram::Node* removeComponent = (*inEdgeIt)->getTo();
-
-						// Redirect the edge
-						dd.addEdge((*inEdgeIt)->getFrom(), *it2, (*inEdgeIt)->getCondition());
-						dd.removeEdge(*inEdgeIt);
-
-						// if this was part of the last path from the root to this connective component (i.e. the edge's to-node is now unreachible), it can be removed
-						if (!dd.containsPath(dd.getRoot(), removeComponent)){
-							removeConnectiveComponent(dd, removeComponent);
-							// restart outer loops since essential graph structues have changed and the iterators are invalid now
-							restart = true;
-							break;
-						}
-					}
-				}
-			}
-		}
-	}
+	// -------------------- strategy 2: combine equivalent subdiagrams --------------------
+	// the reachable part of the diagram is rebuilt bottom-up using hash-consing, which fuses all equivalent subdiagrams in a single pass
+	// conditions which become unnecessary by fusing their branches are removed during the rebuild, thus strategy 1 need not be repeated
+	DecisionDiagram result;
+	result.setRoot(share(result, dd.getRoot()));
 
-	return dd;
+	// take over the rebuilt diagram without copying it
+	dd.moveFrom(result);
 }
 
 HexAnswer OpSimplify::apply(int arity, std::vector<HexAnswer*>& answers, OperatorArguments& parameters) throw (OperatorException){
+	SymbolTable::Scope symbols;
 
 	try{
 		// Check arity
@@ -182,7 +176,8 @@ HexAnswer OpSimplify::apply(int arity, std::vector<HexAnswer*>& answers, Operato
 		for (int answer = 0; answer < arity; answer++){
 			for (int answerset = 0; answerset < answers[answer]->size(); answerset++){
 				DecisionDiagram dd((*answers[answer])[answerset]);
-				output.push_back(simplify(dd).toAnswerSet());
+				simplify(dd);
+				output.push_back(dd.toAnswerSet());
 			}
 		}
 
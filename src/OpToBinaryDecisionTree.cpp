@@ -1,5 +1,6 @@
 #include <OpToBinaryDecisionTree.h>
 #include <DecisionDiagram.h>
+#include <SymbolTable.h>
 
 #include <sstream>
 #include <set>
@@ -29,67 +30,82 @@ std::set<std::string> OpToBinaryDecisionTree::getRecognizedParameters(){
 	return list;
 }
 
-void OpToBinaryDecisionTree::toBinary(DecisionDiagram& dd, DecisionDiagram::Node* root){
-
-	// Check arity of root node
-	if (root->getOutEdgesCount() > 2){
-		// greater than 2 --> needs to be transformed
-
-		bool firstOutEdge = true;
-		
-		// Create a new intermediate node (with a label similar to the original name)
-		DecisionDiagram::Node* intermediateNode = dd.addNode(dd.getUniqueLabel(root->getLabel()));
-
-		std::set<DecisionDiagram::Edge*> oedges = root->getOutEdges();
-		DecisionDiagram::Edge* selectedEdge = NULL;
-		for (std::set<DecisionDiagram::Edge*>::iterator it = oedges.begin(); it != oedges.end(); it++){
-			// Just take the first conditional edge as it is
-			// Note: In theory, the order in which the conditions are checked is irrelevant since the resulting diagrams are equivalent in any case.
-			//       However, it makes writing test cases much easier if the behaviour is deterministic. Therefore we look for the
-			//       lexically smallest condition and check it first.
-			if (dynamic_cast<DecisionDiagram::ElseEdge*>(*it) == NULL &&
-								(selectedEdge == NULL || (*it)->getCondition().toString().compare(selectedEdge->getCondition().toString()) < 0)){
-				selectedEdge = *it;
-			}
+namespace{
+	// converts the nodes top-down (pre-order); each node is transformed before its subtrees
+	class BinaryConversion : public DecisionDiagram::Traversal<DecisionDiagram::Node*, DecisionDiagram::Node*>{
+	private:
+		DecisionDiagram& dd;
+	public:
+		BinaryConversion(DecisionDiagram& dd_) : dd(dd_){
 		}
 
-		// unfold all child nodes
-		for (std::set<DecisionDiagram::Edge*>::iterator it = oedges.begin(); it != oedges.end(); it++){
-			if (*it == selectedEdge){
-				firstOutEdge = false;
-				// Convert the sub decision diagram into a binary one
-				toBinary(dd, (*it)->getTo());
+		virtual void enter(DecisionDiagram::Node*& root, std::vector<DecisionDiagram::Node*>& children){
+
+			// Check arity of root node
+			if (root->getOutEdgesCount() > 2){
+				// greater than 2 --> needs to be transformed
+
+				// Create a new intermediate node (with a label similar to the original name)
+				DecisionDiagram::Node* intermediateNode = dd.addFreshNode(root);
+
+				std::set<DecisionDiagram::Edge*> oedges = root->getOutEdges();
+				DecisionDiagram::Edge* selectedEdge = NULL;
+				for (std::set<DecisionDiagram::Edge*>::iterator it = oedges.begin(); it != oedges.end(); it++){
+					// Just take the first conditional edge as it is
+					// Note: In theory, the order in which the conditions are checked is irrelevant since the resulting diagrams are equivalent in any case.
+					//       However, it makes writing test cases much easier if the behaviour is deterministic. Therefore we look for the
+					//       lexically smallest condition and check it first.
+					if (!(*it)->isElse() &&
+										(selectedEdge == NULL || (*it)->getCondition().toString().compare(selectedEdge->getCondition().toString()) < 0)){
+						selectedEdge = *it;
+					}
+				}
+
+				// unfold all child nodes
+				for (std::set<DecisionDiagram::Edge*>::iterator it = oedges.begin(); it != oedges.end(); it++){
+					DecisionDiagram::Node *currentSubNode = (*it)->getTo();
+					if (*it != selectedEdge){
+						// All other edges are redirected such that the start at the intermediate node
+						dd.addEdge(intermediateNode, currentSubNode, (*it)->getCondition());
+
+						// Remove the original edge
+						dd.removeEdge(*it);
+					}
+
+					// Convert the sub decision diagram into a binary one
+					children.push_back(currentSubNode);
+				}
+
+				// Let the intermediate node be the root's else child
+				dd.addElseEdge(root, intermediateNode);
+			}else if(root->getOutEdgesCount() == 2){
+				// leave it as it is --> just transform the child nodes
+				std::set<DecisionDiagram::Edge*> oedges = root->getOutEdges();
+				for (std::set<DecisionDiagram::Edge*>::iterator it = oedges.begin(); it != oedges.end(); it++){
+					children.push_back((*it)->getTo());
+				}
 			}else{
-				// All other edges are redirected such that the start at the intermediate node
-				DecisionDiagram::Node *currentSubNode = (*it)->getTo();
-				dd.addEdge(intermediateNode, currentSubNode, (*it)->getCondition());
-
-				// Remove the original edge
-				dd.removeEdge(*it);
-
-				// Convert the sub decision diagram into a binary one
-				toBinary(dd, (*it)->getTo());
+				// either a leaf node --> leave it as it is
+				// or: an inner node with an illegal arity
+				if (!root->isLeaf()){
+					throw IOperator::OperatorException(std::string("Discovered an inner node with an illegal arity (must be >= 2): ") + root->getLabel());
+				}
 			}
 		}
 
-		// Let the intermediate node be the root's else child
-		DecisionDiagram::Edge *e = dd.addElseEdge(root, intermediateNode);
-	}else if(root->getOutEdgesCount() == 2){
-		// leave it as it is --> just transform the child nodes
-		std::set<DecisionDiagram::Edge*> oedges = root->getOutEdges();
-		for (std::set<DecisionDiagram::Edge*>::iterator it = oedges.begin(); it != oedges.end(); it++){
-			toBinary(dd, (*it)->getTo());
+		virtual DecisionDiagram::Node* leave(DecisionDiagram::Node* const& root, const std::vector<DecisionDiagram::Node*>& childResults){
+			return root;
 		}
-	}else{
-		// either a leaf node --> leave it as it is
-		// or: an inner node with an illegal arity
-		if (!dynamic_cast<DecisionDiagram::LeafNode*>(root)){
-			throw IOperator::OperatorException(std::string("Discovered an inner node with an illegal arity (must be >= 2): ") + root->getLabel());
-		}
-	}
+	};
+}
+
+void OpToBinaryDecisionTree::toBinary(DecisionDiagram& dd, DecisionDiagram::Node* root){
+	BinaryConversion conversion(dd);
+	conversion.run(root);
 }
 
 HexAnswer OpToBinaryDecisionTree::apply(int arity, std::vector<HexAnswer*>& answers, OperatorArguments& parameters) throw (OperatorException){
+	SymbolTable::Scope symbols;
 
 	try{
 		// Check arity
@@ -1,6 +1,9 @@
 #include <OpUnfold.h>
 #include <DecisionDiagram.h>
+#include <SymbolTable.h>
 
+#include <algorithm>
+#include <limits>
 #include <sstream>
 #include <set>
 
@@ -29,38 +32,52 @@ std::set<std::string> OpUnfold::getRecognizedParameters(){
 	return list;
 }
 
-DecisionDiagram OpUnfold::unfold(DecisionDiagram::Node* root, DecisionDiagram& ddin){
-
-	DecisionDiagram ddResult;
-	DecisionDiagram::Node* newRoot;
-	if (dynamic_cast<DecisionDiagram::LeafNode*>(root) != NULL){
-		// Just copy the leaf node and use it in a new decision diagram
-		newRoot = ddResult.addNode(root);
-		ddResult.setRoot(newRoot);
-	}else{
-		// Copy the current root node
-		newRoot = ddResult.addNode(root);
-		ddResult.setRoot(newRoot);
-
-		// Unfold all child decision diagrams
-		std::set<DecisionDiagram::Edge*> outEdges = root->getOutEdges();
-		for (std::set<DecisionDiagram::Edge*>::iterator childIt = outEdges.begin(); childIt != outEdges.end(); childIt++){
-			DecisionDiagram::Node *currentChild = (*childIt)->getTo();
-			DecisionDiagram unfoldedChild = unfold(currentChild, ddin);
-
-			// Avoid duplicate node names
-			unfoldedChild.useUniqueLabels(&ddResult);
-			DecisionDiagram::Node *childRoot = ddResult.addDecisionDiagram(&unfoldedChild);
-
-			// Connect the current root node with this child
-			ddResult.addEdge(newRoot, childRoot, (*childIt)->getCondition());
+namespace{
+	// copies each node once per path (post-order, such that the copies of the children are known when a node is copied)
+	class Unfolding : public DecisionDiagram::Traversal<DecisionDiagram::Node*, DecisionDiagram::Node*>{
+	private:
+		DecisionDiagram& ddResult;
+	public:
+		Unfolding(DecisionDiagram& ddResult_) : ddResult(ddResult_){
 		}
-	}
 
-	return ddResult;
+		virtual void enter(DecisionDiagram::Node*& n, std::vector<DecisionDiagram::Node*>& children){
+			DecisionDiagram::EdgeList outEdges = n->getOutEdgeRange();
+			for (DecisionDiagram::EdgeList::iterator childIt = outEdges.begin(); childIt != outEdges.end(); childIt++){
+				children.push_back((*childIt)->getTo());
+			}
+		}
+
+		virtual DecisionDiagram::Node* leave(DecisionDiagram::Node* const& n, const std::vector<DecisionDiagram::Node*>& childCopies){
+			DecisionDiagram::LeafNode* leaf = n->asLeaf();
+			if (leaf != NULL){
+				// Just copy the leaf node (duplicate node names are resolved when the result is written)
+				return ddResult.addFreshLeafNode(leaf);
+			}
+
+			// Copy the current node (duplicate node names are resolved when the result is written)
+			DecisionDiagram::Node* copy = ddResult.addFreshNode(n);
+
+			// Connect the copy with the copies of the child diagrams
+			DecisionDiagram::EdgeList outEdges = n->getOutEdgeRange();
+			for (std::size_t i = 0; i < outEdges.size(); i++){
+				ddResult.addEdge(copy, childCopies[i], outEdges[i]->getCondition());
+			}
+			return copy;
+		}
+	};
+}
+
+// copies the subdiagram with root "root" into ddResult, such that each node which is reachable on several paths is copied once per path
+// the return value is the copy of "root"; all nodes are directly added to ddResult, i.e. no intermediate diagrams are built
+DecisionDiagram::Node* OpUnfold::unfold(DecisionDiagram::Node* root, DecisionDiagram& ddResult){
+	Unfolding unfolding(ddResult);
+	return unfolding.run(root);
 }
 
 HexAnswer OpUnfold::apply(int arity, std::vector<HexAnswer*>& arguments, OperatorArguments& parameters) throw (OperatorException){
+	SymbolTable::Scope symbols;
+
 	try{
 		// Unfold all answer-sets
 		HexAnswer result;
@@ -82,8 +99,19 @@ HexAnswer OpUnfold::apply(int arity, std::vector<HexAnswer*>& arguments, Operato
 				throw DecisionDiagram::InvalidDecisionDiagram("Cycle detected: " + cyclestring.str());
 			}
 
-			// Unfold the decision diagram
-			dd = unfold(dd.getRoot(), dd);
+			// Unfold the decision diagram (and take over the result without copying it)
+			if (dd.getRoot() != NULL){
+				if (dd.isTree()){
+					// Trees are unfolded already; only the nodes which are not reachable from the root are dropped
+					dd.collectUnreachable();
+				}else{
+					// The size of the result is known in advance
+					DecisionDiagram unfolded;
+					unfolded.reserve(static_cast<std::size_t>(std::min(dd.getUnfoldedNodeCount(), (double)std::numeric_limits<int>::max())));
+					unfolded.setRoot(unfold(dd.getRoot(), unfolded));
+					dd.moveFrom(unfolded);
+				}
+			}
 			// The unfolded decision diagram does not need to be checked for cycles.
 			// Since unfolding is equivalence preserving, there can be no cycles if there were none in the input decision diagram.
 
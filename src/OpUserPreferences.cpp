@@ -1,11 +1,15 @@
 #include <OpUserPreferences.h>
 #include <DecisionDiagram.h>
+#include <SymbolTable.h>
+#include <DecisionDiagramBuilder.h>
 #include <StringHelper.h>
 
 #include <boost/algorithm/string.hpp>
 
+#include <map>
 #include <sstream>
 #include <set>
+#include <vector>
 #include <stdlib.h>
 
 using namespace dlvhex::dd::util;
@@ -98,6 +102,7 @@ OpUserPreferences::UserPreferences OpUserPreferences::getUserPreferences(Operato
 }
 
 HexAnswer OpUserPreferences::apply(int arity, std::vector<HexAnswer*>& arguments, OperatorArguments& parameters) throw (OperatorException){
+	SymbolTable::Scope symbols;
 
 	try{
 		// Check arity
@@ -125,35 +130,61 @@ HexAnswer OpUserPreferences::apply(int arity, std::vector<HexAnswer*>& arguments
 			throw IOperator::OperatorException("All input diagrams are expected to be trees.");
 		}
 
-		// Initialize the votings structure
-		std::set<DecisionDiagram::LeafNode*> leafs = output.getLeafNodes();
-		for (std::set<DecisionDiagram::LeafNode*>::iterator it = leafs.begin(); it != leafs.end(); it++){
-			Votes* votes = new Votes();
-			votes->v[(*it)->getClassification()] = 1;
-			(*it)->setData(votes);
-		}
-
-		// Insert all input decision diagrams
+		// Construct all other input diagrams (the classes of all diagrams must be known before the votings structure can be built)
+		std::vector<DecisionDiagram> inputs(arity - 1);
 		for (int answer = 1; answer < arity; answer++){
-			DecisionDiagram ddInput((*arguments[answer])[0]);
-			if (!ddInput.isTree()){
+			DecisionDiagramBuilder::build((*arguments[answer])[0], inputs[answer - 1]);
+			if (!inputs[answer - 1].isTree()){
 				throw IOperator::OperatorException("All input diagrams are expected to be trees.");
 			}
-			insert(ddInput, output);
+		}
+		// the classes mentioned in the preference rules are included as well, such that they can be looked up in the votings structure
+		std::set<std::string> classes;
+		collectClasses(output, classes);
+		for (std::vector<DecisionDiagram>::iterator it = inputs.begin(); it != inputs.end(); it++){
+			collectClasses(*it, classes);
+		}
+		for (UserPreferences::iterator upIt = userprefs.begin(); upIt != userprefs.end(); upIt++){
+			classes.insert((*upIt).getPreferredClass());
+			classes.insert((*upIt).getCmpClass());
+		}
+		VoteTable votes(classes);
+
+		// Initialize the votings structure (leafs with the same classification share their entry)
+		std::map<SymbolTable::Id, int*> initialVotes;
+		DecisionDiagram::LeafNodeRange leafs = output.getLeafNodeRange();
+		for (DecisionDiagram::LeafNodeRange::iterator it = leafs.begin(); it != leafs.end(); it++){
+			SymbolTable::Id c = (*it)->getClassificationSymbol();
+			if (initialVotes.find(c) == initialVotes.end()){
+				int* v = votes.newVotes();
+				v[votes.getClassId(c)] = 1;
+				initialVotes[c] = v;
+			}
+			votes.attach(*it, initialVotes[c]);
+		}
+		for (std::map<SymbolTable::Id, int*>::iterator it = initialVotes.begin(); it != initialVotes.end(); it++){
+			votes.release(it->second);
+		}
+
+		// Insert all input decision diagrams
+		for (std::vector<DecisionDiagram>::iterator it = inputs.begin(); it != inputs.end(); it++){
+			insert(*it, output, votes);
 		}
 
 
 		// Finally, for all remaining leaf nodes, take a classification according to the user preferences
-		std::set<DecisionDiagram::LeafNode*> outputLeafs = output.getLeafNodes();
-		for (std::set<DecisionDiagram::LeafNode*>::iterator leafIt = outputLeafs.begin(); leafIt != outputLeafs.end(); leafIt++){
-			Votes* v = dynamic_cast<Votes*>((*leafIt)->getData());
+		DecisionDiagram::LeafNodeRange outputLeafs = output.getLeafNodeRange();
+		for (DecisionDiagram::LeafNodeRange::iterator leafIt = outputLeafs.begin(); leafIt != outputLeafs.end(); leafIt++){
+			// the rules may vote for absent classes (with 0 votes), thus the votes are modified
+			int* v = votes.getMutableVotes(*leafIt);
 			int bestVotes = 0;
 			std::string bestVotedClass("unknown");
 
 			// go through all classes in this leaf node and take the highest voted class as the first guess
-			for (Votings::iterator vIt = v->v.begin(); vIt != v->v.end(); vIt++){
-				std::string cclass = (*vIt).first;
-				int cvotes = (*vIt).second;
+			for (VoteTable::ClassId c = 0; c < votes.getWidth(); c++){
+				if (v[c] == VoteTable::absent) continue;
+				const std::string& cclass = votes.getClassName(c);
+				int cvotes = v[c];
 				if (cvotes > bestVotes || cvotes == bestVotes && cclass.compare(bestVotedClass) < 0){
 					bestVotedClass = cclass;
 					bestVotes = cvotes;
@@ -162,21 +193,24 @@ HexAnswer OpUserPreferences::apply(int arity, std::vector<HexAnswer*>& arguments
 
 			// go through all preference rules
 			for (UserPreferences::iterator upIt = userprefs.begin(); upIt != userprefs.end(); upIt++){
+				VoteTable::ClassId pc = votes.getClassId((*upIt).getPreferredClass());
 				// check if this rule is applicable
 				if (	((*upIt).getCmpClass() == bestVotedClass) &&
-					(v->v.find((*upIt).getPreferredClass()) != v->v.end() && (*upIt).getMinDiff() == (-1) ||	// either the preferred class is containted in the leaf node and is preferred in any case
-					((v->v[(*upIt).getPreferredClass()] - bestVotes) >= (*upIt).getMinDiff()))){			// or it has at least "n" votes more than the cmp class
+					(v[pc] != VoteTable::absent && (*upIt).getMinDiff() == (-1) ||					// either the preferred class is containted in the leaf node and is preferred in any case
+					(((v[pc] == VoteTable::absent ? (v[pc] = 0) : v[pc]) - bestVotes) >= (*upIt).getMinDiff()))){	// or it has at least "n" votes more than the cmp class
 					// yes: this class is preferred
 					bestVotedClass = (*upIt).getPreferredClass();
-					bestVotes = v->v[bestVotedClass];
+					bestVotes = v[pc];
 				}
 			}
 
 			// Take the best voted classification as the final one
 			(*leafIt)->setClassification(bestVotedClass);
-			delete v;
 		}
 
+		// The result is a tree like the input diagrams: shared subdiagrams are copied once per path
+		unfoldShared(output, votes);
+
 		// Convert the final decision diagram into a hex answer
 		HexAnswer answer;
 		answer.push_back(output.toAnswerSet());
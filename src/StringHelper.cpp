@@ -101,15 +101,22 @@ int StringHelper::atoi(std::string str){
 }
 
 double StringHelper::atof(std::string str){
+	double v;
+	if (!tryAtof(str, v)) throw NotContainedException();
+	return v;
+}
+
+bool StringHelper::tryAtof(const std::string& str, double& value){
 	double v = ::atof(str.c_str());
 	if (v == 0.0){
 		// plausibility check: error or actually 0?
-		if (str.length() == 0) throw NotContainedException();
+		if (str.length() == 0) return false;
 		bool commaFound = true;
 		for (int i = 0; i < str.length(); i++){
-			if (commaFound && str[i] != '0' || !commaFound && str[i] != '0' && str[i] != '.') throw NotContainedException();
+			if (commaFound && str[i] != '0' || !commaFound && str[i] != '0' && str[i] != '.') return false;
 			if (str[i] == '.') commaFound = true;
 		}
 	}
-	return v;
+	value = v;
+	return true;
 }
@@ -0,0 +1,91 @@
+#include <SymbolTable.h>
+#include <StringHelper.h>
+
+#include <boost/functional/hash.hpp>
+
+using namespace dlvhex::dd::util;
+
+const SymbolTable::Id SymbolTable::empty;
+
+std::size_t SymbolTable::StringPtrHash::operator()(const std::string* s) const{
+	return boost::hash<std::string>()(*s);
+}
+
+bool SymbolTable::StringPtrEqual::operator()(const std::string* s1, const std::string* s2) const{
+	return *s1 == *s2;
+}
+
+SymbolTable::SymbolTable(){
+	// the empty string always has id 0
+	strings.push_back(std::string(""));
+	ids[&strings.back()] = empty;
+	numeric.push_back(false);
+	values.push_back(0.0);
+}
+
+SymbolTable& SymbolTable::instance(){
+	// constructed on first use (avoids problems with the initialization order of static objects)
+	static SymbolTable table;
+	return table;
+}
+
+SymbolTable::Id SymbolTable::intern(const std::string& str){
+	SymbolTable& table = instance();
+	boost::unordered_map<const std::string*, Id, StringPtrHash, StringPtrEqual>::iterator it = table.ids.find(&str);
+	if (it != table.ids.end()) return it->second;
+
+	// new symbol
+	Id id = table.strings.size();
+	table.strings.push_back(str);
+	table.ids[&table.strings.back()] = id;
+
+	// parse the string as number once
+	double value = 0.0;
+	table.numeric.push_back(StringHelper::tryAtof(str, value));
+	table.values.push_back(table.numeric.back() ? value : 0.0);
+	return id;
+}
+
+bool SymbolTable::find(const std::string& str, Id& id){
+	SymbolTable& table = instance();
+	boost::unordered_map<const std::string*, Id, StringPtrHash, StringPtrEqual>::iterator it = table.ids.find(&str);
+	if (it == table.ids.end()) return false;
+	id = it->second;
+	return true;
+}
+
+const std::string& SymbolTable::lookup(Id id){
+	return instance().strings[id];
+}
+
+bool SymbolTable::isNumeric(Id id){
+	return instance().numeric[id];
+}
+
+double SymbolTable::getNumericValue(Id id){
+	return instance().values[id];
+}
+
+std::size_t SymbolTable::size(){
+	return instance().strings.size();
+}
+
+void SymbolTable::release(std::size_t mark){
+	SymbolTable& table = instance();
+	if (mark < 1) mark = 1;		// keep the empty string
+
+	// symbols are released in reverse order of interning, such that the remaining ids stay dense
+	while (table.strings.size() > mark){
+		table.ids.erase(&table.strings.back());
+		table.strings.pop_back();
+		table.numeric.pop_back();
+		table.values.pop_back();
+	}
+}
+
+SymbolTable::Scope::Scope() : mark(SymbolTable::size()){
+}
+
+SymbolTable::Scope::~Scope(){
+	SymbolTable::release(mark);
+}
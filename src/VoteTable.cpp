@@ -0,0 +1,99 @@
+#include <VoteTable.h>
+
+#include <algorithm>
+
+using namespace dlvhex::dd::util;
+
+const int VoteTable::absent = -1;
+
+VoteTable::VoteTable(const std::set<std::string>& classNames) : arena((classNames.size() + 1) * sizeof(int)){
+	// std::set is ordered lexically, thus the class ids are as well
+	for (std::set<std::string>::const_iterator it = classNames.begin(); it != classNames.end(); it++){
+		SymbolTable::Id c = SymbolTable::intern(*it);
+		classIds[c] = classes.size();
+		classes.push_back(c);
+	}
+}
+
+VoteTable::~VoteTable(){
+	// the vectors do not need to be destructed
+	arena.releaseAll();
+}
+
+int& VoteTable::refCount(const int* v){
+	// the reference counter is stored in front of the counters
+	return const_cast<int*>(v)[-1];
+}
+
+int VoteTable::getWidth() const{
+	return classes.size();
+}
+
+VoteTable::ClassId VoteTable::getClassId(const std::string& className) const{
+	return getClassId(SymbolTable::intern(className));
+}
+
+VoteTable::ClassId VoteTable::getClassId(SymbolTable::Id className) const{
+	boost::unordered_map<SymbolTable::Id, ClassId>::const_iterator it = classIds.find(className);
+	return it == classIds.end() ? -1 : it->second;
+}
+
+const std::string& VoteTable::getClassName(VoteTable::ClassId c) const{
+	return SymbolTable::lookup(classes[c]);
+}
+
+int* VoteTable::newVotes(){
+	int* v = static_cast<int*>(arena.allocate()) + 1;
+	refCount(v) = 1;
+	std::fill(v, v + classes.size(), absent);
+	return v;
+}
+
+int* VoteTable::copyVotes(const int* v){
+	int* copy = static_cast<int*>(arena.allocate()) + 1;
+	refCount(copy) = 1;
+	std::copy(v, v + classes.size(), copy);
+	return copy;
+}
+
+void VoteTable::release(const int* v){
+	if (--refCount(v) == 0) arena.deallocate(const_cast<int*>(v) - 1);
+}
+
+const int* VoteTable::getVotes(const DecisionDiagram::LeafNode* leaf) const{
+	boost::unordered_map<const DecisionDiagram::LeafNode*, int*>::const_iterator it = votes.find(leaf);
+	return it == votes.end() ? NULL : it->second;
+}
+
+int* VoteTable::getMutableVotes(const DecisionDiagram::LeafNode* leaf){
+	boost::unordered_map<const DecisionDiagram::LeafNode*, int*>::iterator it = votes.find(leaf);
+	if (it == votes.end()) return NULL;
+
+	// copy on write
+	if (refCount(it->second) > 1){
+		int* copy = copyVotes(it->second);
+		release(it->second);
+		it->second = copy;
+	}
+	return it->second;
+}
+
+void VoteTable::attach(const DecisionDiagram::LeafNode* leaf, int* v){
+	refCount(v)++;
+	int*& entry = votes[leaf];
+	if (entry != NULL) release(entry);
+	entry = v;
+}
+
+void VoteTable::share(const DecisionDiagram::LeafNode* leaf, const DecisionDiagram::LeafNode* original){
+	boost::unordered_map<const DecisionDiagram::LeafNode*, int*>::iterator it = votes.find(original);
+	if (it != votes.end()) attach(leaf, it->second);
+}
+
+void VoteTable::detach(const DecisionDiagram::LeafNode* leaf){
+	boost::unordered_map<const DecisionDiagram::LeafNode*, int*>::iterator it = votes.find(leaf);
+	if (it != votes.end()){
+		release(it->second);
+		votes.erase(it);
+	}
+}